@@ -171,6 +171,10 @@ def create_args_parser():
                       help='compile as much as possible, ignore compilation failures')
     parser.add_argument('--no-docstrings', dest='no_docstrings', action='store_true', default=None,
                       help='strip docstrings')
+    parser.add_argument('--pxd-cache', dest='pxd_cache', metavar='DIR', default=None,
+                      help='cache the parsed .pxd files in DIR and reuse them in later runs')
+    parser.add_argument('--timing-report', dest='timing_report', metavar='FILE', default=None,
+                      help='write the time and peak memory growth of each compiler phase for each module to FILE as JSON')
     parser.add_argument('sources', nargs='*')
     return parser
 
@@ -202,6 +206,10 @@ def parse_args(args):
     if options.language_level:
         assert options.language_level in (2, 3, '3str')
         options.options['language_level'] = options.language_level
+    if options.pxd_cache:
+        options.options['pxd_cache'] = options.pxd_cache
+    if options.timing_report:
+        options.options['timing_report'] = os.path.abspath(options.timing_report)
 
     if options.lenient:
         # increase Python compatibility by ignoring compile time errors
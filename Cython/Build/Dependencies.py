@@ -3,8 +3,10 @@ from __future__ import absolute_import, print_function
 import cython
 from .. import __version__
 
+import binascii
 import collections
 import contextlib
+import errno
 import hashlib
 import os
 import shutil
@@ -881,81 +883,15 @@ def create_extension_list(patterns, exclude=None, ctx=None, aliases=None, quiet=
     return module_list, module_metadata
 
 
-# This is the user-exposed entry point.
-def cythonize(module_list, exclude=None, nthreads=0, aliases=None, quiet=False, force=False, language=None,
-              exclude_failures=False, show_all_warnings=False, **options):
+def create_cythonize_jobs(module_list, exclude=None, aliases=None, quiet=False, force=False,
+                          language=None, exclude_failures=False, show_all_warnings=False,
+                          **options):
     """
-    Compile a set of source modules into C/C++ files and return a list of distutils
-    Extension objects for them.
-
-    :param module_list: As module list, pass either a glob pattern, a list of glob
-                        patterns or a list of Extension objects.  The latter
-                        allows you to configure the extensions separately
-                        through the normal distutils options.
-                        You can also pass Extension objects that have
-                        glob patterns as their sources. Then, cythonize
-                        will resolve the pattern and create a
-                        copy of the Extension for every matching file.
-
-    :param exclude: When passing glob patterns as ``module_list``, you can exclude certain
-                    module names explicitly by passing them into the ``exclude`` option.
-
-    :param nthreads: The number of concurrent builds for parallel compilation
-                     (requires the ``multiprocessing`` module).
-
-    :param aliases: If you want to use compiler directives like ``# distutils: ...`` but
-                    can only know at compile time (when running the ``setup.py``) which values
-                    to use, you can use aliases and pass a dictionary mapping those aliases
-                    to Python strings when calling :func:`cythonize`. As an example, say you
-                    want to use the compiler
-                    directive ``# distutils: include_dirs = ../static_libs/include/``
-                    but this path isn't always fixed and you want to find it when running
-                    the ``setup.py``. You can then do ``# distutils: include_dirs = MY_HEADERS``,
-                    find the value of ``MY_HEADERS`` in the ``setup.py``, put it in a python
-                    variable called ``foo`` as a string, and then call
-                    ``cythonize(..., aliases={'MY_HEADERS': foo})``.
-
-    :param quiet: If True, Cython won't print error, warning, or status messages during the
-                  compilation.
-
-    :param force: Forces the recompilation of the Cython modules, even if the timestamps
-                  don't indicate that a recompilation is necessary.
-
-    :param language: To globally enable C++ mode, you can pass ``language='c++'``. Otherwise, this
-                     will be determined at a per-file level based on compiler directives.  This
-                     affects only modules found based on file names.  Extension instances passed
-                     into :func:`cythonize` will not be changed. It is recommended to rather
-                     use the compiler directive ``# distutils: language = c++`` than this option.
-
-    :param exclude_failures: For a broad 'try to compile' mode that ignores compilation
-                             failures and simply excludes the failed extensions,
-                             pass ``exclude_failures=True``. Note that this only
-                             really makes sense for compiling ``.py`` files which can also
-                             be used without compilation.
-
-    :param show_all_warnings: By default, not all Cython warnings are printed.
-                              Set to true to show all warnings.
-
-    :param annotate: If ``True``, will produce a HTML file for each of the ``.pyx`` or ``.py``
-                     files compiled. The HTML file gives an indication
-                     of how much Python interaction there is in
-                     each of the source code lines, compared to plain C code.
-                     It also allows you to see the C/C++ code
-                     generated for each line of Cython code. This report is invaluable when
-                     optimizing a function for speed,
-                     and for determining when to :ref:`release the GIL <nogil>`:
-                     in general, a ``nogil`` block may contain only "white" code.
-                     See examples in :ref:`determining_where_to_add_types` or
-                     :ref:`primes`.
-
-
-    :param annotate-fullc: If ``True`` will produce a colorized HTML version of
-                           the source which includes entire generated C/C++-code.
-
-
-    :param compiler_directives: Allow to set compiler directives in the ``setup.py`` like this:
-                                ``compiler_directives={'embedsignature': True}``.
-                                See :ref:`compiler-directives`.
+    Prepare the compilation of a set of source modules like cythonize() but
+    do not run it.  Return the list of Extension objects, the argument tuples
+    for cythonize_one() of the modules that need to be compiled, a mapping
+    from each C file to the Extension objects that use it, and the cache
+    directory.
     """
     if exclude is None:
         exclude = []
@@ -1088,6 +1024,106 @@ def cythonize(module_list, exclude=None, nthreads=0, aliases=None, quiet=False,
         progress = progress_fmt.format(i+1, N)
         to_compile[i] = to_compile[i][1:] + (progress,)
 
+    return module_list, to_compile, modules_by_cfile, options.cache
+
+
+# This is the user-exposed entry point.
+def cythonize(module_list, exclude=None, nthreads=0, aliases=None, quiet=False, force=False, language=None,
+              exclude_failures=False, show_all_warnings=False, **options):
+    """
+    Compile a set of source modules into C/C++ files and return a list of distutils
+    Extension objects for them.
+
+    :param module_list: As module list, pass either a glob pattern, a list of glob
+                        patterns or a list of Extension objects.  The latter
+                        allows you to configure the extensions separately
+                        through the normal distutils options.
+                        You can also pass Extension objects that have
+                        glob patterns as their sources. Then, cythonize
+                        will resolve the pattern and create a
+                        copy of the Extension for every matching file.
+
+    :param exclude: When passing glob patterns as ``module_list``, you can exclude certain
+                    module names explicitly by passing them into the ``exclude`` option.
+
+    :param nthreads: The number of concurrent builds for parallel compilation
+                     (requires the ``multiprocessing`` module).
+
+    :param aliases: If you want to use compiler directives like ``# distutils: ...`` but
+                    can only know at compile time (when running the ``setup.py``) which values
+                    to use, you can use aliases and pass a dictionary mapping those aliases
+                    to Python strings when calling :func:`cythonize`. As an example, say you
+                    want to use the compiler
+                    directive ``# distutils: include_dirs = ../static_libs/include/``
+                    but this path isn't always fixed and you want to find it when running
+                    the ``setup.py``. You can then do ``# distutils: include_dirs = MY_HEADERS``,
+                    find the value of ``MY_HEADERS`` in the ``setup.py``, put it in a python
+                    variable called ``foo`` as a string, and then call
+                    ``cythonize(..., aliases={'MY_HEADERS': foo})``.
+
+    :param quiet: If True, Cython won't print error, warning, or status messages during the
+                  compilation.
+
+    :param force: Forces the recompilation of the Cython modules, even if the timestamps
+                  don't indicate that a recompilation is necessary.
+
+    :param language: To globally enable C++ mode, you can pass ``language='c++'``. Otherwise, this
+                     will be determined at a per-file level based on compiler directives.  This
+                     affects only modules found based on file names.  Extension instances passed
+                     into :func:`cythonize` will not be changed. It is recommended to rather
+                     use the compiler directive ``# distutils: language = c++`` than this option.
+
+    :param exclude_failures: For a broad 'try to compile' mode that ignores compilation
+                             failures and simply excludes the failed extensions,
+                             pass ``exclude_failures=True``. Note that this only
+                             really makes sense for compiling ``.py`` files which can also
+                             be used without compilation.
+
+    :param show_all_warnings: By default, not all Cython warnings are printed.
+                              Set to true to show all warnings.
+
+    :param annotate: If ``True``, will produce a HTML file for each of the ``.pyx`` or ``.py``
+                     files compiled. The HTML file gives an indication
+                     of how much Python interaction there is in
+                     each of the source code lines, compared to plain C code.
+                     It also allows you to see the C/C++ code
+                     generated for each line of Cython code. This report is invaluable when
+                     optimizing a function for speed,
+                     and for determining when to :ref:`release the GIL <nogil>`:
+                     in general, a ``nogil`` block may contain only "white" code.
+                     See examples in :ref:`determining_where_to_add_types` or
+                     :ref:`primes`.
+
+
+    :param annotate-fullc: If ``True`` will produce a colorized HTML version of
+                           the source which includes entire generated C/C++-code.
+
+
+    :param compiler_directives: Allow to set compiler directives in the ``setup.py`` like this:
+                                ``compiler_directives={'embedsignature': True}``.
+                                See :ref:`compiler-directives`.
+
+    :param cache: A directory in which the generated files are cached by the content of the
+                  sources, their dependencies and the compilation options, or ``True`` for
+                  a default directory.  The cache can be shared by concurrent builds, also
+                  over a network file system.  Its size is limited to 100 MB.
+
+    :param timing_report: A file name to which the wall time of each compiler phase and how
+                          much it raised the peak memory of the process are written as JSON,
+                          for each module and ``.pxd`` file, summed over the worker processes.
+
+    :param pxd_cache: A directory in which the parse trees of cimported ``.pxd`` files are
+                      cached, or ``True`` for a default directory.  All worker processes
+                      and later builds reuse them instead of parsing the ``.pxd`` files again.
+                      The entries are pickles, so the directory must not be writable by
+                      other users; the cache is not used otherwise.
+    """
+    module_list, to_compile, modules_by_cfile, cache = create_cythonize_jobs(
+        module_list, exclude=exclude, aliases=aliases, quiet=quiet, force=force,
+        language=language, exclude_failures=exclude_failures,
+        show_all_warnings=show_all_warnings, **options)
+
+    N = len(to_compile)
     if N <= 1:
         nthreads = 0
     if nthreads:
@@ -1133,8 +1169,11 @@ def cythonize(module_list, exclude=None, nthreads=0, aliases=None, quiet=False,
             print(u"Failed compilations: %s" % ', '.join(sorted([
                 module.name for module in failed_modules])))
 
-    if options.cache:
-        cleanup_cache(options.cache, getattr(options, 'cache_size', 1024 * 1024 * 100))
+    if cache:
+        cleanup_cache(cache, 1024 * 1024 * 100)
+    if options.get('timing_report'):
+        from ..Compiler import TimingReport
+        TimingReport.merge_report_file(options['timing_report'])
     # cythonize() is often followed by the (non-Python-buffered)
     # compiler output, flush now to avoid interleaving output.
     sys.stdout.flush()
@@ -1218,19 +1257,16 @@ def cythonize_one(pyx_file, c_file, fingerprint, quiet, options=None,
                   raise_on_failure=True, embedded_metadata=None,
                   full_module_name=None, show_all_warnings=False,
                   progress=""):
-    from ..Compiler.Main import compile_single, default_options
-    from ..Compiler.Errors import CompileError, PyrexError
-
+    cache_lock = None
     if fingerprint:
-        if not os.path.exists(options.cache):
-            safe_makedirs(options.cache)
         # Cython-generated c files are highly compressible.
         # (E.g. a compression ratio of about 10 for Sage).
-        fingerprint_file_base = join_path(
-            options.cache, "%s-%s" % (os.path.basename(c_file), fingerprint))
+        fingerprint_file_base = cache_entry_path(
+            options.cache, os.path.basename(c_file), fingerprint)
         gz_fingerprint_file = fingerprint_file_base + gzip_ext
         zip_fingerprint_file = fingerprint_file_base + '.zip'
-        if os.path.exists(gz_fingerprint_file) or os.path.exists(zip_fingerprint_file):
+        cache_lock = CacheEntryLock(fingerprint_file_base)
+        if not cache_lock.acquire([gz_fingerprint_file, zip_fingerprint_file]):
             if not quiet:
                 print(u"%sFound compiled %s in cache" % (progress, pyx_file))
             if os.path.exists(gz_fingerprint_file):
@@ -1245,6 +1281,21 @@ def cythonize_one(pyx_file, c_file, fingerprint, quiet, options=None,
                     for artifact in z.namelist():
                         z.extract(artifact, os.path.join(dirname, artifact))
             return
+    try:
+        _cythonize_one(pyx_file, c_file, fingerprint, quiet, options,
+                       raise_on_failure, embedded_metadata, full_module_name,
+                       show_all_warnings, progress)
+    finally:
+        if cache_lock is not None:
+            cache_lock.release()
+
+
+def _cythonize_one(pyx_file, c_file, fingerprint, quiet, options,
+                   raise_on_failure, embedded_metadata, full_module_name,
+                   show_all_warnings, progress):
+    from ..Compiler.Main import compile_single, default_options
+    from ..Compiler.Errors import CompileError, PyrexError
+
     if not quiet:
         print(u"%sCythonizing %s" % (progress, Utils.decode_filename(pyx_file)))
     if options is None:
@@ -1286,18 +1337,21 @@ def cythonize_one(pyx_file, c_file, fingerprint, quiet, options=None,
         artifacts = list(filter(None, [
             getattr(result, attr, None)
             for attr in ('c_file', 'h_file', 'api_file', 'i_file')]))
+        fingerprint_file_base = cache_entry_path(
+            options.cache, os.path.basename(c_file), fingerprint)
         if len(artifacts) == 1:
-            fingerprint_file = gz_fingerprint_file
-            with contextlib.closing(open(c_file, 'rb')) as f:
-                with contextlib.closing(gzip_open(fingerprint_file + '.tmp', 'wb')) as g:
-                    shutil.copyfileobj(f, g)
+            def write_cache_entry(path):
+                with contextlib.closing(open(c_file, 'rb')) as f:
+                    with contextlib.closing(gzip_open(path, 'wb')) as g:
+                        shutil.copyfileobj(f, g)
+            publish_cache_entry(options.cache, fingerprint_file_base + gzip_ext, write_cache_entry)
         else:
-            fingerprint_file = zip_fingerprint_file
-            with contextlib.closing(zipfile.ZipFile(
-                    fingerprint_file + '.tmp', 'w', zipfile_compression_mode)) as zip:
-                for artifact in artifacts:
-                    zip.write(artifact, os.path.basename(artifact))
-        os.rename(fingerprint_file + '.tmp', fingerprint_file)
+            def write_cache_entry(path):
+                with contextlib.closing(zipfile.ZipFile(
+                        path, 'w', zipfile_compression_mode)) as zip:
+                    for artifact in artifacts:
+                        zip.write(artifact, os.path.basename(artifact))
+            publish_cache_entry(options.cache, fingerprint_file_base + '.zip', write_cache_entry)
 
 
 def cythonize_one_helper(m):
@@ -1315,27 +1369,252 @@ def _init_multiprocessing_helper():
     signal.signal(signal.SIGINT, signal.SIG_IGN)
 
 
-def cleanup_cache(cache, target_size, ratio=.85):
+# The cache is content addressed: entries are named after the fingerprint of
+# everything that went into them and are never modified once published.
+# They are sharded into subdirectories by the first characters of the
+# fingerprint to keep the directories small, and the sizes of new entries
+# are appended to an index file so that checking the size of the cache does
+# not need to stat() every entry.  Appends can get lost or garbled on network
+# file systems, so the index is rebuilt from a scan of the cache at least once
+# every CACHE_INDEX_MAX_AGE seconds.
+
+CACHE_INDEX_FILE = 'index'
+CACHE_INDEX_MAX_AGE = 3600  # seconds
+CACHE_LOCK_TIMEOUT = 600  # seconds
+
+
+def cache_entry_path(cache, name, fingerprint):
+    return join_path(join_path(cache, fingerprint[:2]), "%s-%s" % (name, fingerprint))
+
+
+if hasattr(os, 'replace'):
+    _replace_file = os.replace
+else:
+    def _replace_file(src, dst):
+        try:
+            os.rename(src, dst)
+        except OSError:
+            # Windows does not replace existing files in Py2, but all
+            # entries with the same name have the same content.
+            if not os.path.exists(dst):
+                raise
+            os.remove(src)
+
+
+def _unique_tmp_path(path):
+    # Unlike tempfile.mkstemp(), this leaves the permissions to the umask so
+    # that the entries can be shared between users.
+    return '%s.%s.tmp' % (path, binascii.hexlify(os.urandom(8)).decode('ascii'))
+
+
+def publish_cache_entry(cache, path, write):
+    """
+    Atomically add a file to the cache.  'write' is called with the path of a
+    unique temporary file in the same directory, which is then renamed to
+    'path', so that readers never see partial entries.
+    """
+    safe_makedirs(os.path.dirname(path))
+    tmp_path = _unique_tmp_path(path)
     try:
-        p = subprocess.Popen(['du', '-s', '-k', os.path.abspath(cache)], stdout=subprocess.PIPE)
-        stdout, _ = p.communicate()
-        res = p.wait()
-        if res == 0:
-            total_size = 1024 * int(stdout.strip().split()[0])
-            if total_size < target_size:
-                return
-    except (OSError, ValueError):
+        write(tmp_path)
+        size = os.path.getsize(tmp_path)
+        _replace_file(tmp_path, path)
+    except:
+        if os.path.exists(tmp_path):
+            os.remove(tmp_path)
+        raise
+    try:
+        # Lines shorter than PIPE_BUF are written atomically in append mode on
+        # local file systems, so concurrent builds do not garble the index.
+        with open(join_path(cache, CACHE_INDEX_FILE), 'a') as index:
+            index.write("%d %s\n" % (size, os.path.relpath(path, cache)))
+    except (IOError, OSError):
         pass
+
+
+class CacheEntryLock(object):
+    """
+    Lock against building the same cache entry concurrently, also between
+    machines that share the cache over a network file system.  The lock is a
+    file next to the entry that is created as a hard link, which is atomic
+    also over NFS, unlike O_EXCL.  It holds a random token of its owner, so
+    that a process whose lock was broken as stale does not remove the lock
+    of another process.  While the lock is held, a thread touches it
+    regularly so that builds that take longer than the timeout keep it.
+    """
+    poll_interval = 0.1
+
+    def __init__(self, path, timeout=CACHE_LOCK_TIMEOUT):
+        self.path = path + '.lock'
+        self.timeout = timeout
+        self.locked = False
+        self.token = binascii.hexlify(os.urandom(16))
+        self._stop_heartbeat = None
+
+    def _read_token(self, path):
+        try:
+            with open(path, 'rb') as f:
+                return f.read()
+        except (IOError, OSError):
+            return None
+
+    def _create_lock_file(self):
+        if not hasattr(os, 'link'):
+            fd = os.open(self.path, os.O_CREAT | os.O_EXCL | os.O_WRONLY)
+            try:
+                os.write(fd, self.token)
+            finally:
+                os.close(fd)
+            return
+        tmp_path = _unique_tmp_path(self.path)
+        with open(tmp_path, 'wb') as f:
+            f.write(self.token)
+        try:
+            os.link(tmp_path, self.path)
+        except OSError:
+            # NFS can report an error for a link that it created, e.g. when
+            # the reply to a retransmitted request got lost.
+            if os.stat(tmp_path).st_nlink != 2:
+                raise
+        finally:
+            os.remove(tmp_path)
+
+    def _heartbeat(self, stop):
+        while not stop.wait(self.timeout / 4.0):
+            try:
+                os.utime(self.path, None)
+            except OSError:
+                pass
+
+    def _break_stale_lock(self):
+        """
+        Remove the lock file if its owner did not touch it within the timeout.
+        It is renamed away first, so that only one waiting process breaks it,
+        and put back if a new owner took the lock in the meantime.
+        """
+        token = self._read_token(self.path)
+        if time.time() - os.path.getmtime(self.path) <= self.timeout:
+            return
+        stale_path = _unique_tmp_path(self.path)
+        os.rename(self.path, stale_path)
+        if self._read_token(stale_path) != token:
+            try:
+                os.link(stale_path, self.path)
+            except (OSError, AttributeError):
+                pass  # there is a new lock already, or no way to restore it
+        os.remove(stale_path)
+
+    def acquire(self, entries):
+        """
+        Return False if one of the given entries exists or was published by
+        the holder of the lock while waiting for it, otherwise take the lock
+        and return True.  Locks of builds that crashed or were killed time
+        out after a while.
+        """
+        while True:
+            if any(os.path.exists(entry) for entry in entries):
+                return False
+            try:
+                safe_makedirs(os.path.dirname(self.path))
+                self._create_lock_file()
+            except (IOError, OSError) as e:
+                if e.errno != errno.EEXIST:
+                    # Read-only cache or similar, just build without lock.
+                    return True
+            else:
+                self.locked = True
+                if any(os.path.exists(entry) for entry in entries):
+                    self.release()
+                    return False
+                import threading
+                self._stop_heartbeat = threading.Event()
+                heartbeat = threading.Thread(target=self._heartbeat, args=(self._stop_heartbeat,))
+                heartbeat.daemon = True
+                heartbeat.start()
+                return True
+            try:
+                self._break_stale_lock()
+            except OSError:
+                continue  # released or broken by another process
+            time.sleep(self.poll_interval)
+
+    def release(self):
+        if self._stop_heartbeat is not None:
+            self._stop_heartbeat.set()
+            self._stop_heartbeat = None
+        if self.locked:
+            self.locked = False
+            if self._read_token(self.path) != self.token:
+                return  # broken as stale, and maybe taken by another process
+            try:
+                os.remove(self.path)
+            except OSError:
+                pass
+
+
+def _read_cache_index(cache):
+    """
+    Return the total size of the entries in the index, or None if the index
+    needs to be rebuilt.
+    """
+    total_size = 0
+    scan_time = None
+    try:
+        with open(join_path(cache, CACHE_INDEX_FILE)) as index:
+            for line in index:
+                if line.startswith('#'):
+                    scan_time = float(line[1:])
+                else:
+                    total_size += int(line.split(None, 1)[0])
+    except (IOError, OSError, ValueError, IndexError):
+        return None
+    if scan_time is None or not 0 <= time.time() - scan_time < CACHE_INDEX_MAX_AGE:
+        return None
+    return total_size
+
+
+def cleanup_cache(cache, target_size, ratio=.85):
+    total_size = _read_cache_index(cache)
+    if total_size is not None and total_size < target_size:
+        return
+    # Unless appends to the index got lost, it can only overestimate the size
+    # as long as nothing but this function removes entries, so scan the cache
+    # and rebuild it.
+    now = time.time()
     total_size = 0
     all = []
-    for file in os.listdir(cache):
-        path = join_path(cache, file)
-        s = os.stat(path)
-        total_size += s.st_size
-        all.append((s.st_atime, s.st_size, path))
+    for dirpath, dirnames, filenames in os.walk(cache):
+        for file in filenames:
+            path = os.path.join(dirpath, file)
+            try:
+                s = os.stat(path)
+            except OSError:
+                continue  # removed concurrently
+            if dirpath == cache and file == CACHE_INDEX_FILE:
+                continue
+            elif file.endswith('.tmp') or file.endswith('.lock'):
+                # leftovers of interrupted builds
+                if now - s.st_mtime > 2 * CACHE_LOCK_TIMEOUT:
+                    os.remove(path)
+                continue
+            total_size += s.st_size
+            all.append((s.st_atime, s.st_size, path))
+    # least recently used entries first
+    all.sort()
     if total_size > target_size:
-        for time, size, file in reversed(sorted(all)):
-            os.unlink(file)
+        while all and total_size >= target_size * ratio:
+            atime, size, file = all.pop(0)
+            try:
+                os.unlink(file)
+            except OSError:
+                pass
             total_size -= size
-            if total_size < target_size * ratio:
-                break
+
+    def write_index(path):
+        with open(path, 'w') as index:
+            index.write("#%f\n" % now)
+            for atime, size, file in all:
+                index.write("%d %s\n" % (size, os.path.relpath(file, cache)))
+    tmp_path = _unique_tmp_path(join_path(cache, CACHE_INDEX_FILE))
+    write_index(tmp_path)
+    _replace_file(tmp_path, join_path(cache, CACHE_INDEX_FILE))
@@ -3,6 +3,8 @@ import glob
 import gzip
 import os
 import tempfile
+import threading
+import time
 
 import Cython.Build.Dependencies
 import Cython.Utils
@@ -20,7 +22,7 @@ class TestCyCache(CythonTest):
         self.cache_dir = tempfile.mkdtemp(prefix='cache', dir=self.temp_dir)
 
     def cache_files(self, file_glob):
-        return glob.glob(os.path.join(self.cache_dir, file_glob))
+        return glob.glob(os.path.join(self.cache_dir, '*', file_glob))
 
     def fresh_cythonize(self, *args, **kwargs):
         Cython.Utils.clear_function_caches()
@@ -69,7 +71,7 @@ class TestCyCache(CythonTest):
         with open(a_pyx, 'w') as f:
             f.write('pass')
         self.fresh_cythonize(a_pyx, cache=self.cache_dir)
-        a_cache = os.path.join(self.cache_dir, os.listdir(self.cache_dir)[0])
+        a_cache = self.cache_files('a.c*')[0]
         gzip.GzipFile(a_cache, 'wb').write('fake stuff'.encode('ascii'))
         os.unlink(a_c)
         self.fresh_cythonize(a_pyx, cache=self.cache_dir)
@@ -114,3 +116,116 @@ class TestCyCache(CythonTest):
         os.unlink(hash_c)
         self.fresh_cythonize(hash_pyx, cache=self.cache_dir, cplus=False, show_version=True)
         self.assertEqual(2, len(self.cache_files('options.c*')))
+
+    def test_sharding_and_index(self):
+        a_pyx = os.path.join(self.src_dir, 'a.pyx')
+        with open(a_pyx, 'w') as f:
+            f.write('pass')
+        self.fresh_cythonize(a_pyx, cache=self.cache_dir)
+        a_cache, = self.cache_files('a.c*')
+        shard = os.path.basename(os.path.dirname(a_cache))
+        self.assertTrue(os.path.basename(a_cache).startswith('a.c-' + shard), a_cache)
+        with open(os.path.join(self.cache_dir, 'index')) as f:
+            # rebuilt by the first cleanup
+            self.assertTrue(f.readline().startswith('#'))
+            self.assertEqual(
+                f.read(), '%d %s\n' % (os.path.getsize(a_cache), os.path.relpath(a_cache, self.cache_dir)))
+        self.assertEqual([], glob.glob(os.path.join(self.cache_dir, '*', '*.tmp')))
+        self.assertEqual([], glob.glob(os.path.join(self.cache_dir, '*', '*.lock')))
+
+    def make_entries(self, *sizes):
+        paths = []
+        for i, size in enumerate(sizes):
+            fingerprint = '%02x%s' % (i, 'f' * 38)
+            path = Cython.Build.Dependencies.cache_entry_path(self.cache_dir, 'm%d.c' % i, fingerprint)
+            Cython.Build.Dependencies.publish_cache_entry(
+                self.cache_dir, path, lambda tmp: open(tmp, 'wb').write(b'x' * size))
+            os.utime(path, (1000 + i, 1000 + i))
+            paths.append(path)
+        return paths
+
+    def test_cleanup_cache(self):
+        cleanup_cache = Cython.Build.Dependencies.cleanup_cache
+        paths = self.make_entries(100, 100, 100, 100)
+        cleanup_cache(self.cache_dir, 500)
+        self.assertTrue(all(os.path.exists(path) for path in paths))
+
+        os.utime(paths[0], None)  # recently used
+        cleanup_cache(self.cache_dir, 350, ratio=.6)
+        self.assertEqual([True, False, False, True], [os.path.exists(path) for path in paths])
+        with open(os.path.join(self.cache_dir, 'index')) as f:
+            scan_time, entries = f.readline(), f.read()
+        self.assertTrue(scan_time.startswith('#'), scan_time)
+        self.assertEqual(sorted(entries.splitlines()), sorted(
+            '100 %s' % os.path.relpath(path, self.cache_dir) for path in (paths[0], paths[3])))
+
+    def test_cleanup_cache_uses_index(self):
+        paths = self.make_entries(100, 100)
+        with open(os.path.join(self.cache_dir, 'index'), 'w') as f:
+            f.write('#%f\n10 %s\n' % (time.time(), os.path.relpath(paths[0], self.cache_dir)))
+        Cython.Build.Dependencies.cleanup_cache(self.cache_dir, 100)
+        self.assertTrue(all(os.path.exists(path) for path in paths))
+
+    def test_cleanup_cache_rescans_old_index(self):
+        paths = self.make_entries(100, 100)
+        with open(os.path.join(self.cache_dir, 'index'), 'w') as f:
+            f.write('#%f\n10 %s\n' % (
+                time.time() - Cython.Build.Dependencies.CACHE_INDEX_MAX_AGE - 1,
+                os.path.relpath(paths[0], self.cache_dir)))
+        Cython.Build.Dependencies.cleanup_cache(self.cache_dir, 150)
+        self.assertEqual([False, True], [os.path.exists(path) for path in paths])
+
+    def test_lock_waits_for_entry(self):
+        entry = os.path.join(self.cache_dir, 'entry')
+        lock = Cython.Build.Dependencies.CacheEntryLock(entry)
+        self.assertTrue(lock.acquire([entry]))
+
+        def publish():
+            time.sleep(0.3)
+            Cython.Build.Dependencies.publish_cache_entry(
+                self.cache_dir, entry, lambda tmp: open(tmp, 'w').close())
+            lock.release()
+        thread = threading.Thread(target=publish)
+        thread.start()
+        try:
+            self.assertFalse(Cython.Build.Dependencies.CacheEntryLock(entry).acquire([entry]))
+        finally:
+            thread.join()
+        self.assertFalse(os.path.exists(lock.path))
+
+    def test_stale_lock(self):
+        entry = os.path.join(self.cache_dir, 'entry')
+        lock = Cython.Build.Dependencies.CacheEntryLock(entry)
+        self.assertTrue(lock.acquire([entry]))
+        os.utime(lock.path, (1000, 1000))
+        other = Cython.Build.Dependencies.CacheEntryLock(entry)
+        self.assertTrue(other.acquire([entry]))
+        other.release()
+        self.assertFalse(os.path.exists(other.path))
+
+    def test_lock_heartbeat(self):
+        entry = os.path.join(self.cache_dir, 'entry')
+        lock = Cython.Build.Dependencies.CacheEntryLock(entry, timeout=0.2)
+        self.assertTrue(lock.acquire([entry]))
+        try:
+            self.assertEqual(1, os.stat(lock.path).st_nlink)
+            os.utime(lock.path, (1000, 1000))
+            time.sleep(0.3)
+            # still owned although the build took longer than the timeout
+            self.assertGreater(os.path.getmtime(lock.path), 1000)
+        finally:
+            lock.release()
+        self.assertEqual([], os.listdir(self.cache_dir))
+
+    def test_broken_lock_is_not_released(self):
+        entry = os.path.join(self.cache_dir, 'entry')
+        lock = Cython.Build.Dependencies.CacheEntryLock(entry)
+        self.assertTrue(lock.acquire([entry]))
+        os.utime(lock.path, (1000, 1000))
+        other = Cython.Build.Dependencies.CacheEntryLock(entry)
+        self.assertTrue(other.acquire([entry]))
+        # the first owner must not remove the lock that replaced its own
+        lock.release()
+        self.assertTrue(os.path.exists(other.path))
+        other.release()
+        self.assertFalse(os.path.exists(other.path))
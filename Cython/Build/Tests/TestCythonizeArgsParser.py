@@ -25,7 +25,7 @@ class TestCythonizeArgsParser(TestCase):
     def are_default(self, options, skip):
         # empty containers
         empty_containers = ['directives', 'compile_time_env', 'options', 'excludes']
-        are_none = ['language_level', 'annotate', 'build', 'build_inplace', 'force', 'quiet', 'lenient', 'keep_going', 'no_docstrings']
+        are_none = ['language_level', 'annotate', 'build', 'build_inplace', 'force', 'quiet', 'lenient', 'keep_going', 'no_docstrings', 'pxd_cache', 'timing_report']
         for opt_name in empty_containers:
             if len(getattr(options, opt_name))!=0 and (opt_name not in skip):
                 self.assertEqual(opt_name,"", msg="For option "+opt_name)
@@ -375,6 +375,18 @@ class TestCythonizeArgsParser(TestCase):
         self.assertTrue(self.are_default(options, ['no_docstrings']))
         self.assertEqual(options.no_docstrings, True)
 
+    def test_pxd_cache(self):
+        options, args =  self.parse_args(['--pxd-cache', 'my_cache_dir'])
+        self.assertFalse(args)
+        self.assertTrue(self.are_default(options, ['pxd_cache']))
+        self.assertEqual(options.pxd_cache, 'my_cache_dir')
+
+    def test_timing_report(self):
+        options, args =  self.parse_args(['--timing-report', 'report.json'])
+        self.assertFalse(args)
+        self.assertTrue(self.are_default(options, ['timing_report']))
+        self.assertEqual(options.timing_report, 'report.json')
+
     def test_file_name(self):
         options, args =  self.parse_args(['file1.pyx', 'file2.pyx'])
         self.assertEqual(len(args), 2)
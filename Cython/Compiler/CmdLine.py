@@ -98,6 +98,12 @@ def create_cython_argparser():
                            'Level indicates aggressiveness, default 0 releases nothing.')
     parser.add_argument("-w", "--working", dest='working_path', action='store', type=str,
                       help='Sets the working directory for Cython (the directory modules are searched from)')
+    parser.add_argument("--pxd-cache", dest='pxd_cache', metavar='DIR', action='store', type=str,
+                      help='Cache the parsed .pxd files in DIR and reuse them in later compiler runs. '
+                           'DIR must not be writable by other users.')
+    parser.add_argument("--timing-report", dest='timing_report', metavar='FILE', action='store', type=str,
+                      help='Write the wall time and the peak memory growth of each compiler phase for each module '
+                           'to FILE as JSON.')
     parser.add_argument("--gdb", action=SetGDBDebugAction, nargs=0,
                       help='Output debug information for cygdb')
     parser.add_argument("--gdb-outdir", action=SetGDBDebugOutputAction, type=str,
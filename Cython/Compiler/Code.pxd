@@ -53,6 +53,8 @@ cdef class FunctionState:
     cdef public object closure_temps
     cdef public bint should_declare_error_indicator
     cdef public bint uses_error_indicator
+    cdef public object py_string_region
+    cdef public object parallel_thread_id
 
     @cython.locals(n=size_t)
     cpdef new_label(self, name=*)
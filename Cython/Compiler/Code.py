@@ -696,6 +696,9 @@ class FunctionState(object):
     # exc_vars         (string * 3)    exception variables for reraise, or None
     # can_trace        boolean         line tracing is supported in the current context
     # scope            Scope           the scope object of the current function
+    # py_string_region (StringIOTree, StringIOTree) or None
+    #                                  outer buffer and the code region of a function with lazily created strings
+    # parallel_thread_id string or None the thread id inside an outlined prange body (backend='threads')
 
     # Not used for now, perhaps later
     def __init__(self, owner, names_taken=set(), scope=None):
@@ -717,6 +720,8 @@ class FunctionState(object):
         self.current_except = None
         self.can_trace = False
         self.gil_owned = True
+        self.py_string_region = None
+        self.parallel_thread_id = None
 
         self.temps_allocated = []  # of (name, type, manage_ref, static)
         self.temps_free = {}  # (type, manage_ref) -> list of free vars with same type/managed status
@@ -942,6 +947,22 @@ class FunctionState(object):
     def stop_collecting_temps(self):
         return self.collect_temps_stack.pop()
 
+    def forget_temps(self, count):
+        """
+        Drop the temps that were allocated after the first 'count' ones, when
+        the code that used them was moved into a separate C function.  They
+        must have been released and will not be reused.
+        """
+        for name, type, manage_ref, static in self.temps_allocated[count:]:
+            freelist = self.temps_free[(type, manage_ref)]
+            if name in self.zombie_temps:
+                self.zombie_temps.remove(name)
+            else:
+                freelist[0].remove(name)
+            freelist[1].remove(name)
+            del self.temps_used_type[name]
+        del self.temps_allocated[count:]
+
     def init_closure_temps(self, scope):
         self.closure_temps = ClosureTempAllocator(scope)
 
@@ -978,6 +999,7 @@ cython.declare(possible_unicode_identifier=object, possible_bytes_identifier=obj
 possible_unicode_identifier = re.compile(br"(?![0-9])\w+$".decode('ascii'), re.U).match
 possible_bytes_identifier = re.compile(r"(?![0-9])\w+$".encode('ASCII')).match
 replace_identifier = re.compile(r'[^a-zA-Z0-9_]+').sub
+find_py_string_cnames = re.compile(r'\b(?:%s|%s)\w+' % (Naming.interned_prefixes['str'], Naming.py_const_prefix)).findall
 find_alphanums = re.compile('([a-zA-Z0-9]+)').findall
 
 class StringConst(object):
@@ -1174,7 +1196,11 @@ class GlobalState(object):
         self.num_const_index = {}
         self.py_constants = []
         self.cached_cmethods = {}
+        self.frozen_globals = []  # names of the module globals that are read through frozen values
         self.initialised_constants = set()
+        self.error_sites = 0  # number of __PYX_ERR() positions, sizes the traceback code object cache
+        self.py_string_groups = []  # per-function sets of Python string cnames (directive 'lazy_strings')
+        self.py_string_regions = set()  # the function code regions that initialise their strings themselves
 
         writer.set_global_state(self)
         self.rootwriter = writer
@@ -1368,6 +1394,16 @@ class GlobalState(object):
     def get_interned_identifier(self, text):
         return self.get_py_string_const(text, identifier=True)
 
+    def get_frozen_global_cname(self, name):
+        # The slot holds the value of the module global after module init (directive 'optimize.freeze_globals').
+        try:
+            index = self.frozen_globals.index(name)
+        except ValueError:
+            index = len(self.frozen_globals)
+            self.frozen_globals.append(name)
+            self.get_interned_identifier(name)
+        return "%s[%d]" % (Naming.frozen_globals_cname, index)
+
     def new_string_const(self, text, byte_string):
         cname = self.new_string_const_cname(byte_string)
         c = StringConst(cname, text, byte_string)
@@ -1467,10 +1503,16 @@ class GlobalState(object):
 
     def generate_const_declarations(self):
         self.generate_cached_methods_decls()
+        self.generate_frozen_globals_decl()
         self.generate_string_constants()
         self.generate_num_constants()
         self.generate_object_constant_decls()
 
+    def generate_frozen_globals_decl(self):
+        if self.frozen_globals:
+            self.parts['decls'].putln("static PyObject *%s[%d];" % (
+                Naming.frozen_globals_cname, len(self.frozen_globals)))
+
     def generate_object_constant_decls(self):
         consts = [(len(c.cname), c.cname, c)
                   for c in self.py_constants]
@@ -1548,6 +1590,7 @@ class GlobalState(object):
         if py_strings:
             self.use_utility_code(UtilityCode.load_cached("InitStrings", "StringTools.c"))
             py_strings.sort()
+            lazy_strings = self.find_lazy_py_strings()
             w = self.parts['pystring_table']
             w.putln("")
             w.putln("static __Pyx_StringTabEntry %s[] = {" % Naming.stringtab_cname)
@@ -1558,7 +1601,15 @@ class GlobalState(object):
             w.putln("#endif")
             decls_writer.putln("#if !CYTHON_COMPILING_IN_LIMITED_API")
             not_limited_api_decls_writer = decls_writer.insertion_point()
+            if self.py_string_groups:
+                # lazily created strings are only used by functions, so their table can come first
+                decls_writer.putln("static __Pyx_StringTabEntry %s[] = {" % Naming.stringtab_lazy_cname)
+                w_lazy_writer = decls_writer.insertion_point()
+                decls_writer.putln("{0, 0, 0, 0, 0, 0, 0}")
+                decls_writer.putln("};")
+                lazy_groups_writer = decls_writer.insertion_point()
             decls_writer.putln("#endif")
+            lazy_index = {}
             init_globals.putln("#if CYTHON_COMPILING_IN_LIMITED_API")
             init_globals_limited_api = init_globals.insertion_point()
             init_globals.putln("#endif")
@@ -1582,17 +1633,22 @@ class GlobalState(object):
                     py_string.cname)
                 not_limited_api_decls_writer.putln(
                     "static PyObject *%s;" % py_string.cname)
+                if py_string.cname in lazy_strings:
+                    lazy_index[py_string.cname] = len(lazy_index)
+                    table_writer = w_lazy_writer
+                else:
+                    table_writer = w_not_limited_writer
                 if py_string.py3str_cstring:
-                    w_not_limited_writer.putln("#if PY_MAJOR_VERSION >= 3")
-                    w_not_limited_writer.putln("{&%s, %s, sizeof(%s), %s, %d, %d, %d}," % (
+                    table_writer.putln("#if PY_MAJOR_VERSION >= 3")
+                    table_writer.putln("{&%s, %s, sizeof(%s), %s, %d, %d, %d}," % (
                         py_string.cname,
                         py_string.py3str_cstring.cname,
                         py_string.py3str_cstring.cname,
                         '0', 1, 0,
                         py_string.intern
                         ))
-                    w_not_limited_writer.putln("#else")
-                w_not_limited_writer.putln("{&%s, %s, sizeof(%s), %s, %d, %d, %d}," % (
+                    table_writer.putln("#else")
+                table_writer.putln("{&%s, %s, sizeof(%s), %s, %d, %d, %d}," % (
                     py_string.cname,
                     c_cname,
                     c_cname,
@@ -1602,7 +1658,7 @@ class GlobalState(object):
                     py_string.intern
                     ))
                 if py_string.py3str_cstring:
-                    w_not_limited_writer.putln("#endif")
+                    table_writer.putln("#endif")
                 w_limited_writer.putln("{0, %s, sizeof(%s), %s, %d, %d, %d}," % (
                     c_cname if not py_string.py3str_cstring else py_string.py3str_cstring.cname,
                     c_cname if not py_string.py3str_cstring else py_string.py3str_cstring.cname,
@@ -1626,6 +1682,38 @@ class GlobalState(object):
                     init_globals.error_goto(self.module_pos)))
             init_globals.putln("#endif")
 
+            if self.py_string_groups:
+                for i, group in enumerate(self.py_string_groups):
+                    indices = sorted(lazy_index[cname] for cname in group if cname in lazy_index)
+                    lazy_groups_writer.putln("static const int %s%d[] = {%s};" % (
+                        Naming.string_group_prefix, i, ', '.join(map(str, indices + [-1]))))
+                lazy_groups_writer.putln("static char %s[%d];" % (
+                    Naming.string_groups_done_cname, len(self.py_string_groups)))
+
+    def find_lazy_py_strings(self):
+        """
+        Python strings that appear only in the code regions of functions
+        that initialise their strings on entry can be created lazily.
+        Anything else (module init code, constants, other functions) may
+        use a string before any of these functions was called.
+        """
+        if not self.py_string_groups:
+            return set()
+        lazy_strings = set()
+        for group in self.py_string_groups:
+            lazy_strings.update(group)
+
+        def collect_code(tree, code_parts):
+            if tree in self.py_string_regions:
+                return
+            for child in tree.prepended_children:
+                collect_code(child, code_parts)
+            code_parts.append(tree.stream.getvalue())
+        code_parts = []
+        collect_code(self.rootwriter.buffer, code_parts)
+        lazy_strings.difference_update(find_py_string_cnames(''.join(code_parts)))
+        return lazy_strings
+
     def generate_num_constants(self):
         consts = [(c.py_type, c.value[0] == '-', len(c.value), c.value, c.value_code, c)
                   for c in self.num_const_index.values()]
@@ -1931,6 +2019,50 @@ class CCodeWriter(object):
     def intern_identifier(self, text):
         return self.get_py_string_const(text, identifier=True)
 
+    def start_py_string_group(self):
+        """
+        With the 'lazy_strings' directive, the Python string constants that
+        the current function uses from here on get created on its first call
+        instead of at module import time.  The function code is written into
+        a separate region to find them later.  Returns the insertion point
+        for the initialisation code, or None.
+        """
+        if not self.globalstate.directives['lazy_strings'] or not self.funcstate.gil_owned:
+            return None
+        init_code = self.insertion_point()
+        region = StringIOTree()
+        self.buffer.insert(region)
+        self.funcstate.py_string_region = (self.buffer, region)
+        self.buffer = region
+        return init_code
+
+    def finish_py_string_group(self, init_code, error_code):
+        """
+        'error_code' may be a callable, so that the error label is only
+        marked as used if the function needs to initialise any strings.
+        """
+        if init_code is None:
+            return
+        self.buffer, region = self.funcstate.py_string_region
+        self.funcstate.py_string_region = None
+        group = set(find_py_string_cnames(region.getvalue()))
+        if not group:
+            return
+        if callable(error_code):
+            error_code = error_code()
+        self.globalstate.use_utility_code(UtilityCode.load_cached("InitStringGroup", "StringTools.c"))
+        index = len(self.globalstate.py_string_groups)
+        self.globalstate.py_string_groups.append(group)
+        self.globalstate.py_string_regions.add(region)
+        init_code.putln("#if !CYTHON_COMPILING_IN_LIMITED_API")
+        init_code.putln("if (unlikely(!%s[%d]) && unlikely(__Pyx_InitStringGroup(%s, %s%d, &%s[%d]) < 0)) %s" % (
+            Naming.string_groups_done_cname, index,
+            Naming.stringtab_lazy_cname,
+            Naming.string_group_prefix, index,
+            Naming.string_groups_done_cname, index,
+            error_code))
+        init_code.putln("#endif")
+
     def get_cached_constants_writer(self, target=None):
         return self.globalstate.get_cached_constants_writer(target)
 
@@ -1965,10 +2097,14 @@ class CCodeWriter(object):
         if self.code_config.emit_code_comments:
             self.indent()
             self.write("/* %s */\n" % self._build_marker(pos))
-        if trace and self.funcstate and self.funcstate.can_trace and self.globalstate.directives['linetrace']:
-            self.indent()
-            self.write('__Pyx_TraceLine(%d,%d,%s)\n' % (
-                pos[1], not self.funcstate.gil_owned, self.error_goto(pos)))
+        if trace and self.funcstate and self.funcstate.can_trace:
+            if self.globalstate.directives['profile'] == 'sampling':
+                self.indent()
+                self.write('__Pyx_SampleLine(%d)\n' % pos[1])
+            elif self.globalstate.directives['linetrace']:
+                self.indent()
+                self.write('__Pyx_TraceLine(%d,%d,%s)\n' % (
+                    pos[1], not self.funcstate.gil_owned, self.error_goto(pos)))
 
     def _build_marker(self, pos):
         source_desc, line, col = pos
@@ -2400,6 +2536,7 @@ class CCodeWriter(object):
         self.funcstate.should_declare_error_indicator = True
         if used:
             self.funcstate.uses_error_indicator = True
+        self.globalstate.error_sites += 1
         return "__PYX_ERR(%s, %s, %s)" % (
             self.lookup_filename(pos[0]),
             pos[1],
@@ -2470,22 +2607,45 @@ class CCodeWriter(object):
         self.globalstate.use_utility_code(
             UtilityCode.load_cached("WriteUnraisableException", "Exceptions.c"))
 
+    def is_sampling_profile(self):
+        return self.globalstate.directives['profile'] == 'sampling'
+
+    def use_profile_utility_code(self):
+        if self.is_sampling_profile():
+            self.globalstate.use_utility_code(UtilityCode.load_cached("SampleProfile", "Profile.c"))
+            return
+        if self.globalstate.directives['linetrace']:
+            self.use_fast_gil_utility_code()
+        self.globalstate.use_utility_code(UtilityCode.load_cached("Profile", "Profile.c"))
+
     def put_trace_declarations(self):
-        self.putln('__Pyx_TraceDeclarations')
+        if self.is_sampling_profile():
+            self.putln('__Pyx_SampleDeclarations')
+        else:
+            self.putln('__Pyx_TraceDeclarations')
 
     def put_trace_frame_init(self, codeobj=None):
-        if codeobj:
+        if codeobj and not self.is_sampling_profile():
             self.putln('__Pyx_TraceFrameInit(%s)' % codeobj)
 
     def put_trace_call(self, name, pos, nogil=False):
-        self.putln('__Pyx_TraceCall("%s", %s[%s], %s, %d, %s);' % (
-            name, Naming.filetable_cname, self.lookup_filename(pos[0]), pos[1], nogil, self.error_goto(pos)))
+        if self.is_sampling_profile():
+            # the shadow stack does not need the GIL and cannot fail
+            self.putln('__Pyx_SampleCall("%s", %s[%s], %s);' % (
+                name, Naming.filetable_cname, self.lookup_filename(pos[0]), pos[1]))
+        else:
+            self.putln('__Pyx_TraceCall("%s", %s[%s], %s, %d, %s);' % (
+                name, Naming.filetable_cname, self.lookup_filename(pos[0]), pos[1], nogil, self.error_goto(pos)))
 
     def put_trace_exception(self):
-        self.putln("__Pyx_TraceException();")
+        if not self.is_sampling_profile():
+            self.putln("__Pyx_TraceException();")
 
     def put_trace_return(self, retvalue_cname, nogil=False):
-        self.putln("__Pyx_TraceReturn(%s, %d);" % (retvalue_cname, nogil))
+        if self.is_sampling_profile():
+            self.putln("__Pyx_SampleReturn();")
+        else:
+            self.putln("__Pyx_TraceReturn(%s, %d);" % (retvalue_cname, nogil))
 
     def putln_openmp(self, string):
         self.putln("#ifdef _OPENMP")
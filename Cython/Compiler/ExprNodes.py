@@ -1891,6 +1891,7 @@ class NameNode(AtomicExprNode):
     #  cf_maybe_null   boolean   Maybe uninitialized before this node
     #  allow_null      boolean   Don't raise UnboundLocalError
     #  nogil           boolean   Whether it is used in a nogil context
+    #  use_frozen_global boolean Read a module global from its value after module init
 
     is_name = True
     is_cython_module = False
@@ -1903,6 +1904,7 @@ class NameNode(AtomicExprNode):
     cf_is_null = False
     allow_null = False
     nogil = False
+    use_frozen_global = False
     inferred_type = None
 
     def as_cython_attribute(self):
@@ -2321,11 +2323,18 @@ class NameNode(AtomicExprNode):
             if entry.scope.is_module_scope:
                 code.globalstate.use_utility_code(
                     UtilityCode.load_cached("GetModuleGlobalName", "ObjectHandling.c"))
+                if self.use_frozen_global:
+                    frozen_cname = code.globalstate.get_frozen_global_cname(entry.name)
+                    code.putln('if (likely(%s)) {' % frozen_cname)
+                    code.putln('%s = __Pyx_NewRef(%s);' % (self.result(), frozen_cname))
+                    code.putln('} else {')
                 code.putln(
                     '__Pyx_GetModuleGlobalName(%s, %s); %s' % (
                         self.result(),
                         interned_cname,
                         code.error_goto_if_null(self.result(), self.pos)))
+                if self.use_frozen_global:
+                    code.putln('}')
             else:
                 # FIXME: is_pyglobal is also used for class namespace
                 code.globalstate.use_utility_code(
@@ -3244,13 +3253,20 @@ class JoinedStrNode(ExprNode):
     #
     # values   [UnicodeNode|FormattedValueNode]   Substrings of the f-string
     #
+    # can_suspend  boolean   contains a 'yield' or 'await'
+    #
     type = unicode_type
     is_temp = True
     gil_message = "String concatenation"
+    can_suspend = False
 
     subexprs = ['values']
 
     def analyse_types(self, env):
+        from .ParseTreeTransforms import YieldNodeCollector
+        collector = YieldNodeCollector()
+        collector.visitchildren(self)
+        self.can_suspend = bool(collector.yields)
         self.values = [v.analyse_types(env).coerce_to_pyobject(env) for v in self.values]
         return self
 
@@ -3259,23 +3275,56 @@ class JoinedStrNode(ExprNode):
         return False
 
     def generate_evaluation_code(self, code):
+        # The substrings are collected in a C array instead of a tuple.  C numbers are
+        # formatted into a character buffer on the stack instead of Unicode strings.
+        # Arrays cannot be saved across a 'yield' in the generator closure, so if the
+        # f-string can suspend, the substrings are kept in temps and only copied into
+        # the array before the join, and C numbers are formatted as Unicode strings.
         code.mark_pos(self.pos)
         num_items = len(self.values)
-        list_var = code.funcstate.allocate_temp(py_object_type, manage_ref=True)
+        parts_type = PyrexTypes.CArrayType(PyrexTypes.c_pyx_unicode_part_type, num_items)
         ulength_var = code.funcstate.allocate_temp(PyrexTypes.c_py_ssize_t_type, manage_ref=False)
         max_char_var = code.funcstate.allocate_temp(PyrexTypes.c_py_ucs4_type, manage_ref=False)
 
-        code.putln('%s = PyTuple_New(%s); %s' % (
-            list_var,
-            num_items,
-            code.error_goto_if_null(list_var, self.pos)))
-        code.put_gotref(list_var, py_object_type)
         code.putln("%s = 0;" % ulength_var)
         code.putln("%s = 127;" % max_char_var)  # at least ASCII character range
 
+        if self.can_suspend:
+            parts_var = None
+            buffer_sizes = []
+            object_parts = []  # (index, node, temp holding an owned reference or None)
+            old_error_label = None
+        else:
+            # The array owns references to the Python substrings until the join.
+            code.globalstate.use_utility_code(UtilityCode.load_cached("IncludeStringH", "StringTools.c"))
+            parts_var = code.funcstate.allocate_temp(parts_type, manage_ref=False)
+            code.putln("memset(%s, 0, sizeof(%s));" % (parts_var, parts_var))
+            buffer_sizes = [
+                node.value.type.ascii_buffer_size(node.c_format_spec) for node in self.values
+                if isinstance(node, FormattedValueNode) and node.is_c_number_part()]
+            old_error_label = code.new_error_label()
+        if buffer_sizes:
+            # one buffer for all C numbers
+            buffer_var = code.funcstate.allocate_temp(
+                PyrexTypes.CArrayType(PyrexTypes.c_char_type, ' + '.join(buffer_sizes)), manage_ref=False)
+            buffer_end = buffer_var
+
         for i, node in enumerate(self.values):
+            if parts_var and isinstance(node, FormattedValueNode) and node.is_c_number_part():
+                # written right-aligned into the next section of the buffer
+                part = "%s[%d]" % (parts_var, i)
+                value = node.value
+                value.generate_evaluation_code(code)
+                buffer_end = "%s + (%s)" % (buffer_end, value.type.ascii_buffer_size(node.c_format_spec))
+                code.putln("%s.length = %s;" % (
+                    part, value.type.convert_to_ascii(value.result(), buffer_end, code, node.c_format_spec)))
+                code.putln("%s.chars = %s - %s.length;" % (part, buffer_end, part))
+                code.putln("%s += %s.length;" % (ulength_var, part))
+                value.generate_disposal_code(code)
+                value.free_temps(code)
+                continue
+
             node.generate_evaluation_code(code)
-            node.make_owned_reference(code)
 
             ulength = "__Pyx_PyUnicode_GET_LENGTH(%s)" % node.py_result()
             max_char_value = "__Pyx_PyUnicode_MAX_CHAR_VALUE(%s)" % node.py_result()
@@ -3312,26 +3361,60 @@ class JoinedStrNode(ExprNode):
                 code.putln("%s = (%s > %s) ? %s : %s;" % (
                     max_char_var, max_char_value, max_char_var, max_char_value, max_char_var))
             code.putln("%s += %s;" % (ulength_var, ulength))
+            if parts_var:
+                node.make_owned_reference(code)
+                node.generate_giveref(code)
+                code.putln("%s[%d].uval = %s;" % (parts_var, i, node.py_result()))
+                node.generate_post_assignment_code(code)
+                node.free_temps(code)
+            elif not node.is_temp and not node.is_string_literal:
+                # e.g. a variable, which must not lose its value while suspended
+                owned_var = code.funcstate.allocate_temp(py_object_type, manage_ref=True)
+                code.putln("%s = %s;" % (owned_var, node.py_result()))
+                code.put_incref(owned_var, py_object_type)
+                object_parts.append((i, node, owned_var))
+            else:
+                object_parts.append((i, node, None))
 
-            node.generate_giveref(code)
-            code.putln('PyTuple_SET_ITEM(%s, %s, %s);' % (list_var, i, node.py_result()))
-            node.generate_post_assignment_code(code)
-            node.free_temps(code)
+        if parts_var is None:
+            parts_var = code.funcstate.allocate_temp(parts_type, manage_ref=False)
+            for i, node, owned_var in object_parts:
+                code.putln("%s[%d].uval = %s;" % (parts_var, i, owned_var or node.py_result()))
 
         code.mark_pos(self.pos)
         self.allocate_temp_result(code)
         code.globalstate.use_utility_code(UtilityCode.load_cached("JoinPyUnicode", "StringTools.c"))
         code.putln('%s = __Pyx_PyUnicode_Join(%s, %d, %s, %s); %s' % (
             self.result(),
-            list_var,
+            parts_var,
             num_items,
             ulength_var,
             max_char_var,
             code.error_goto_if_null(self.py_result(), self.pos)))
         self.generate_gotref(code)
 
-        code.put_decref_clear(list_var, py_object_type)
-        code.funcstate.release_temp(list_var)
+        if old_error_label is None:
+            for i, node, owned_var in object_parts:
+                node.generate_disposal_code(code)
+                node.free_temps(code)
+                if owned_var:
+                    code.put_decref_clear(owned_var, py_object_type)
+                    code.funcstate.release_temp(owned_var)
+        else:
+            clear_parts = "__Pyx_PyUnicode_ClearParts(%s, %d);" % (parts_var, num_items)
+            code.putln(clear_parts)
+            if code.label_used(code.error_label):
+                exit_label = code.new_label('fstring_exit')
+                code.put_goto(exit_label)
+                code.put_label(code.error_label)
+                code.putln(clear_parts)
+                code.put_goto(old_error_label)
+                code.put_label(exit_label)
+            code.error_label = old_error_label
+
+        if buffer_sizes:
+            code.funcstate.release_temp(buffer_var)
+        code.funcstate.release_temp(parts_var)
         code.funcstate.release_temp(ulength_var)
         code.funcstate.release_temp(max_char_var)
 
@@ -3362,9 +3445,26 @@ class FormattedValueNode(ExprNode):
         # PyObject_Format() always returns a Unicode string or raises an exception
         return False
 
+    def is_c_number_part(self):
+        # Can be formatted into a character buffer instead of a Unicode string?
+        return (self.c_format_spec is not None and not self.value.type.is_pyobject and
+                self.value.type.can_convert_to_ascii(self.c_format_spec))
+
+    def _can_ignore_conversion_char(self):
+        # The C level formatting applies the format spec to the number itself.
+        # With '!s' etc., it applies to the string, e.g. f'{x!s:10}' is left aligned.
+        if not self.conversion_char:
+            return True
+        if not self.value.type.is_int:
+            # float repr() and str() differ in Py2
+            return False
+        # 'd' converts to an integer, and str() and repr() of C integers are the default format
+        return self.conversion_char == 'd' or not self.format_spec
+
     def analyse_types(self, env):
         self.value = self.value.analyse_types(env)
-        if not self.format_spec or self.format_spec.is_string_literal:
+        if ((not self.format_spec or self.format_spec.is_string_literal) and
+                self._can_ignore_conversion_char()):
             c_format_spec = self.format_spec.value if self.format_spec else self.value.type.default_format_spec
             if self.value.type.can_coerce_to_pystring(env, format_spec=c_format_spec):
                 self.c_format_spec = c_format_spec
@@ -3477,6 +3577,10 @@ class ParallelThreadIdNode(AtomicExprNode):  #, Nodes.ParallelNode):
         return self
 
     def generate_result_code(self, code):
+        if code.funcstate.parallel_thread_id:
+            # inside the outlined body of a prange(backend='threads')
+            code.putln("%s = %s;" % (self.temp_code, code.funcstate.parallel_thread_id))
+            return
         code.putln("#ifdef _OPENMP")
         code.putln("%s = omp_get_thread_num();" % self.temp_code)
         code.putln("#else")
@@ -3487,6 +3591,24 @@ class ParallelThreadIdNode(AtomicExprNode):  #, Nodes.ParallelNode):
         return self.temp_code
 
 
+class ParallelTaskWaitNode(AtomicExprNode):
+    """
+    Implements cython.parallel.taskwait(), which waits for the tasks that
+    the current task or thread created so far.
+    """
+
+    type = PyrexTypes.c_void_type
+
+    def analyse_types(self, env):
+        return self
+
+    def calculate_result_code(self):
+        return ""
+
+    def generate_result_code(self, code):
+        code.putln_openmp("#pragma omp taskwait")
+
+
 #-------------------------------------------------------------------
 #
 #  Trailer nodes
@@ -6180,9 +6302,78 @@ class PyMethodCallNode(SimpleCallNode):
         code.mark_pos(self.pos)
         self.allocate_temp_result(code)
 
-        self.function.generate_evaluation_code(code)
         assert self.arg_tuple.mult_factor is None
         args = self.arg_tuple.args
+        if self.function.is_attribute and self.function.use_inline_cache:
+            function, self_arg, arg_offset_cname = self.generate_cached_method_lookup(code)
+            reuse_function_temp = False
+            for arg in args:
+                arg.generate_evaluation_code(code)
+        else:
+            function, self_arg, arg_offset_cname, reuse_function_temp = self.generate_method_unpacking(code)
+
+        # actually call the function
+        code.globalstate.use_utility_code(
+            UtilityCode.load_cached("PyObjectFastCall", "ObjectHandling.c"))
+
+        code.putln("{")
+        code.putln("PyObject *__pyx_callargs[%d] = {%s, %s};" % (
+            len(args)+1,
+            self_arg,
+            ', '.join(arg.py_result() for arg in args)))
+        code.putln("%s = __Pyx_PyObject_FastCall(%s, __pyx_callargs+1-%s, %d+%s);" % (
+            self.result(),
+            function,
+            arg_offset_cname,
+            len(args),
+            arg_offset_cname))
+
+        code.put_xdecref_clear(self_arg, py_object_type)
+        code.funcstate.release_temp(self_arg)
+        code.funcstate.release_temp(arg_offset_cname)
+        for arg in args:
+            arg.generate_disposal_code(code)
+            arg.free_temps(code)
+        code.putln(code.error_goto_if_null(self.result(), self.pos))
+        self.generate_gotref(code)
+
+        if reuse_function_temp:
+            self.function.generate_disposal_code(code)
+            self.function.free_temps(code)
+        else:
+            code.put_decref_clear(function, py_object_type)
+            code.funcstate.release_temp(function)
+        code.putln("}")
+
+    def generate_cached_method_lookup(self, code):
+        # Look up the method through an inline cache, which avoids creating a bound method.
+        attribute = self.function
+        attribute.obj.generate_evaluation_code(code)
+        function = code.funcstate.allocate_temp(py_object_type, manage_ref=True)
+        self_arg = code.funcstate.allocate_temp(py_object_type, manage_ref=True)
+        arg_offset_cname = code.funcstate.allocate_temp(PyrexTypes.c_int_type, manage_ref=False)
+        code.globalstate.use_utility_code(
+            UtilityCode.load_cached("PyObjectGetMethodCached", "ObjectHandling.c"))
+        code.putln("%s = NULL;" % function)
+        code.putln("%s = NULL;" % self_arg)
+        code.putln("__Pyx_PyObject_GetMethodCached(%s, %s, %s, &%s); %s" % (
+            arg_offset_cname,
+            attribute.obj.py_result(),
+            code.intern_identifier(attribute.attribute),
+            function,
+            code.error_goto_if_null(function, attribute.pos)))
+        code.put_gotref(function, py_object_type)
+        code.putln("if (%s) {" % arg_offset_cname)
+        code.putln("%s = %s;" % (self_arg, attribute.obj.py_result()))
+        code.put_incref(self_arg, py_object_type)
+        code.putln("}")
+        attribute.obj.generate_disposal_code(code)
+        attribute.obj.free_temps(code)
+        return function, self_arg, arg_offset_cname
+
+    def generate_method_unpacking(self, code):
+        self.function.generate_evaluation_code(code)
+        args = self.arg_tuple.args
         for arg in args:
             arg.generate_evaluation_code(code)
 
@@ -6236,39 +6427,7 @@ class PyMethodCallNode(SimpleCallNode):
         code.putln("%s = 1;" % arg_offset_cname)
         code.putln("}")
         code.putln("}")
-
-        # actually call the function
-        code.globalstate.use_utility_code(
-            UtilityCode.load_cached("PyObjectFastCall", "ObjectHandling.c"))
-
-        code.putln("{")
-        code.putln("PyObject *__pyx_callargs[%d] = {%s, %s};" % (
-            len(args)+1,
-            self_arg,
-            ', '.join(arg.py_result() for arg in args)))
-        code.putln("%s = __Pyx_PyObject_FastCall(%s, __pyx_callargs+1-%s, %d+%s);" % (
-            self.result(),
-            function,
-            arg_offset_cname,
-            len(args),
-            arg_offset_cname))
-
-        code.put_xdecref_clear(self_arg, py_object_type)
-        code.funcstate.release_temp(self_arg)
-        code.funcstate.release_temp(arg_offset_cname)
-        for arg in args:
-            arg.generate_disposal_code(code)
-            arg.free_temps(code)
-        code.putln(code.error_goto_if_null(self.result(), self.pos))
-        self.generate_gotref(code)
-
-        if reuse_function_temp:
-            self.function.generate_disposal_code(code)
-            self.function.free_temps(code)
-        else:
-            code.put_decref_clear(function, py_object_type)
-            code.funcstate.release_temp(function)
-        code.putln("}")
+        return function, self_arg, arg_offset_cname, reuse_function_temp
 
 
 class InlinedDefNodeCallNode(CallNode):
@@ -6870,6 +7029,7 @@ class AttributeNode(ExprNode):
     #  member               string    C name of struct member
     #  is_called            boolean   Function call is being done on result
     #  entry                Entry     Symbol table entry of attribute
+    #  use_inline_cache     boolean   Cache the type lookup of a Python attribute at the call site
 
     is_attribute = 1
     subexprs = ['obj']
@@ -6880,6 +7040,7 @@ class AttributeNode(ExprNode):
     needs_none_check = True
     is_memslice_transpose = False
     is_special_lookup = False
+    use_inline_cache = False
     is_py_attr = 0
 
     def as_cython_attribute(self):
@@ -7302,21 +7463,31 @@ class AttributeNode(ExprNode):
 
     def generate_result_code(self, code):
         if self.is_py_attr:
-            if self.is_special_lookup:
+            if self.use_inline_cache:
                 code.globalstate.use_utility_code(
-                    UtilityCode.load_cached("PyObjectLookupSpecial", "ObjectHandling.c"))
-                lookup_func_name = '__Pyx_PyObject_LookupSpecial'
+                    UtilityCode.load_cached("PyObjectGetAttrStrCached", "ObjectHandling.c"))
+                code.putln(
+                    '__Pyx_PyObject_GetAttrStrCached(%s, %s, %s); %s' % (
+                        self.result(),
+                        self.obj.py_result(),
+                        code.intern_identifier(self.attribute),
+                        code.error_goto_if_null(self.result(), self.pos)))
             else:
-                code.globalstate.use_utility_code(
-                    UtilityCode.load_cached("PyObjectGetAttrStr", "ObjectHandling.c"))
-                lookup_func_name = '__Pyx_PyObject_GetAttrStr'
-            code.putln(
-                '%s = %s(%s, %s); %s' % (
-                    self.result(),
-                    lookup_func_name,
-                    self.obj.py_result(),
-                    code.intern_identifier(self.attribute),
-                    code.error_goto_if_null(self.result(), self.pos)))
+                if self.is_special_lookup:
+                    code.globalstate.use_utility_code(
+                        UtilityCode.load_cached("PyObjectLookupSpecial", "ObjectHandling.c"))
+                    lookup_func_name = '__Pyx_PyObject_LookupSpecial'
+                else:
+                    code.globalstate.use_utility_code(
+                        UtilityCode.load_cached("PyObjectGetAttrStr", "ObjectHandling.c"))
+                    lookup_func_name = '__Pyx_PyObject_GetAttrStr'
+                code.putln(
+                    '%s = %s(%s, %s); %s' % (
+                        self.result(),
+                        lookup_func_name,
+                        self.obj.py_result(),
+                        code.intern_identifier(self.attribute),
+                        code.error_goto_if_null(self.result(), self.pos)))
             self.generate_gotref(code)
         elif self.type.is_memoryviewslice:
             if self.is_memslice_transpose:
@@ -9952,8 +10123,20 @@ class _YieldDelegationExprNode(YieldExprNode):
             code.put_decref_clear(source_cname, py_object_type)
         code.put_xgotref(Naming.retval_cname, py_object_type)
 
-        code.putln("if (likely(%s)) {" % Naming.retval_cname)
+        if self.is_await:
+            # a coroutine that completed without suspending returns its result directly
+            code.putln("if (likely(%s) && likely(%s->yieldfrom)) {" % (
+                Naming.retval_cname, Naming.generator_cname))
+        else:
+            code.putln("if (likely(%s)) {" % Naming.retval_cname)
         self.generate_yield_code(code)
+        if self.is_await:
+            code.putln("} else if (%s) {" % Naming.retval_cname)
+            if self.result_is_used:
+                code.putln("%s = %s; %s = NULL;" % (
+                    self.result(), Naming.retval_cname, Naming.retval_cname))
+            else:
+                code.put_decref_clear(Naming.retval_cname, py_object_type)
         code.putln("} else {")
         # either error or sub-generator has normally terminated: return value => node result
         if self.result_is_used:
@@ -11359,6 +11542,7 @@ class NumBinopNode(BinopNode):
     infix = True
     overflow_check = False
     overflow_bit_node = None
+    fastmath_func = None
 
     def analyse_c_operation(self, env):
         type1 = self.operand1.type
@@ -11369,6 +11553,8 @@ class NumBinopNode(BinopNode):
             return
         if self.type.is_complex:
             self.infix = False
+            if env.directives['complex_fastmath']:
+                self.fastmath_func = self.type.fastmath_op(2, self.operator, env)
         if (self.type.is_int
                 and env.directives['overflowcheck']
                 and self.operator in self.overflow_op_names):
@@ -11454,7 +11640,7 @@ class NumBinopNode(BinopNode):
                 result1, result2 = self.operand1.result(), self.operand2.result()
             return "(%s %s %s)" % (result1, self.operator, result2)
         else:
-            func = self.type.binary_op(self.operator)
+            func = self.fastmath_func or self.type.binary_op(self.operator)
             if func is None:
                 error(self.pos, "binary operator %s not supported for %s" % (self.operator, self.type))
             return "%s(%s, %s)" % (
@@ -13453,7 +13639,7 @@ class CoerceFromPyTypeNode(CoercionNode):
         if not result_type.create_from_py_utility_code(env):
             error(arg.pos,
                   "Cannot convert Python object to '%s'" % result_type)
-        if self.type.is_string or self.type.is_pyunicode_ptr:
+        if self.type.is_string or self.type.is_pyunicode_ptr or self.type.is_cpp_string_view:
             if self.arg.is_name and self.arg.entry and self.arg.entry.is_pyglobal:
                 warning(arg.pos,
                         "Obtaining '%s' from externally modifiable global Python value" % result_type,
@@ -13464,7 +13650,8 @@ class CoerceFromPyTypeNode(CoercionNode):
         return self
 
     def is_ephemeral(self):
-        return (self.type.is_ptr and not self.type.is_array) and self.arg.is_ephemeral()
+        return ((self.type.is_ptr and not self.type.is_array or self.type.is_cpp_string_view)
+                and self.arg.is_ephemeral())
 
     def generate_result_code(self, code):
         from_py_function = None
@@ -1066,7 +1066,11 @@ class ControlFlowAnalysis(CythonTransform):
         return node
 
     def _delete_privates(self, node, exclude=None):
+        # variables with a reduction combiner keep their value in the loop
+        reduced = set(name for name, pos, combiner in node.reduction_names)
         for private_node in node.assigned_nodes:
+            if private_node.entry.name in reduced:
+                continue
             if not exclude or private_node.entry is not exclude:
                 self.flow.mark_deletion(private_node, private_node.entry)
 
@@ -1078,7 +1082,10 @@ class ControlFlowAnalysis(CythonTransform):
         if hasattr(node.target, 'entry'):
             self.reductions = set(reductions)
 
+            reduced = set(name for name, pos, combiner in node.reduction_names)
             for private_node in node.assigned_nodes:
+                if private_node.entry.name in reduced:
+                    continue
                 private_node.entry.error_on_uninitialized = True
                 pos, reduction = node.assignments[private_node.entry]
                 if reduction:
@@ -1099,6 +1106,8 @@ class ControlFlowAnalysis(CythonTransform):
 
         return node
 
+    visit_ParallelTaskNode = visit_ParallelWithBlockNode
+
     def visit_ForFromStatNode(self, node):
         condition_block = self.flow.nextblock()
         next_block = self.flow.newblock()
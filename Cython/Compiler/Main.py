@@ -65,6 +65,7 @@ class Context(object):
     #  include_directories   [string]
     #  future_directives     [object]
     #  language_level        int     currently 2 or 3 for Python 2/3
+    #  pxd_cache             PxdTreeCache or None   on-disk cache of .pxd parse trees
 
     cython_scope = None
     language_level = None  # warn when not set but default to Py2
@@ -88,6 +89,11 @@ class Context(object):
         self.pxds = {}  # full name -> node tree
         self._interned = {}  # (type(value), value, *key_args) -> interned_value
 
+        self.pxd_cache = None
+        if getattr(options, 'pxd_cache', None):
+            from .PxdCache import PxdTreeCache
+            self.pxd_cache = PxdTreeCache(options.pxd_cache)
+
         if language_level is not None:
             self.set_language_level(language_level)
 
@@ -137,7 +143,7 @@ class Context(object):
             result = Pipeline.run_pipeline(pipeline, source)
         else:
             pipeline = Pipeline.create_pxd_pipeline(self, scope, module_name)
-            result = Pipeline.run_pipeline(pipeline, source_desc)
+            result = Pipeline.run_pipeline(pipeline, source_desc, module_name=module_name)
         return result
 
     def nonfatal_error(self, exc):
@@ -336,8 +342,17 @@ class Context(object):
             raise RuntimeError("Only file sources for code supported")
         source_filename = source_desc.filename
         scope.cpp = self.cpp
+        fingerprint = None
+        if pxd and self.pxd_cache is not None and not self.options.formal_grammar:
+            fingerprint = self.pxd_cache.fingerprint(self, source_desc, full_module_name)
+            if fingerprint:
+                tree = self.pxd_cache.load(fingerprint, source_desc, full_module_name)
+                if tree is not None:
+                    return tree
         # Parse the given source file and return a parse tree.
         num_errors = Errors.num_errors
+        num_included_files = len(scope.included_files)
+        future_directives = set(self.future_directives)
         try:
             with Utils.open_source_file(source_filename) as f:
                 from . import Parsing
@@ -358,6 +373,11 @@ class Context(object):
 
         if Errors.num_errors > num_errors:
             raise CompileError()
+        # Files that include other files or change the future directives of the
+        # compilation depend on more than their own content, so they are not cached.
+        if (fingerprint and len(scope.included_files) == num_included_files
+                and self.future_directives == future_directives):
+            self.pxd_cache.store(fingerprint, source_desc, full_module_name, tree)
         return tree
 
     def _report_decode_error(self, source_desc, exc):
@@ -502,6 +522,9 @@ def run_pipeline(source, options, full_module_name=None, context=None):
                 "Dotted filenames ('%s') are deprecated."
                 " Please use the normal Python package directory layout." % os.path.basename(abs_path), level=1)
 
+    if options.timing_report:
+        from . import TimingReport
+        TimingReport.enable(options.timing_report)
     err, enddata = Pipeline.run_pipeline(pipeline, source)
     context.teardown_errors(err, options, result)
     return result
@@ -624,10 +647,15 @@ def compile(source, options = None, full_module_name = None, **kwds):
     CompilationResultSet is returned.
     """
     options = CompilationOptions(defaults = options, **kwds)
-    if isinstance(source, basestring) and not options.timestamps:
-        return compile_single(source, options, full_module_name)
-    else:
-        return compile_multiple(source, options)
+    try:
+        if isinstance(source, basestring) and not options.timestamps:
+            return compile_single(source, options, full_module_name)
+        else:
+            return compile_multiple(source, options)
+    finally:
+        if options.timing_report:
+            from . import TimingReport
+            TimingReport.merge_report_file(options.timing_report)
 
 
 @Utils.cached_function
@@ -839,6 +839,8 @@ typeinfo_to_format_code = load_memview_cy_utility(
 
 is_contig_utility = load_memview_c_utility("MemviewSliceIsContig", context)
 overlapping_utility = load_memview_c_utility("OverlappingSlices", context)
+strided_copy_utility = load_memview_c_utility("StridedCopyKernels")
+parallel_copy_utility = load_memview_c_utility("MemviewParallelCopy", context)
 copy_contents_new_utility = load_memview_c_utility(
     "MemviewSliceCopyTemplate",
     context,
@@ -854,6 +856,8 @@ view_utility_code = load_memview_cy_utility(
                   memviewslice_init_code,
                   is_contig_utility,
                   overlapping_utility,
+                  strided_copy_utility,
+                  parallel_copy_utility,
                   copy_contents_new_utility,
                   ModuleNode.capsule_utility_code],
 )
@@ -458,6 +458,8 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
 
         # initialise the macro to reduce the code size of one-time functionality
         code.putln(UtilityCode.load_as_string("SmallCodeConfig", "ModuleSetupCode.c")[0].strip())
+        # let the traceback code object cache know how many entries it might need
+        code.putln("#define __Pyx_CODE_CACHE_SIZE_HINT %d" % globalstate.error_sites)
 
         self.generate_module_state_start(env, globalstate['module_state'])
         self.generate_module_state_defines(env, globalstate['module_state_defines'])
@@ -465,6 +467,7 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
         self.generate_module_state_traverse(env, globalstate['module_state_traverse'])
 
         # init_globals is inserted before this
+        self.generate_freeze_globals_func(env, globalstate['init_module'])
         self.generate_module_init_func(modules[:-1], env, globalstate['init_module'])
         self.generate_module_cleanup_func(env, globalstate['cleanup_module'])
         if Options.embed:
@@ -2785,9 +2788,7 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
         profile = code.globalstate.directives['profile']
         linetrace = code.globalstate.directives['linetrace']
         if profile or linetrace:
-            if linetrace:
-                code.use_fast_gil_utility_code()
-            code.globalstate.use_utility_code(UtilityCode.load_cached("Profile", "Profile.c"))
+            code.use_profile_utility_code()
 
         code.put_declare_refcount_context()
         code.putln("#if CYTHON_PEP489_MULTI_PHASE_INIT")
@@ -2925,6 +2926,10 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
         self.generate_wrapped_entries_code(env, code)
         code.putln()
 
+        if code.globalstate.frozen_globals:
+            code.putln("/*--- Frozen globals code ---*/")
+            code.put_error_if_neg(self.pos, "__Pyx_FreezeGlobals()")
+
         if Options.generate_cleanup_code:
             code.globalstate.use_utility_code(
                 UtilityCode.load_cached("RegisterModuleCleanup", "ModuleSetupCode.c"))
@@ -2952,6 +2957,9 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
                    env.qualified_name.as_c_string_literal()[1:-1])
         code.putln('}')
         code.put_label(code.return_label)
+        if profile and code.is_sampling_profile():
+            # also unlink the shadow stack frame on errors, it lives on the C stack
+            code.put_trace_return("Py_None")
 
         code.put_finish_refcount_context()
 
@@ -3099,6 +3107,31 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
         code.putln("}")
         code.putln("#endif")
 
+    def generate_freeze_globals_func(self, env, code):
+        # Read the values of the module globals that functions use with the
+        # directive 'optimize.freeze_globals'.  Names that are undefined after
+        # module init keep being looked up on each access.
+        frozen_globals = code.globalstate.frozen_globals
+        if not frozen_globals:
+            return
+        code.globalstate.use_utility_code(
+            UtilityCode.load_cached("GetModuleGlobalName", "ObjectHandling.c"))
+        code.putln("")
+        code.putln("static CYTHON_SMALL_CODE int __Pyx_FreezeGlobals(void) {")
+        code.putln("PyObject *value;")
+        for index, name in enumerate(frozen_globals):
+            code.putln("__Pyx_GetModuleGlobalNameUncached(value, %s);" % code.intern_identifier(name))
+            code.putln("if (likely(value)) {")
+            code.putln("Py_XDECREF(%s[%d]);" % (Naming.frozen_globals_cname, index))
+            code.putln("%s[%d] = value;" % (Naming.frozen_globals_cname, index))
+            code.putln("} else if (unlikely(!PyErr_ExceptionMatches(PyExc_NameError))) {")
+            code.putln("return -1;")
+            code.putln("} else {")
+            code.putln("PyErr_Clear();")
+            code.putln("}")
+        code.putln("return 0;")
+        code.putln("}")
+
     def generate_module_cleanup_func(self, env, code):
         if not Options.generate_cleanup_code:
             return
@@ -3126,6 +3159,10 @@ class ModuleNode(Nodes.Node, Nodes.BlockNode):
                     ext_type.typeptr_cname, ext_type,
                     clear_before_decref=True,
                     nanny=False)
+        if code.globalstate.frozen_globals:
+            code.putln("/*--- Frozen globals cleanup code ---*/")
+            for index in range(len(code.globalstate.frozen_globals)):
+                code.putln("Py_CLEAR(%s[%d]);" % (Naming.frozen_globals_cname, index))
         if Options.cache_builtins:
             code.putln("/*--- Builtin cleanup code ---*/")
             for entry in env.cached_builtins:
@@ -80,10 +80,12 @@ kwvalues_cname   = pyrex_prefix + "kwvalues"
 generator_cname  = pyrex_prefix + "generator"
 sent_value_cname = pyrex_prefix + "sent_value"
 pykwdlist_cname  = pyrex_prefix + "pyargnames"
+pykwdhash_cname  = pyrex_prefix + "pyargnames_hash"
 obj_base_cname   = pyrex_prefix + "base"
 builtins_cname   = pyrex_prefix + "b"
 preimport_cname  = pyrex_prefix + "i"
 moddict_cname    = pyrex_prefix + "d"
+frozen_globals_cname = pyrex_prefix + "frozen_globals"
 dummy_cname      = pyrex_prefix + "dummy"
 filename_cname   = pyrex_prefix + "filename"
 modulename_cname = pyrex_prefix + "modulename"
@@ -103,6 +105,9 @@ retval_cname     = pyrex_prefix + "r"
 reqd_kwds_cname  = pyrex_prefix + "reqd_kwds"
 self_cname       = pyrex_prefix + "self"
 stringtab_cname  = pyrex_prefix + "string_tab"
+stringtab_lazy_cname = pyrex_prefix + "string_tab_lazy"
+string_group_prefix = pyrex_prefix + "string_group_"
+string_groups_done_cname = pyrex_prefix + "string_groups_done"
 vtabslot_cname   = pyrex_prefix + "vtab"
 c_api_tab_cname  = pyrex_prefix + "c_api_tab"
 gilstate_cname   = pyrex_prefix + "state"
@@ -126,6 +131,7 @@ cur_scope_cname  = pyrex_prefix + "cur_scope"
 enc_scope_cname  = pyrex_prefix + "enc_scope"
 frame_cname      = pyrex_prefix + "frame"
 frame_code_cname = pyrex_prefix + "frame_code"
+sample_frame_cname = pyrex_prefix + "sample_frame"
 binding_cfunc    = pyrex_prefix + "binding_PyCFunctionType"
 fused_func_prefix = pyrex_prefix + 'fuse_'
 quick_temp_cname = pyrex_prefix + "temp"  # temp variable for quick'n'dirty temping
@@ -161,6 +167,10 @@ parallel_filename = pyrex_prefix + "parallel_filename"
 parallel_lineno = pyrex_prefix + "parallel_lineno"
 parallel_clineno = pyrex_prefix + "parallel_clineno"
 parallel_why = pyrex_prefix + "parallel_why"
+parallel_context = pyrex_prefix + "parallel_context"
+parallel_loop = pyrex_prefix + "parallel_loop"
+parallel_thread_id = pyrex_prefix + "parallel_thread_id"
+parallel_reduction = pyrex_prefix + "parallel_reduction"
 
 exc_vars = (exc_type_name, exc_value_name, exc_tb_name)
 
@@ -6,7 +6,7 @@ from __future__ import absolute_import
 
 import cython
 
-cython.declare(sys=object, os=object, copy=object,
+cython.declare(sys=object, os=object, copy=object, re=object,
                Builtin=object, error=object, warning=object, Naming=object, PyrexTypes=object,
                py_object_type=object, ModuleScope=object, LocalScope=object, ClosureScope=object,
                StructOrUnionScope=object, PyClassScope=object,
@@ -1852,10 +1852,7 @@ class FuncDefNode(StatNode, BlockNode):
         profile = code.globalstate.directives['profile']
         linetrace = code.globalstate.directives['linetrace']
         if profile or linetrace:
-            if linetrace:
-                code.use_fast_gil_utility_code()
-            code.globalstate.use_utility_code(
-                UtilityCode.load_cached("Profile", "Profile.c"))
+            code.use_profile_utility_code()
 
         # Generate C code for header and body of function
         code.enter_cfunc_scope(lenv)
@@ -2061,7 +2058,9 @@ class FuncDefNode(StatNode, BlockNode):
         # -------------------------
         # ----- Function body -----
         # -------------------------
+        string_group_code = code.start_py_string_group()
         self.generate_function_body(env, code)
+        code.finish_py_string_group(string_group_code, lambda: code.error_goto(self.pos))
 
         code.mark_pos(self.pos, trace=False)
         code.putln("")
@@ -3414,12 +3413,52 @@ class DefNode(FuncDefNode):
         pass
 
 
+def find_keyword_hash(names, max_seed=256):
+    """
+    Search a perfect hash function over the keyword argument names, i.e. a
+    seed and table size for which __Pyx_KeywordHash() in FunctionArguments.c
+    maps all names to distinct slots.  Returns (seed, slots) or None, where
+    'slots' maps each hash slot to the index of its name or -1.
+
+    >>> seed, slots = find_keyword_hash([u'a', u'b', u'c'])
+    >>> sorted(i for i in slots if i >= 0)
+    [0, 1, 2]
+    >>> seed, slots = find_keyword_hash([u'x%d' % i for i in range(30)])
+    >>> len(slots) >= 30, sorted(i for i in slots if i >= 0) == list(range(30))
+    (True, True)
+    """
+    def keyword_hash(name, seed):
+        # FNV-1a over the code points, see __Pyx_KeywordHash()
+        h = (seed ^ 2166136261) & 0xffffffff
+        for c in name:
+            h = ((h ^ ord(c)) * 16777619) & 0xffffffff
+        return h
+
+    size = 1
+    while size < len(names):
+        size *= 2
+    for size in (size, size * 2, size * 4):
+        for seed in range(max_seed):
+            slots = [-1] * size
+            for i, name in enumerate(names):
+                slot = keyword_hash(name, seed) & (size - 1)
+                if slots[slot] != -1:
+                    break
+                slots[slot] = i
+            else:
+                return seed, slots
+    return None
+
+
 class DefNodeWrapper(FuncDefNode):
     # DefNode python wrapper code generator
 
     defnode = None
     target = None  # Target DefNode
 
+    # look up keyword arguments through a perfect hash table from this number of names on
+    min_args_for_keyword_hash = 8
+
     def __init__(self, *args, **kwargs):
         FuncDefNode.__init__(self, *args, **kwargs)
         self.num_posonly_args = self.target.num_posonly_args
@@ -3530,9 +3569,14 @@ class DefNodeWrapper(FuncDefNode):
         code.put_declare_refcount_context()
         code.put_setup_refcount_context(EncodedString('%s (wrapper)' % self.name))
 
+        err_val = self.error_value()
+        # strings for argument parsing, before there is anything to clean up on errors
+        string_group_code = code.start_py_string_group() if err_val is not None else None
         self.generate_argument_parsing_code(lenv, code)
         self.generate_argument_type_tests(code)
         self.generate_function_body(code)
+        code.finish_py_string_group(
+            string_group_code, "{ __Pyx_RefNannyFinishContext(); return %s; }" % err_val)
 
         # ----- Go back and insert temp variable declarations
         tempvardecl_code.put_temp_declarations(code.funcstate)
@@ -4206,7 +4250,14 @@ class DefNodeWrapper(FuncDefNode):
             if max_positional_args > num_pos_only_args:
                 code.putln('}')
 
-        if has_kw_only_args:
+        # Functions with many keyword arguments look up all remaining keywords through
+        # a perfect hash table instead of searching for each optional argument name.
+        keyword_hash = None
+        kw_arg_names = [arg.entry.name for arg in all_args if not arg.pos_only]
+        if len(kw_arg_names) >= self.min_args_for_keyword_hash:
+            keyword_hash = find_keyword_hash(kw_arg_names)
+
+        if has_kw_only_args and not keyword_hash:
             # unpack optional keyword-only arguments separately because
             # checking for interned strings in a dict is faster than iterating
             self.generate_optional_kwonly_args_unpacking_code(all_args, code)
@@ -4253,17 +4304,37 @@ class DefNodeWrapper(FuncDefNode):
             values_array = 'values + %d' % num_pos_only_args
         else:
             values_array = 'values'
-        code.globalstate.use_utility_code(
-            UtilityCode.load_cached("ParseKeywords", "FunctionArguments.c"))
-        code.putln('if (unlikely(__Pyx_ParseOptionalKeywords(%s, %s, %s, %s, %s, %s, %s) < 0)) %s' % (
-            Naming.kwds_cname,
-            Naming.kwvalues_cname,
-            Naming.pykwdlist_cname,
-            self.starstar_arg and self.starstar_arg.entry.cname or '0',
-            values_array,
-            pos_arg_count,
-            self_name_csafe,
-            code.error_goto(self.pos)))
+        if keyword_hash:
+            seed, slots = keyword_hash
+            code.globalstate.use_utility_code(
+                UtilityCode.load_cached("ParseKeywordsHashed", "FunctionArguments.c"))
+            code.putln('static const short %s_slots[] = {%s};' % (
+                Naming.pykwdhash_cname, ','.join(map(str, slots))))
+            code.putln('static const __Pyx_KeywordHashTable %s = {%dU, %dU, %s_slots};' % (
+                Naming.pykwdhash_cname, seed, len(slots) - 1, Naming.pykwdhash_cname))
+            code.putln(
+                'if (unlikely(__Pyx_ParseOptionalKeywordsHashed(%s, %s, %s, %s, %s, %s, %s, &%s) < 0)) %s' % (
+                    Naming.kwds_cname,
+                    Naming.kwvalues_cname,
+                    Naming.pykwdlist_cname,
+                    self.starstar_arg and self.starstar_arg.entry.cname or '0',
+                    values_array,
+                    pos_arg_count,
+                    self_name_csafe,
+                    Naming.pykwdhash_cname,
+                    code.error_goto(self.pos)))
+        else:
+            code.globalstate.use_utility_code(
+                UtilityCode.load_cached("ParseKeywords", "FunctionArguments.c"))
+            code.putln('if (unlikely(__Pyx_ParseOptionalKeywords(%s, %s, %s, %s, %s, %s, %s) < 0)) %s' % (
+                Naming.kwds_cname,
+                Naming.kwvalues_cname,
+                Naming.pykwdlist_cname,
+                self.starstar_arg and self.starstar_arg.entry.cname or '0',
+                values_array,
+                pos_arg_count,
+                self_name_csafe,
+                code.error_goto(self.pos)))
         code.putln('}')
 
     def generate_optional_kwonly_args_unpacking_code(self, all_args, code):
@@ -4524,6 +4595,7 @@ class GeneratorBodyDefNode(DefNode):
         code.put_label(first_run_label)
         code.putln('%s' %
                    (code.error_goto_if_null(Naming.sent_value_cname, self.pos)))
+        string_group_code = code.start_py_string_group()
 
         # ----- prepare target container for inlined comprehension
         if self.is_inlined and self.inlined_comprehension_type is not None:
@@ -4544,6 +4616,7 @@ class GeneratorBodyDefNode(DefNode):
 
         # ----- Function body
         self.generate_function_body(env, code)
+        code.finish_py_string_group(string_group_code, lambda: code.error_goto(self.pos))
         # ----- Closure initialization
         if lenv.scope_class.type.scope.var_entries:
             closure_init_code.putln('%s = %s;' % (
@@ -5621,7 +5694,7 @@ class AssignmentNode(StatNode):
     def analyse_expressions(self, env):
         node = self.analyse_types(env)
         if isinstance(node, AssignmentNode) and not isinstance(node, ParallelAssignmentNode):
-            if node.rhs.type.is_ptr and node.rhs.is_ephemeral():
+            if (node.rhs.type.is_ptr or node.rhs.type.is_cpp_string_view) and node.rhs.is_ephemeral():
                 error(self.pos, "Storing unsafe C derivative of temporary Python reference")
         return node
 
@@ -6785,7 +6858,8 @@ class SwitchCaseNode(StatNode):
 
     def generate_execution_code(self, code):
         num_conditions = len(self.conditions)
-        line_tracing_enabled = code.globalstate.directives['linetrace']
+        line_tracing_enabled = (code.globalstate.directives['linetrace'] or
+                                code.globalstate.directives['profile'] == 'sampling')
         for i, cond in enumerate(self.conditions, 1):
             code.putln("case %s:" % cond.result())
             code.mark_pos(cond.pos)  # Tracing code must appear *after* the 'case' statement.
@@ -8625,7 +8699,8 @@ class ParallelNode(Node):
 
 class ParallelStatNode(StatNode, ParallelNode):
     """
-    Base class for 'with cython.parallel.parallel():' and 'for i in prange():'.
+    Base class for 'with cython.parallel.parallel():', 'for i in prange():'
+    and 'with cython.parallel.task():'.
 
     assignments     { Entry(var) : (var.pos, inplace_operator_or_None) }
                     assignments to variables in this parallel section
@@ -8652,6 +8727,11 @@ class ParallelStatNode(StatNode, ParallelNode):
     args         tuple          the arguments passed to the parallel construct
     kwargs       DictNode       the keyword arguments passed to the parallel
                                 construct (replaced by its compile time value)
+    backend      str or None    'threads' if the loop runs on the work stealing
+                                scheduler in Parallel.c instead of OpenMP
+    reduction_names [(name, pos, NameNode or None)]
+                                the variables named in prange(reduction=...)
+                                and their combiner functions
     """
 
     child_attrs = ['body', 'num_threads']
@@ -8660,11 +8740,14 @@ class ParallelStatNode(StatNode, ParallelNode):
 
     is_prange = False
     is_nested_prange = False
+    is_task = False
 
     error_label_used = False
 
     num_threads = None
     chunksize = None
+    backend = None
+    reduction_names = ()
 
     parallel_exc = (
         Naming.parallel_exc_type,
@@ -8689,6 +8772,9 @@ class ParallelStatNode(StatNode, ParallelNode):
     def __init__(self, pos, **kwargs):
         super(ParallelStatNode, self).__init__(pos, **kwargs)
 
+        # Set by tasks in our body that may raise exceptions
+        self.raising_tasks = False
+
         # All assignments in this scope
         self.assignments = kwargs.get('assignments') or {}
 
@@ -8703,6 +8789,12 @@ class ParallelStatNode(StatNode, ParallelNode):
         # [NameNode]
         self.assigned_nodes = []
 
+        # Assignments to items of variables { Entry: [(pos, inplace_operator_or_None)] }
+        self.item_assignments = {}
+
+        # Variables named in prange(reduction=...) { Entry: (op, combiner) }
+        self.declared_reductions = {}
+
     def analyse_declarations(self, env):
         self.body.analyse_declarations(env)
 
@@ -8722,6 +8814,8 @@ class ParallelStatNode(StatNode, ParallelNode):
                 elif self.is_prange and dictitem.key.value == 'chunksize':
                     if not dictitem.value.is_none:
                         self.chunksize = dictitem.value
+                elif self.is_prange and dictitem.key.value == 'reduction':
+                    self.reduction = dictitem.value
                 else:
                     pairs.append(dictitem)
 
@@ -8773,6 +8867,8 @@ class ParallelStatNode(StatNode, ParallelNode):
         analyse_expressions phase
         """
         for entry, (pos, op) in self.assignments.items():
+            if entry in self.declared_reductions:
+                continue
 
             if self.is_prange and not self.is_parallel:
                 # closely nested prange in a with parallel block, disallow
@@ -9084,6 +9180,7 @@ class ParallelStatNode(StatNode, ParallelNode):
         self.error_label_used = False
 
         self.parallel_private_temps = []
+        self.parallel_private_temp_types = {}
 
         all_labels = code.get_all_labels()
 
@@ -9094,6 +9191,11 @@ class ParallelStatNode(StatNode, ParallelNode):
                                             label != code.continue_label)
                 self.any_label_used = True
 
+        if self.raising_tasks:
+            # A task in the body stored an exception in our variables
+            self.any_label_used = self.breaking_label_used = True
+            self.error_label_used = True
+
         if self.any_label_used:
             code.put_goto(dont_return_label)
 
@@ -9126,7 +9228,7 @@ class ParallelStatNode(StatNode, ParallelNode):
 
             code.put_label(dont_return_label)
 
-            if should_flush and self.breaking_label_used:
+            if should_flush and self.breaking_label_used and self.backend != 'threads':
                 code.putln_openmp("#pragma omp flush(%s)" % Naming.parallel_why)
 
     def save_parallel_vars(self, code):
@@ -9138,9 +9240,12 @@ class ParallelStatNode(StatNode, ParallelNode):
         that the breaking thread has well-defined values of the lastprivate
         variables, so we keep those values.
         """
-        section_name = "__pyx_parallel_lastprivates%d" % self.critical_section_counter
-        code.putln_openmp("#pragma omp critical(%s)" % section_name)
-        ParallelStatNode.critical_section_counter += 1
+        if self.backend == 'threads':
+            code.putln("__Pyx_WorkStealing_Lock(%s);" % Naming.parallel_loop)
+        else:
+            section_name = "__pyx_parallel_lastprivates%d" % self.critical_section_counter
+            code.putln_openmp("#pragma omp critical(%s)" % section_name)
+            ParallelStatNode.critical_section_counter += 1
 
         code.begin_block()  # begin critical section
 
@@ -9169,8 +9274,11 @@ class ParallelStatNode(StatNode, ParallelNode):
             code.putln("%s = %s;" % (temp_cname, private_cname))
 
             self.parallel_private_temps.append((temp_cname, private_cname))
+            self.parallel_private_temp_types[temp_cname] = entry.type
 
         code.end_block()  # end critical section
+        if self.backend == 'threads':
+            code.putln("__Pyx_WorkStealing_Unlock(%s);" % Naming.parallel_loop)
 
     def fetch_parallel_exception(self, code):
         """
@@ -9202,7 +9310,8 @@ class ParallelStatNode(StatNode, ParallelNode):
         code.begin_block()
         code.put_ensure_gil(declare_gilstate=True)
 
-        code.putln_openmp("#pragma omp flush(%s)" % Naming.parallel_exc_type)
+        if self.backend != 'threads':
+            code.putln_openmp("#pragma omp flush(%s)" % Naming.parallel_exc_type)
         code.putln(
             "if (!%s) {" % Naming.parallel_exc_type)
 
@@ -9390,12 +9499,160 @@ class ParallelWithBlockNode(ParallelStatNode):
         self.release_closure_privates(code)
 
 
+class ParallelTaskNode(ParallelStatNode):
+    """
+    This node represents a 'with cython.parallel.task():' block. The body is
+    an OpenMP task that any thread of the enclosing parallel section may run,
+    at the latest at the barrier that ends the enclosing 'with parallel()'
+    block or prange() loop.
+
+    Variables assigned to in the task are private to the task, all other
+    variables have the value they had when the task was created. Exceptions
+    are stored in the exception variables of the enclosing parallel section
+    and raised after it, as the code that created the task may have moved on
+    already:
+
+        #pragma omp task private(x) shared(why, exc_type, ...)
+        {
+            x = ...
+            goto end_task;
+
+        error_label:
+            fetch exception into the enclosing section's exc_type
+            why = 4;
+
+        end_task:;
+        }
+
+    enclosing_parallel   the closest parent that is not a task
+    """
+
+    valid_keyword_arguments = []
+
+    is_task = True
+
+    enclosing_parallel = None
+
+    def analyse_declarations(self, env):
+        super(ParallelTaskNode, self).analyse_declarations(env)
+        if self.args:
+            error(self.pos, "cython.parallel.task() does not take "
+                            "positional arguments")
+        if self.num_threads is not None:
+            error(self.pos, "Invalid keyword argument: num_threads")
+            self.num_threads = None
+
+    def analyse_expressions(self, env):
+        node = super(ParallelTaskNode, self).analyse_expressions(env)
+
+        enclosing = self.parent
+        while enclosing is not None and enclosing.is_task:
+            enclosing = enclosing.parent
+
+        if enclosing is None:
+            error(self.pos, "cython.parallel.task() must be used inside a "
+                            "parallel section")
+        elif enclosing.is_prange and enclosing.backend == 'threads':
+            error(self.pos, "cython.parallel.task() is not supported by the "
+                            "'threads' backend of prange")
+        elif enclosing.is_prange and enclosing.parent and enclosing.parent.is_prange:
+            # nested pranges run sequentially and end without a barrier
+            error(self.pos, "cython.parallel.task() may not be used in a "
+                            "nested prange")
+
+        self.enclosing_parallel = enclosing
+        return node
+
+    def analyse_sharing_attributes(self, env):
+        for entry, (pos, op) in self.assignments.items():
+            if op:
+                error(pos, "Reductions not allowed for tasks")
+                continue
+
+            self.propagate_var_privatization(entry, pos, op, lastprivate=False)
+
+    def generate_execution_code(self, code):
+        self.declare_closure_privates(code)
+        self.setup_parallel_control_flow_block(code)
+
+        code.putln("#ifdef _OPENMP")
+        code.put("#pragma omp task")
+
+        privates = [e.cname for e in self.privates if not e.type.is_pyobject]
+        if privates:
+            code.put(' private(%s)' % ', '.join(sorted(privates)))
+
+        self.privatization_insertion_point = code.insertion_point()
+        code.putln("")
+        code.putln("#endif /* _OPENMP */")
+
+        code.begin_block()  # task block
+        # A deferred task may run after its thread left the parallel block
+        # and released its thread state, so it needs one of its own.
+        self.begin_parallel_block(code)
+        self.initialize_privates_to_nan(code)
+        code.funcstate.start_collecting_temps()
+        self.body.generate_execution_code(code)
+
+        for label in (code.break_label, code.continue_label, code.return_label):
+            if code.label_used(label):
+                error(self.pos, "break, continue and return may not leave "
+                                "a task")
+                break
+
+        self.trap_parallel_exit(code)
+        self.privatize_temps(code)
+        self.end_parallel_block(code)
+        if self.error_label_used:
+            # The exception is raised by the enclosing parallel section, and
+            # every task in between has to share its exception variables.
+            parent = self.parent
+            while parent is not self.enclosing_parallel.parent:
+                parent.raising_tasks = True
+                parent = parent.parent
+        code.end_block()  # end task block
+
+        self.restore_labels(code)
+        code.end_block()  # end parallel control flow block
+        self.release_closure_privates(code)
+
+    def privatize_temps(self, code, exclude_temps=()):
+        c = self.privatization_insertion_point
+        self.privatization_insertion_point = None
+
+        self.temps = temps = code.funcstate.stop_collecting_temps()
+        privates, firstprivates = [], []
+        for temp, type in sorted(temps):
+            if type.is_pyobject or type.is_memoryviewslice:
+                firstprivates.append(temp)
+            else:
+                privates.append(temp)
+
+        if privates:
+            c.put(" private(%s)" % ", ".join(privates))
+        if firstprivates:
+            c.put(" firstprivate(%s)" % ", ".join(firstprivates))
+
+        if self.error_label_used:
+            c.put(" private(%s, %s, %s)" % self.pos_info)
+            c.put(" shared(%s)" % ', '.join((Naming.parallel_why,) + self.parallel_exc))
+
+    def cleanup_temps(self, code):
+        # called by end_parallel_block() with the GIL held
+        for temp, type in sorted(self.temps):
+            if type.is_pyobject or type.is_memoryviewslice:
+                code.put_xdecref_clear(temp, type, have_gil=False)
+
+
 class ParallelRangeNode(ParallelStatNode):
     """
     This node represents a 'for i in cython.parallel.prange():' construct.
 
     target       NameNode       the target iteration variable
     else_clause  Node or None   the else clause of this loop
+    reduction    ExprNode       the reduction argument: a name, a tuple of
+                                names, or a dict of names and combiner
+                                functions
     """
 
     child_attrs = ['body', 'target', 'else_clause', 'args', 'num_threads',
@@ -9403,6 +9660,8 @@ class ParallelRangeNode(ParallelStatNode):
 
     body = target = else_clause = args = None
 
+    reduction = None
+
     start = stop = step = None
 
     is_prange = True
@@ -9410,7 +9669,9 @@ class ParallelRangeNode(ParallelStatNode):
     nogil = None
     schedule = None
 
-    valid_keyword_arguments = ['schedule', 'nogil', 'num_threads', 'chunksize']
+    valid_keyword_arguments = ['schedule', 'nogil', 'num_threads', 'chunksize', 'backend']
+
+    outlined_body_counter = 0
 
     def __init__(self, pos, **kwds):
         super(ParallelRangeNode, self).__init__(pos, **kwds)
@@ -9437,6 +9698,107 @@ class ParallelRangeNode(ParallelStatNode):
         if self.schedule not in (None, 'static', 'dynamic', 'guided', 'runtime'):
             error(self.pos, "Invalid schedule argument to prange: %s" % (self.schedule,))
 
+        if self.backend not in (None, 'openmp', 'threads'):
+            error(self.pos, "Invalid backend argument to prange: %s" % (self.backend,))
+        elif self.backend == 'openmp':
+            self.backend = None
+        elif self.backend == 'threads' and self.schedule:
+            error(self.pos, "The 'threads' backend of prange does not take a schedule")
+
+        if self.reduction is not None:
+            self.reduction_names = self.parse_reduction_argument(self.reduction, env)
+
+    def parse_reduction_argument(self, value, env):
+        from . import ExprNodes
+        if isinstance(value, ExprNodes.DictNode):
+            items = [(item.key, item.value) for item in value.key_value_pairs]
+        elif isinstance(value, (ExprNodes.TupleNode, ExprNodes.ListNode)):
+            items = [(arg, None) for arg in value.args]
+        else:
+            items = [(value, None)]
+
+        names = []
+        for name_node, combiner in items:
+            if not name_node.is_string_literal:
+                error(name_node.pos, "Reduction variables must be given by name")
+                continue
+            if combiner is not None and not combiner.is_name:
+                error(combiner.pos, "Reduction combiner must be the name of a cdef function")
+                continue
+            names.append((name_node.compile_time_value(env), name_node.pos, combiner))
+        return names
+
+    def analyse_reductions(self, env):
+        """
+        Look up the variables named in the reduction argument. Items of C
+        arrays and memoryviews are reduced with the operator of the in-place
+        assignments to them in the loop body, all other variables with the
+        given combiner function.
+        """
+        for name, pos, combiner in self.reduction_names:
+            entry = env.lookup(name)
+            if entry is None or not entry.is_variable:
+                error(pos, "Reduction variable '%s' is not declared" % name)
+                continue
+            if entry in self.declared_reductions:
+                error(pos, "Duplicate reduction variable '%s'" % name)
+                continue
+            if entry.in_closure or entry.from_closure:
+                error(pos, "Reduction variable '%s' may not be used in an inner function" % name)
+                continue
+            type = entry.type
+
+            if combiner is not None:
+                combiner = combiner.analyse_types(env)
+                func_type = combiner.type
+                if func_type.is_ptr:
+                    func_type = func_type.base_type
+                if not func_type.is_cfunction:
+                    error(combiner.pos, "Reduction combiner must be a cdef function")
+                elif (len(func_type.args) != 2 or func_type.has_varargs or
+                        not func_type.return_type.same_as(type) or
+                        not all(arg.type.same_as(type) for arg in func_type.args)):
+                    error(combiner.pos, "Reduction combiner for '%s' must take two "
+                                        "arguments of type '%s' and return it" % (name, type))
+                elif not func_type.nogil:
+                    error(combiner.pos, "Reduction combiner must be nogil")
+                elif type.is_pyobject or type.is_memoryviewslice or type.is_array:
+                    error(pos, "Reduction combiners only support C scalars and structs")
+                self.declared_reductions[entry] = (None, combiner)
+                continue
+
+            if type.is_memoryviewslice:
+                if any(access != 'direct' for access, packing in type.axes):
+                    error(pos, "Reduction memoryview '%s' must have direct access" % name)
+                base_type = type.dtype
+            elif type.is_array:
+                base_type = type
+                while base_type.is_array:
+                    base_type = base_type.base_type
+            else:
+                error(pos, "'%s' must be a C array or memoryview to be a reduction "
+                           "without combiner" % name)
+                continue
+
+            ops = set(op for item_pos, op in self.item_assignments.get(entry, ()))
+            if not ops:
+                error(pos, "No in-place assignments to items of reduction variable '%s'" % name)
+                continue
+            op = ops.pop()
+            if ops or op not in self.reduction_identities:
+                error(pos, "Items of reduction variable '%s' must all be updated with "
+                           "the same in-place operator (one of %s)" % (
+                               name, ', '.join(sorted(self.reduction_identities))))
+            elif not (base_type.is_int or base_type.is_float):
+                error(pos, "Reduction variable '%s' must have a numeric item type" % name)
+            elif base_type.is_float and op in '&|^':
+                error(pos, "Invalid reduction operator '%s' for floating point items" % op)
+            self.declared_reductions[entry] = (op, None)
+
+        if self.declared_reductions and self.parent:
+            error(self.pos, "prange(reduction=...) is only supported for the "
+                            "outermost parallel construct")
+
     def analyse_expressions(self, env):
         was_nogil = env.nogil
         if self.nogil:
@@ -9496,10 +9858,16 @@ class ParallelRangeNode(ParallelStatNode):
         if target_entry:
             self.assignments[self.target.entry] = self.target.pos, None
 
+        self.analyse_reductions(env)
+
         node = super(ParallelRangeNode, self).analyse_expressions(env)
 
+        if node.backend == 'threads' and node.parent:
+            error(node.pos, "The 'threads' backend of prange is only supported "
+                            "for the outermost parallel construct")
+
         if node.chunksize:
-            if not node.schedule:
+            if not node.schedule and node.backend != 'threads':
                 error(node.chunksize.pos,
                       "Must provide schedule with chunksize")
             elif node.schedule == 'runtime':
@@ -9601,7 +9969,11 @@ class ParallelRangeNode(ParallelStatNode):
 
             fmt_dict[name] = result
 
-        fmt_dict['i'] = code.funcstate.allocate_temp(self.index_type, False)
+        if self.backend == 'threads':
+            # only used inside the outlined loop body
+            fmt_dict['i'] = "__pyx_parallel_index"
+        else:
+            fmt_dict['i'] = code.funcstate.allocate_temp(self.index_type, False)
         fmt_dict['nsteps'] = code.funcstate.allocate_temp(self.index_type, False)
 
         # TODO: check if the step is 0 and if so, raise an exception in a
@@ -9624,7 +9996,10 @@ class ParallelRangeNode(ParallelStatNode):
         # target index uninitialized
         code.putln("if (%(nsteps)s > 0)" % fmt_dict)
         code.begin_block()  # if block
-        self.generate_loop(code, fmt_dict)
+        if self.backend == 'threads':
+            self.generate_threads_loop(code, fmt_dict)
+        else:
+            self.generate_loop(code, fmt_dict)
         code.end_block()  # end if block
 
         self.restore_labels(code)
@@ -9648,7 +10023,8 @@ class ParallelRangeNode(ParallelStatNode):
                 temp.generate_disposal_code(code)
                 temp.free_temps(code)
 
-        code.funcstate.release_temp(fmt_dict['i'])
+        if self.backend != 'threads':
+            code.funcstate.release_temp(fmt_dict['i'])
         code.funcstate.release_temp(fmt_dict['nsteps'])
 
         self.release_closure_privates(code)
@@ -9675,6 +10051,9 @@ class ParallelRangeNode(ParallelStatNode):
             # Initialize the GIL if needed for this thread
             self.begin_parallel_block(code)
 
+            if self.declared_reductions:
+                self.put_declared_reductions_init(code, reduction_codepoint)
+
             if self.is_nested_prange:
                 code.putln("#if 0")
             else:
@@ -9734,6 +10113,10 @@ class ParallelRangeNode(ParallelStatNode):
             # nested pranges are not omp'ified, temps go to outer loops
             code.funcstate.start_collecting_temps()
 
+        if self.declared_reductions and self.is_parallel:
+            code.putln("#ifdef _OPENMP")
+            self.put_reduction_buffer_check(code)
+            code.putln("#endif /* _OPENMP */")
         self.body.generate_execution_code(code)
         self.trap_parallel_exit(code, should_flush=True)
         if self.is_parallel and not self.is_nested_prange:
@@ -9748,11 +10131,403 @@ class ParallelRangeNode(ParallelStatNode):
         code.end_block()  # end guard around loop body
         code.end_block()  # end for loop block
 
+        if self.declared_reductions:
+            self.put_declared_reductions_merge(code)
+
         if self.is_parallel:
             # Release the GIL and deallocate the thread state
             self.end_parallel_block(code)
             code.end_block()  # pragma omp parallel end block
 
+    reduction_identities = {'+': '0', '-': '0', '|': '0', '^': '0', '*': '1', '&': '~0'}
+
+    def put_declared_reductions_init(self, code, privatization_point):
+        """
+        Make the variables of prange(reduction=...) private to each OpenMP
+        thread, with a pointer to the shared variable for the final merge.
+        Without OpenMP, the loop updates the variables directly.
+        """
+        c = self.begin_of_parallel_control_block_point
+        c.putln("#ifdef _OPENMP")
+        code.putln("#ifdef _OPENMP")
+        self.reduction_originals = []
+        for i, entry in enumerate(sorted(self.declared_reductions)):
+            original = "%s%d" % (Naming.parallel_reduction, i)
+            c.putln("%s = &%s;" % (entry.type.declaration_code("(*%s)" % original), entry.cname))
+            self.reduction_originals.append((entry, "(*%s)" % original))
+            self.put_reduction_init(code, entry, "(*%s)" % original)
+        c.putln("#endif /* _OPENMP */")
+        code.putln("#endif /* _OPENMP */")
+
+        privatization_point.put(" private(%s)" % ", ".join(
+            entry.cname for entry, original in self.reduction_originals))
+
+    def put_declared_reductions_merge(self, code):
+        section_name = "%s_merge%d" % (Naming.parallel_reduction, self.critical_section_counter)
+        ParallelStatNode.critical_section_counter += 1
+
+        code.putln("#ifdef _OPENMP")
+        code.putln("#pragma omp critical(%s)" % section_name)
+        code.begin_block()
+        for entry, original in self.reduction_originals:
+            self.put_reduction_merge(code, entry, original)
+        code.end_block()
+        code.putln("#endif /* _OPENMP */")
+
+    def _reduction_items(self, entry):
+        """
+        Returns the item type and a C pointer to the first item of a C array
+        or memoryview reduction variable.
+        """
+        type = entry.type
+        if type.is_memoryviewslice:
+            item_type = type.dtype
+            items = "%s.data" % entry.cname
+        else:
+            item_type = type
+            while item_type.is_array:
+                item_type = item_type.base_type
+            items = entry.cname
+        return item_type, "((%s *) %s)" % (item_type.empty_declaration_code(), items)
+
+    def put_reduction_init(self, code, entry, original):
+        """
+        Initialise the thread local copy of a prange(reduction=...) variable
+        from 'original', the C expression of the shared variable.
+        """
+        op, combiner = self.declared_reductions[entry]
+        if combiner is not None:
+            # the value before the loop has to be neutral for the combiner
+            code.putln("%s = %s;" % (entry.cname, original))
+            return
+
+        item_type, items = self._reduction_items(entry)
+        if entry.type.is_memoryviewslice:
+            code.globalstate.use_utility_code(
+                UtilityCode.load_cached("ReductionBuffer", "Parallel.c"))
+            code.putln("%s = %s;" % (entry.cname, original))
+            size = "__Pyx_Parallel_InitReductionBuffer(&%s, %d, sizeof(%s))" % (
+                entry.cname, entry.type.ndim, item_type.empty_declaration_code())
+        else:
+            size = "sizeof(%s) / sizeof(%s)" % (entry.cname, item_type.empty_declaration_code())
+
+        code.putln("{")
+        code.putln("Py_ssize_t __pyx_parallel_item, __pyx_parallel_size = %s;" % size)
+        code.putln("for (__pyx_parallel_item = 0; __pyx_parallel_item < __pyx_parallel_size; "
+                   "__pyx_parallel_item++) %s[__pyx_parallel_item] = %s;" % (
+                       items, item_type.cast_code(self.reduction_identities[op])))
+        code.putln("}")
+
+    def put_reduction_merge(self, code, entry, original):
+        """
+        Merge the thread local copy of a prange(reduction=...) variable into
+        'original'. The caller holds a lock.
+        """
+        op, combiner = self.declared_reductions[entry]
+        if combiner is not None:
+            code.putln("%s = %s(%s, %s);" % (original, combiner.result(), original, entry.cname))
+            return
+
+        if op == '-':
+            op = '+'
+        item_type, items = self._reduction_items(entry)
+        item_decl = item_type.empty_declaration_code()
+        code.putln("{")
+        if entry.type.is_memoryviewslice:
+            ndim = entry.type.ndim
+            code.putln("Py_ssize_t __pyx_parallel_item, __pyx_parallel_size = "
+                       "%s.data ? __Pyx_Parallel_ReductionSize(&%s, %d) : 0;" % (entry.cname, entry.cname, ndim))
+            target = "*(%s *) (%s.data + __Pyx_Parallel_ReductionOffset(&%s, %d, __pyx_parallel_item))" % (
+                item_decl, original, original, ndim)
+        else:
+            code.putln("Py_ssize_t __pyx_parallel_item, __pyx_parallel_size = "
+                       "sizeof(%s) / sizeof(%s);" % (entry.cname, item_decl))
+            target = "((%s *) %s)[__pyx_parallel_item]" % (item_decl, original)
+        code.putln("for (__pyx_parallel_item = 0; __pyx_parallel_item < __pyx_parallel_size; "
+                   "__pyx_parallel_item++) %s %s= %s[__pyx_parallel_item];" % (target, op, items))
+        if entry.type.is_memoryviewslice:
+            code.putln("free(%s.data);" % entry.cname)
+        code.putln("}")
+
+    def put_reduction_buffer_check(self, code):
+        """
+        Raise a MemoryError from the loop body if the thread local copy of a
+        memoryview reduction variable could not be allocated.
+        """
+        buffers = [entry for entry, (op, combiner) in sorted(self.declared_reductions.items())
+                   if entry.type.is_memoryviewslice and combiner is None]
+        if not buffers:
+            return
+        code.putln("if (unlikely(%s)) {" % " || ".join("!%s.data" % entry.cname for entry in buffers))
+        code.put_ensure_gil(declare_gilstate=True)
+        code.putln("PyErr_NoMemory();")
+        code.put_release_ensured_gil()
+        code.putln(code.error_goto(self.pos))
+        code.putln("}")
+
+    def generate_threads_loop(self, code, fmt_dict):
+        """
+        Generate the loop for backend='threads'. The body is outlined into a
+        function that each thread of the work stealing scheduler in Parallel.c
+        calls with its own thread id:
+
+            static void body(void *shared, __pyx_ws_loop *loop, int thread_id) {
+                #define shared_var (*context->shared_var)
+                lastprivate_var = *context->lastprivate_var;
+                reduction_var = 0;
+                while (__Pyx_WorkStealing_Next(loop, thread_id, &begin, &end)) {
+                    for (temp = begin; temp < end; temp++) {
+                        i = start + step * temp;
+                        ...
+                    }
+                    if (end == nsteps)
+                        *context->lastprivate_var = lastprivate_var;
+                }
+                *context->reduction_var += reduction_var;
+                #undef shared_var
+            }
+
+        Privates and the temps of the body become locals of that function,
+        all other variables of the enclosing function that the body uses are
+        passed by pointer in a context struct.
+        """
+        code.globalstate.use_utility_code(
+            UtilityCode.load_cached("WorkStealing", "Parallel.c"))
+
+        ParallelRangeNode.outlined_body_counter += 1
+        body_cname = "%sprange_body%d" % (Naming.pyrex_prefix, self.outlined_body_counter)
+        context_type = "struct %sprange_context%d" % (Naming.pyrex_prefix, self.outlined_body_counter)
+
+        funcstate = code.funcstate
+        old_thread_id, funcstate.parallel_thread_id = funcstate.parallel_thread_id, Naming.parallel_thread_id
+        # there is no frame to trace into from the worker threads
+        old_can_trace, funcstate.can_trace = funcstate.can_trace, False
+
+        body_fmt = dict(fmt_dict, start="__pyx_parallel_start", step="__pyx_parallel_step")
+        body_code = code.new_writer()
+        body_code.level = 2
+        body_code.put("for (%(i)s = __pyx_parallel_begin; %(i)s < __pyx_parallel_end; %(i)s++)" % fmt_dict)
+        body_code.begin_block()  # for loop block
+        guard_around_body_codepoint = body_code.insertion_point()
+        body_code.begin_block()
+        body_code.putln("%(target)s = (%(target_type)s)(%(start)s + %(step)s * %(i)s);" % body_fmt)
+        self.initialize_privates_to_nan(body_code, exclude=self.target.entry)
+
+        temp_count = len(funcstate.temps_allocated)
+        funcstate.start_collecting_temps()
+        self.put_reduction_buffer_check(body_code)
+        self.body.generate_execution_code(body_code)
+        self.trap_parallel_exit(body_code, should_flush=True)
+        self.temps = temps = funcstate.stop_collecting_temps()
+        # new temps of the body are only declared in the outlined function
+        funcstate.forget_temps(temp_count)
+
+        if self.breaking_label_used:
+            guard_around_body_codepoint.putln("if (%s < 2)" % Naming.parallel_why)
+        body_code.end_block()  # end guard around loop body
+        body_code.end_block()  # end for loop block
+
+        funcstate.parallel_thread_id = old_thread_id
+        funcstate.can_trace = old_can_trace
+
+        # Find out which names the body needs from the enclosing function
+        local_types = {fmt_dict['i']: self.index_type}
+        local_types.update(temps)
+        reductions, lastprivates = [], []
+        declared_reductions = sorted(self.declared_reductions)
+        for entry in declared_reductions:
+            local_types[entry.cname] = entry.type
+        for entry, (op, lastprivate) in sorted(self.privates.items()):
+            if entry.type.is_pyobject:
+                continue
+            local_types[entry.cname] = entry.type
+            if op and op in self.reduction_identities and entry != self.target.entry:
+                reductions.append((entry, op))
+            elif lastprivate:
+                lastprivates.append(entry)
+
+        # Variables of the enclosing function that the body refers to, and the
+        # control flow variables that trap_parallel_exit() writes to.
+        shared_types = {}
+        used_entries, has_return = self.find_body_references()
+        scope = funcstate.scope
+        for entry in used_entries:
+            if entry.cname in local_types:
+                continue
+            if entry.in_closure or entry.from_closure:
+                # share the closure scope object that holds the variable
+                scope_cname = entry.cname.split('->', 1)[0]
+                if scope_cname == Naming.cur_scope_cname:
+                    shared_types[scope_cname] = scope.scope_class.type
+                else:
+                    outer_scope = scope.outer_scope
+                    while outer_scope.is_py_class_scope or outer_scope.is_c_class_scope:
+                        outer_scope = outer_scope.outer_scope
+                    shared_types[scope_cname] = outer_scope.scope_class.type
+                continue
+            if not (entry.scope is scope or (entry.in_subscope and not entry.is_cglobal)):
+                # globals and attributes
+                continue
+            shared_types[entry.cname] = entry.type
+            if entry.buffer_aux:
+                for var in (entry.buffer_aux.buflocal_nd_var, entry.buffer_aux.rcbuf_var):
+                    shared_types[var.cname] = var.type
+        if has_return and scope.return_type and not scope.return_type.is_void:
+            shared_types[Naming.retval_cname] = scope.return_type
+        if self.breaking_label_used:
+            shared_types[Naming.parallel_why] = PyrexTypes.c_int_type
+            shared_types.update(self.parallel_private_temp_types)
+        if self.error_label_used:
+            shared_types.update(dict.fromkeys(self.parallel_exc, py_object_type))
+            shared_types.update(zip(self.parallel_pos_info, (
+                PyrexTypes.c_const_char_ptr_type, PyrexTypes.c_int_type, PyrexTypes.c_int_type)))
+        shared_types[fmt_dict['nsteps']] = self.index_type
+        # start and step are read by the outlined function, pass them as plain temps
+        bounds = []
+        bound_values = {}
+        for name in ('start', 'step'):
+            value = fmt_dict[name]
+            if not value.isdigit():
+                temp = funcstate.allocate_temp(self.index_type, manage_ref=False)
+                code.putln("%s = %s;" % (temp, value))
+                bounds.append(temp)
+                shared_types[temp] = self.index_type
+                value = temp
+            bound_values[name] = value
+        shared = sorted(shared_types)
+
+        fields = [(name, shared_types[name]) for name in shared]
+        fields.extend((entry.cname, entry.type) for entry in lastprivates)
+        fields.extend((entry.cname, entry.type) for entry, op in reductions)
+        fields.extend((entry.cname, entry.type) for entry in declared_reductions)
+
+        decls = code.globalstate['decls']
+        if fields:
+            decls.putln("%s {" % context_type)
+            for name, type in fields:
+                decls.putln("%s;" % type.declaration_code("(*%s)" % name))
+            decls.putln("};")
+        decls.putln("static void %s(void *, __pyx_ws_loop *, int); /*proto*/" % body_cname)
+
+        # The outlined function
+        func = code.new_writer()
+        func.putln("")
+        func.putln("static void %s(%svoid *__pyx_parallel_shared, __pyx_ws_loop *%s, int %s) {" % (
+            body_cname, '' if fields else 'CYTHON_UNUSED ', Naming.parallel_loop, Naming.parallel_thread_id))
+        if fields:
+            func.putln("%s *%s = (%s *) __pyx_parallel_shared;" % (
+                context_type, Naming.parallel_context, context_type))
+        for name in shared:
+            func.putln("#define %s (*%s->%s)" % (name, Naming.parallel_context, name))
+        for name, type in sorted(local_types.items()):
+            decl = type.declaration_code(name)
+            if type.is_pyobject:
+                func.putln("%s = NULL;" % decl)
+            elif type.is_memoryviewslice:
+                func.putln("%s = %s;" % (decl, type.literal_code(type.default_value)))
+            else:
+                func.putln("%s;" % decl)
+        index_type = self.index_type.empty_declaration_code()
+        func.putln("const %s __pyx_parallel_start = %s;" % (index_type, bound_values['start']))
+        func.putln("const %s __pyx_parallel_step = %s;" % (index_type, bound_values['step']))
+        func.putln("Py_ssize_t __pyx_parallel_begin, __pyx_parallel_end;")
+        func.putln("CYTHON_UNUSED int %s = 0;" % Naming.lineno_cname)
+        func.putln("CYTHON_UNUSED const char *%s = NULL;" % Naming.filename_cname)
+        func.putln("CYTHON_UNUSED int %s = 0;" % Naming.clineno_cname)
+        func.putln("__Pyx_RefNannyDeclarations")
+        if self.error_label_used:
+            # keep a thread state for this thread while running the body
+            func.put_ensure_gil(declare_gilstate=True)
+            func.putln("Py_BEGIN_ALLOW_THREADS")
+
+        for entry in lastprivates:
+            func.putln("%s = *%s->%s;" % (entry.cname, Naming.parallel_context, entry.cname))
+        for entry, op in reductions:
+            func.putln("%s = %s;" % (entry.cname, entry.type.cast_code(self.reduction_identities[op])))
+        for entry in declared_reductions:
+            self.put_reduction_init(func, entry, "(*%s->%s)" % (Naming.parallel_context, entry.cname))
+
+        func.putln("while (__Pyx_WorkStealing_Next(%s, %s, &__pyx_parallel_begin, &__pyx_parallel_end)) {" % (
+            Naming.parallel_loop, Naming.parallel_thread_id))
+        func.insert(body_code)
+        if lastprivates:
+            # only one chunk ends with the last iteration
+            func.putln("if (__pyx_parallel_end == %s) {" % fmt_dict['nsteps'])
+            func.putln("__Pyx_WorkStealing_Lock(%s);" % Naming.parallel_loop)
+            for entry in lastprivates:
+                func.putln("*%s->%s = %s;" % (Naming.parallel_context, entry.cname, entry.cname))
+            func.putln("__Pyx_WorkStealing_Unlock(%s);" % Naming.parallel_loop)
+            func.putln("}")
+        if self.breaking_label_used:
+            func.putln("if (%s >= 2) break;" % Naming.parallel_why)
+        func.putln("}")
+
+        if reductions or declared_reductions:
+            func.putln("__Pyx_WorkStealing_Lock(%s);" % Naming.parallel_loop)
+            for entry, op in reductions:
+                func.putln("*%s->%s %s= %s;" % (
+                    Naming.parallel_context, entry.cname, '+' if op == '-' else op, entry.cname))
+            for entry in declared_reductions:
+                self.put_reduction_merge(func, entry, "(*%s->%s)" % (Naming.parallel_context, entry.cname))
+            func.putln("__Pyx_WorkStealing_Unlock(%s);" % Naming.parallel_loop)
+
+        if self.error_label_used:
+            func.putln("Py_END_ALLOW_THREADS")
+            self.cleanup_temps(func)
+            func.put_release_ensured_gil()
+        for name in shared:
+            func.putln("#undef %s" % name)
+        func.putln("}")
+        code.globalstate['utility_code_def'].insert(func)
+
+        # Run it from the enclosing function
+        if self.num_threads is not None:
+            num_threads = self.evaluate_before_block(code, self.num_threads)
+        else:
+            num_threads = "0"
+        if self.chunksize is not None:
+            chunksize = self.evaluate_before_block(code, self.chunksize)
+        else:
+            chunksize = "0"
+
+        if fields:
+            # new block, since statements precede the declaration (C89)
+            code.begin_block()
+            code.putln("%s %s;" % (context_type, Naming.parallel_context))
+            for name, type in fields:
+                code.putln("%s.%s = &%s;" % (Naming.parallel_context, name, name))
+        code.putln("__Pyx_WorkStealing_Run(%s, %s, %s, %s, %s);" % (
+            body_cname, "&%s" % Naming.parallel_context if fields else "NULL",
+            fmt_dict['nsteps'], num_threads, chunksize))
+        if fields:
+            code.end_block()
+        for temp in bounds:
+            funcstate.release_temp(temp)
+
+    def find_body_references(self):
+        """
+        Return the entries that the loop body refers to and whether it
+        contains a 'return' statement.
+        """
+        entries = set()
+        has_return = False
+        nodes = [self.body]
+        while nodes:
+            node = nodes.pop()
+            if isinstance(node, list):
+                nodes.extend(node)
+                continue
+            if isinstance(node, ReturnStatNode):
+                has_return = True
+            entry = getattr(node, 'entry', None)
+            if entry is not None and entry.is_variable:
+                entries.add(entry)
+            for attr in node.child_attrs:
+                child = getattr(node, attr, None)
+                if child is not None:
+                    nodes.append(child)
+        return entries, has_return
+
 
 class CnameDecoratorNode(StatNode):
     """
@@ -2663,6 +2663,26 @@ class OptimizeBuiltinCalls(Visitor.NodeRefCleanupMixin,
             utility_code = load_c_utility(utility_code_name) if utility_code_name else None,
             py_name = "float")
 
+    def _handle_simple_function_abs(self, node, function, pos_args):
+        """Replace abs(complex) by the branch-free formula under the
+        'complex_fastmath' directive.
+        """
+        if len(pos_args) != 1 or not self.current_directives.get('complex_fastmath'):
+            return node
+        arg_type = pos_args[0].type
+        if not arg_type.is_complex:
+            return node
+        cfunc_name = arg_type.fastmath_op(1, 'abs', self.current_env())
+        if cfunc_name is None:
+            return node
+        func_type = PyrexTypes.CFuncType(
+            arg_type.real_type, [
+                PyrexTypes.CFuncTypeArg("z", arg_type, None)
+            ], nogil=True)
+        return ExprNodes.PythonCapiCallNode(
+            node.pos, cfunc_name, func_type,
+            args=pos_args, is_temp=node.is_temp, py_name="abs")
+
     PyNumber_Int_func_type = PyrexTypes.CFuncType(
         PyrexTypes.py_object_type, [
             PyrexTypes.CFuncTypeArg("o", PyrexTypes.py_object_type, None)
@@ -4918,6 +4938,8 @@ class FinalOptimizePhase(Visitor.EnvTransform, Visitor.NodeRefCleanupMixin):
         - eliminate useless string formatting steps
         - inject branch hints for unlikely if-cases that only raise exceptions
         - replace Python function calls that look like method calls by a faster PyMethodCallNode
+        - use per call site caches for Python attribute lookups
+        - read module globals from their frozen values in functions
     """
     in_loop = False
 
@@ -4981,6 +5003,33 @@ class FinalOptimizePhase(Visitor.EnvTransform, Visitor.NodeRefCleanupMixin):
                         node, function=function, arg_tuple=node.arg_tuple, type=node.type))
         return node
 
+    def visit_AttributeNode(self, node):
+        """
+        Cache the type lookups of Python attributes at each call site,
+        except in module and class bodies that only run once.
+        """
+        self.visitchildren(node)
+        if node.is_py_attr and not node.is_special_lookup and node.obj.type is not Builtin.type_type:
+            env = self.current_env()
+            if (self.in_loop or not (env.is_module_scope or env.is_py_class_scope)) and \
+                    self.current_directives.get('optimize.inline_caches'):
+                node.use_inline_cache = True
+        return node
+
+    def visit_NameNode(self, node):
+        """
+        Let functions read module globals from the values that they had after
+        module init, unless a function or class declares them 'global'.
+        """
+        entry = node.entry
+        if entry and (entry.is_pyglobal or (entry.is_builtin and not entry.is_const)) and \
+                entry.scope.is_module_scope and entry.type.is_pyobject and \
+                not entry.is_declared_global and self.current_directives.get('optimize.freeze_globals'):
+            env = self.current_env()
+            if not (env.is_module_scope or env.is_py_class_scope):
+                node.use_frozen_global = True
+        return node
+
     def visit_NumPyMethodCallNode(self, node):
         # Exclude from replacement above.
         self.visitchildren(node)
@@ -5058,15 +5107,109 @@ class FinalOptimizePhase(Visitor.EnvTransform, Visitor.NodeRefCleanupMixin):
                 break
 
 
+class _AssignedEntriesCollector(Visitor.TreeVisitor):
+    """
+    Finds the entries of all variables that a subtree may change,
+    by assigning to them or by passing them by address or C++ reference.
+    The latter are also collected in 'escaped_entries', since they might
+    get changed through the pointer or reference anywhere later.
+    """
+    def __init__(self):
+        Visitor.TreeVisitor.__init__(self)
+        self.entries = set()
+        self.escaped_entries = set()
+
+    visit_Node = Visitor.TreeVisitor.visitchildren
+
+    def _add_target(self, node):
+        if node is None:
+            return
+        if node.is_name:
+            if node.entry is not None:
+                self.entries.add(node.entry)
+        elif node.is_sequence_constructor:
+            for arg in node.args:
+                self._add_target(arg)
+        elif isinstance(node, ExprNodes.StarredUnpackingNode):
+            self._add_target(node.target)
+
+    def visit_AssignmentNode(self, node):
+        for lhs in getattr(node, 'lhs_list', None) or [getattr(node, 'lhs', None)]:
+            self._add_target(lhs)
+        self.visitchildren(node)
+
+    def visit_ForInStatNode(self, node):
+        self._add_target(node.target)
+        self.visitchildren(node)
+
+    visit_ForFromStatNode = visit_ForInStatNode
+    visit_ExceptClauseNode = visit_ForInStatNode
+
+    def visit_DelStatNode(self, node):
+        for arg in node.args:
+            self._add_target(arg)
+        self.visitchildren(node)
+
+    def _add_escaped_target(self, node):
+        entries = self.entries
+        self.entries = self.escaped_entries
+        self._add_target(node)
+        self.entries = entries
+        self._add_target(node)
+
+    def visit_AmpersandNode(self, node):
+        self._add_escaped_target(node.operand)
+        self.visitchildren(node)
+
+    def visit_SimpleCallNode(self, node):
+        func_type = node.function.type
+        if func_type.is_ptr:
+            func_type = func_type.base_type
+        if func_type.is_cfunction:
+            for arg, formal_arg in zip(node.args, func_type.args):
+                if formal_arg.type.is_reference:
+                    self._add_escaped_target(arg)
+        self.visitchildren(node)
+
+
 class ConsolidateOverflowCheck(Visitor.CythonTransform):
     """
     This class facilitates the sharing of overflow checking among all nodes
     of a nested arithmetic expression.  For example, given the expression
     a*b + c, where a, b, and x are all possibly overflowing ints, the entire
     sequence will be evaluated and the overflow bit checked only at the end.
+
+    It also removes the overflow checks from additions and subtractions of
+    small constants to the variable of a C integer loop, where the loop bounds
+    prove that they cannot overflow, e.g. from "a[i+1] - a[i-1]" in the body
+    of "for i in range(1, n)".
     """
     overflow_bit_node = None
 
+    # Constants of at most this absolute value fit into any type that gets overflow checked.
+    small_int_limit = 0x7FFF
+
+    def __call__(self, root):
+        # Maps the entry of a loop variable to the largest constant that can be
+        # added to it and subtracted from it without overflowing.
+        self.loop_variable_limits = {}
+        self.escaped_entries = set()
+        return super(ConsolidateOverflowCheck, self).__call__(root)
+
+    def _visit_scope(self, node):
+        # A loop variable whose address is taken anywhere in the function
+        # may be changed through a pointer while the loop runs.
+        collector = _AssignedEntriesCollector()
+        collector.visitchildren(node)
+        saved = self.escaped_entries
+        self.escaped_entries = collector.escaped_entries
+        self.visit_Node(node)
+        self.escaped_entries = saved
+        return node
+
+    visit_FuncDefNode = _visit_scope
+    visit_ModuleNode = _visit_scope
+
     def visit_Node(self, node):
         if self.overflow_bit_node is not None:
             saved = self.overflow_bit_node
@@ -5077,7 +5220,133 @@ class ConsolidateOverflowCheck(Visitor.CythonTransform):
             self.visitchildren(node)
         return node
 
+    def visit_ForFromStatNode(self, node):
+        limits = self._find_loop_variable_limits(node)
+        if limits is None:
+            return self.visit_Node(node)
+        entry = node.target.entry
+        self.visitchildren(node, exclude=('body', 'else_clause'))
+        outer_limits = self.loop_variable_limits.get(entry)
+        self.loop_variable_limits[entry] = limits
+        self.visitchildren(node, attrs=('body',))
+        if outer_limits is None:
+            del self.loop_variable_limits[entry]
+        else:
+            self.loop_variable_limits[entry] = outer_limits
+        self.visitchildren(node, attrs=('else_clause',))
+        return node
+
+    def _small_constant(self, node):
+        if not node.has_constant_result():
+            return None
+        value = node.constant_result
+        if not isinstance(value, _py_int_types) or abs(value) > self.small_int_limit:
+            return None
+        return value
+
+    def _constant_in_range(self, node, int_type):
+        # Returns the value of a small constant that the integer type can hold, or None.
+        value = self._small_constant(node)
+        if value is None:
+            return None
+        if int_type.rank == 0:
+            # char may be unsigned
+            return value if 0 <= value <= 0x7F else None
+        return value if value >= 0 or int_type.signed else None
+
+    def _bound_in_range(self, bound, loop_type):
+        # The loop compares against the bound in its own type, which may be wider
+        # than the loop variable, e.g. an 'unsigned long' bound for a 'long' variable.
+        if self._constant_in_range(bound, loop_type) is not None:
+            return True
+        bound_type = bound.type
+        if not bound_type.is_int or bound_type.is_enum:
+            return False
+        if bound_type.same_as(loop_type):
+            return True
+        return not (bound_type.is_typedef or loop_type.is_typedef or
+                    bool(bound_type.signed) != bool(loop_type.signed) or bound_type.rank > loop_type.rank)
+
+    def _find_loop_variable_limits(self, node):
+        target = node.target
+        if not target.is_name or target.entry is None:
+            return None
+        entry = target.entry
+        loop_type = target.type
+        if not loop_type.is_int or loop_type.is_enum:
+            return None
+        if (not (entry.is_local or entry.is_arg) or entry.in_closure or entry.from_closure or
+                entry in self.escaped_entries):
+            # might get changed elsewhere while the loop runs
+            return None
+        increasing = node.relation2[0] == '<'
+        if not increasing and not loop_type.signed:
+            # uses a different loop setup, see ForFromStatNode.generate_execution_code()
+            return None
+
+        # The stop bound is checked before each iteration, but only limits the
+        # loop variable if the loop variable can hold all of its values.
+        if not self._bound_in_range(node.bound2, loop_type):
+            return None
+        stop_is_strict = node.relation2 in ('<', '>')
+        max_add = max_sub = 0
+        stop = self._constant_in_range(node.bound2, loop_type)
+        if increasing:
+            if stop_is_strict:
+                max_add = 1  # i < stop <= MAX
+            if stop is not None:
+                max_add = max(max_add, self.small_int_limit - (stop - 1 if stop_is_strict else stop))
+        else:
+            if stop_is_strict:
+                max_sub = 1  # i > stop >= MIN
+            if stop is not None:
+                max_sub = max(max_sub, self.small_int_limit + (stop + 1 if stop_is_strict else stop))
+
+        # The start bound holds as long as the loop variable cannot wrap around.
+        start = self._constant_in_range(node.bound1, loop_type)
+        unit_step = node.step is None or self._small_constant(node.step) == 1
+        if start is not None and unit_step and stop_is_strict:
+            if increasing:
+                lowest = start + 1 if node.relation1 == '<' else start
+                if loop_type.signed:
+                    max_sub = max(max_sub, self.small_int_limit + lowest)
+                else:
+                    max_sub = max(max_sub, lowest)
+            else:
+                highest = start - 1 if node.relation1 == '>' else start
+                max_add = max(max_add, self.small_int_limit - highest)
+
+        if max_add <= 0 and max_sub <= 0:
+            return None
+        collector = _AssignedEntriesCollector()
+        collector.visitchildren(node, attrs=('body',))
+        if entry in collector.entries:
+            return None
+        return min(max_add, self.small_int_limit), min(max_sub, self.small_int_limit)
+
+    def _is_safe_loop_arithmetic(self, node):
+        if node.operator not in ('+', '-') or not node.operand1.is_name:
+            return False
+        entry = node.operand1.entry
+        limits = self.loop_variable_limits.get(entry)
+        if limits is None:
+            return False
+        if not node.type.same_as(entry.type):
+            # e.g. 'int + long', which must hold all values of the loop variable
+            if (node.type.is_typedef or entry.type.is_typedef or
+                    bool(node.type.signed) != bool(entry.type.signed) or node.type.rank < entry.type.rank):
+                return False
+        value = self._small_constant(node.operand2)
+        if value is None or (value < 0 and not node.type.signed):
+            return False
+        if node.operator == '-':
+            value = -value
+        max_add, max_sub = limits
+        return -max_sub <= value <= max_add
+
     def visit_NumBinopNode(self, node):
+        if node.overflow_check and self.loop_variable_limits and self._is_safe_loop_arithmetic(node):
+            node.overflow_check = False
         if node.overflow_check and node.overflow_fold:
             top_level_overflow = self.overflow_bit_node is None
             if top_level_overflow:
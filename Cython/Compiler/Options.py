@@ -194,6 +194,7 @@ _directive_defaults = {
     'allow_none_for_extension_args': True,
     'wraparound' : True,
     'ccomplex' : False,  # use C99/C++ for complex types and arith
+    'complex_fastmath' : False,  # branch-free complex arithmetic without the IEEE special cases
     'callspec' : "",
     'nogil' : False,
     'profile': False,
@@ -212,11 +213,13 @@ _directive_defaults = {
     'iterable_coroutine': False,  # Make async coroutines backwards compatible with the old asyncio yield-from syntax.
     'c_string_type': 'bytes',
     'c_string_encoding': '',
+    'cpp_vector_to_py': 'list',
     'type_version_tag': True,  # enables Py_TPFLAGS_HAVE_VERSION_TAG on extension types
     'unraisable_tracebacks': True,
     'old_style_globals': False,
     'np_pythran': False,
     'fast_gil': False,
+    'lazy_strings': False,  # create Python string constants on first use of a function instead of at import
 
     # set __file__ and/or __path__ to known source/target path at import time (instead of not having them available)
     'set_initial_path' : None,  # SOURCEFILE or "/full/path/to/module"
@@ -232,6 +235,8 @@ _directive_defaults = {
 
 # optimizations
     'optimize.inline_defnode_calls': True,
+    'optimize.inline_caches': True,  # slightly increases code size when True
+    'optimize.freeze_globals': False,  # module globals are not rebound after module init
     'optimize.unpack_method_calls': True,  # increases code size when True
     'optimize.unpack_method_calls_in_pyinit': False,  # uselessly increases code size when True
     'optimize.use_switch': True,
@@ -268,6 +273,27 @@ def one_of(*args):
     return validate
 
 
+def profile_mode(name, value):
+    """
+    >>> profile_mode('profile', 'True')
+    True
+    >>> profile_mode('profile', False)
+    False
+    >>> profile_mode('profile', 'sampling')
+    'sampling'
+    >>> profile_mode('profile', 'yes')
+    Traceback (most recent call last):
+    ValueError: profile directive must be True, False or 'sampling', got 'yes'
+    """
+    if value in (True, 'True'):
+        return True
+    elif value in (False, 'False'):
+        return False
+    elif value == 'sampling':
+        return value
+    raise ValueError("%s directive must be True, False or 'sampling', got '%s'" % (name, value))
+
+
 def normalise_encoding_name(option_name, encoding):
     """
     >>> normalise_encoding_name('c_string_encoding', 'ascii')
@@ -325,6 +351,8 @@ directive_types = {
     'freelist': int,
     'c_string_type': one_of('bytes', 'bytearray', 'str', 'unicode'),
     'c_string_encoding': normalise_encoding_name,
+    'cpp_vector_to_py': one_of('list', 'array', 'memoryview'),
+    'profile': profile_mode,  # True/False/'sampling'
     'trashcan': bool,
 }
 
@@ -360,6 +388,7 @@ directive_scopes = {  # defaults to available everywhere
     # Avoid scope-specific to/from_py_functions for c_string.
     'c_string_type': ('module',),
     'c_string_encoding': ('module',),
+    'cpp_vector_to_py': ('module',),
     'type_version_tag': ('module', 'cclass'),
     'language_level': ('module',),
     # globals() could conceivably be controlled at a finer granularity,
@@ -367,6 +396,7 @@ directive_scopes = {  # defaults to available everywhere
     'old_style_globals': ('module',),
     'np_pythran': ('module',),
     'fast_gil': ('module',),
+    'lazy_strings': ('module',),
     'iterable_coroutine': ('module', 'function'),
     'trashcan' : ('cclass',),
 }
@@ -613,6 +643,8 @@ class CompilationOptions(object):
             options['formal_grammar'] = directives['formal_grammar']
         if options['cache'] is True:
             options['cache'] = os.path.join(Utils.get_cython_cache_dir(), 'compiler')
+        if options['pxd_cache'] is True:
+            options['pxd_cache'] = os.path.join(Utils.get_cython_cache_dir(), 'pxd')
 
         self.__dict__.update(options)
 
@@ -638,9 +670,12 @@ class CompilationOptions(object):
             elif key in ['timestamps']:
                 # the cache cares about the content of files, not about the timestamps of sources
                 continue
-            elif key in ['cache']:
+            elif key in ['cache', 'pxd_cache']:
                 # hopefully caching has no influence on the compilation result
                 continue
+            elif key in ['timing_report']:
+                # the report is written next to the compilation, not into its output
+                continue
             elif key in ['compiler_directives']:
                 # directives passed on to the C compiler do not influence the generated C code
                 continue
@@ -735,6 +770,8 @@ default_options = dict(
     output_dir=None,
     build_dir=None,
     cache=None,
+    pxd_cache=None,
+    timing_report=None,
     create_extension=None,
     np_pythran=False
 )
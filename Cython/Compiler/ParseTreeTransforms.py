@@ -696,6 +696,8 @@ class InterpretCompilerDirectives(CythonTransform):
         "parallel",
         "prange",
         "threadid",
+        "task",
+        "taskwait",
         #"threadsavailable",
     }
 
@@ -916,7 +918,7 @@ class InterpretCompilerDirectives(CythonTransform):
             optname = node.as_cython_attribute()
             if optname:
                 directivetype = Options.directive_types.get(optname)
-                if directivetype is bool:
+                if directivetype is bool or optname == 'profile':
                     arg = ExprNodes.BoolNode(node.pos, value=True)
                     return [self.try_to_parse_directive(optname, [arg], None, node.pos)]
                 elif directivetype is None:
@@ -980,6 +982,9 @@ class InterpretCompilerDirectives(CythonTransform):
                 raise PostParseError(pos,
                     'The %s directive takes no keyword arguments' % optname)
             return optname, [ str(arg.value) for arg in args ]
+        elif optname == 'profile' and kwds is None and len(args) == 1 and isinstance(args[0], ExprNodes.BoolNode):
+            # profile(True) / profile(False), next to profile('sampling')
+            return (optname, args[0].value)
         elif callable(directivetype):
             if kwds is not None or len(args) != 1 or not isinstance(
                     args[0], (ExprNodes.StringNode, ExprNodes.UnicodeNode)):
@@ -1112,7 +1117,9 @@ class ParallelRangeTransform(CythonTransform, SkipDeclarations):
         with nogil, cython.parallel.parallel(): -> ParallelWithBlockNode
             print cython.parallel.threadid()    -> ParallelThreadIdNode
             for i in cython.parallel.prange(...):  -> ParallelRangeNode
-                ...
+                with cython.parallel.task():    -> ParallelTaskNode
+                    ...
+                cython.parallel.taskwait()      -> ParallelTaskWaitNode
     """
 
     # a list of names, maps 'cython.parallel.prange' in the code to
@@ -1134,6 +1141,8 @@ class ParallelRangeTransform(CythonTransform, SkipDeclarations):
         # u"cython.parallel.threadsavailable": ExprNodes.ParallelThreadsAvailableNode,
         u"cython.parallel.threadid": ExprNodes.ParallelThreadIdNode,
         u"cython.parallel.prange": Nodes.ParallelRangeNode,
+        u"cython.parallel.task": Nodes.ParallelTaskNode,
+        u"cython.parallel.taskwait": ExprNodes.ParallelTaskWaitNode,
     }
 
     def node_is_parallel_directive(self, node):
@@ -1227,6 +1236,9 @@ class ParallelRangeTransform(CythonTransform, SkipDeclarations):
 
             newnode.body = body
             return newnode
+        elif isinstance(newnode, Nodes.ParallelTaskNode):
+            newnode.body = self.visit(node.body)
+            return newnode
         elif self.parallel_directive:
             parallel_directive_class = self.get_directive_class_node(node)
 
@@ -1234,7 +1246,8 @@ class ParallelRangeTransform(CythonTransform, SkipDeclarations):
                 # There was an error, stop here and now
                 return None
 
-            if parallel_directive_class is Nodes.ParallelWithBlockNode:
+            if parallel_directive_class in (Nodes.ParallelWithBlockNode,
+                                            Nodes.ParallelTaskNode):
                 error(node.pos, "The parallel directive must be called")
                 return None
 
@@ -1891,8 +1904,6 @@ if VALUE is not None:
         node.stats.insert(0, node.py_func)
         node.py_func = self.visit(node.py_func)
         node.update_fused_defnode_entry(env)
-        # For the moment, fused functions do not support METH_FASTCALL
-        node.py_func.entry.signature.use_fastcall = False
         pycfunc = ExprNodes.PyCFunctionNode.from_defnode(node.py_func, binding=True)
         pycfunc = ExprNodes.ProxyNode(pycfunc.coerce_to_temp(env))
         node.resulting_fused_function = pycfunc
@@ -3037,6 +3048,15 @@ class GilCheck(VisitorTransform):
         self.visitchildren(node)
         return node
 
+    def visit_ParallelTaskNode(self, node):
+        if not self.nogil:
+            error(node.pos, "cython.parallel.task() may only be used without "
+                            "the GIL")
+            return None
+
+        self.visitchildren(node)
+        return node
+
     def visit_TryFinallyStatNode(self, node):
         """
         Take care of try/finally statements in nogil code sections.
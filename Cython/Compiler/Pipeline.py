@@ -342,9 +342,11 @@ def insert_into_pipeline(pipeline, transform, before=None, after=None):
 _pipeline_entry_points = {}
 
 
-def run_pipeline(pipeline, source, printtree=True):
+def run_pipeline(pipeline, source, printtree=True, module_name=None):
     from .Visitor import PrintTree
+    from . import TimingReport
     exec_ns = globals().copy() if DebugFlags.debug_verbose_pipeline else None
+    timer = TimingReport.get_timer()
 
     def run(phase, data):
         return phase(data)
@@ -367,7 +369,11 @@ def run_pipeline(pipeline, source, printtree=True):
                         except KeyError:
                             exec("def %s(phase, data): return phase(data)" % phase_name, exec_ns)
                             run = _pipeline_entry_points[phase_name] = exec_ns[phase_name]
-                    data = run(phase, data)
+                    if timer is not None:
+                        data = timer.run_phase(
+                            source, module_name, getattr(phase, '__name__', type(phase).__name__), run, phase, data)
+                    else:
+                        data = run(phase, data)
                     if DebugFlags.debug_verbose_pipeline:
                         print("    %.3f seconds" % (time() - t))
         except CompileError as err:
@@ -0,0 +1,138 @@
+#
+#   Persistent cache of parsed .pxd files
+#
+
+from __future__ import absolute_import
+
+import os
+import sys
+import stat
+import hashlib
+import tempfile
+
+try:
+    import cPickle as pickle
+except ImportError:
+    import pickle
+
+from .. import __version__
+from ..Utils import safe_makedirs
+from .Scanning import SourceDescriptor
+from .Symtab import Scope
+
+
+class PxdTreeCache(object):
+    """
+    Stores the parse trees of .pxd files on disk, so that each cimport of
+    a .pxd file does not need to scan and parse it again, also across
+    compiler runs and the worker processes of cythonize().
+
+    Entries are keyed by the content of the .pxd file, the Cython and
+    Python versions and the compiler state that the parser depends on.
+    They are written atomically, so that a cache directory can be shared
+    by concurrent builds of the same user.
+
+    The entries are pickles, and loading a pickle can run arbitrary code.
+    The cache is therefore only used if its directory belongs to the current
+    user and cannot be written to by anyone else.
+
+    Only parse trees are cached.  The declaration analysis of a .pxd file
+    creates types and entries in the scopes of the current compilation
+    (and of the modules that it cimports), so it still runs for each
+    compilation.
+    """
+    pickle_protocol = pickle.HIGHEST_PROTOCOL
+
+    def __init__(self, cache_dir):
+        self.cache_dir = cache_dir
+        self._is_private = None
+
+    def is_private(self):
+        if self._is_private is None:
+            self._is_private = self._check_private_dir()
+            if not self._is_private:
+                sys.stderr.write(
+                    "Not using the .pxd cache in '%s', which other users can write to\n" % self.cache_dir)
+        return self._is_private
+
+    def _check_private_dir(self):
+        try:
+            if not os.path.isdir(self.cache_dir):
+                os.makedirs(self.cache_dir, 0o700)
+            st = os.lstat(self.cache_dir)
+        except (IOError, OSError):
+            return True  # nothing to load from, and storing fails quietly
+        if not stat.S_ISDIR(st.st_mode):
+            return False  # e.g. a symlink planted by someone else
+        if hasattr(os, 'getuid'):
+            return st.st_uid == os.getuid() and not st.st_mode & (stat.S_IWGRP | stat.S_IWOTH)
+        # On Windows, rely on the permissions of the user's profile directory.
+        return True
+
+    def fingerprint(self, context, source_desc, full_module_name):
+        try:
+            with open(source_desc.filename, 'rb') as f:
+                source = f.read()
+        except (IOError, OSError):
+            return None
+        m = hashlib.sha1(__version__.encode('UTF-8'))
+        m.update(source)
+        # The parse tree refers to the file for its source positions.
+        for value in [
+                os.path.abspath(source_desc.filename), full_module_name,
+                sys.version_info[:2], self.pickle_protocol,
+                context.language_level, context.cpp,
+                sorted(repr(directive) for directive in context.future_directives),
+                sorted((getattr(context.options, 'compile_time_env', None) or {}).items())]:
+            m.update(repr(value).encode('UTF-8'))
+        return m.hexdigest()
+
+    def entry_path(self, fingerprint, full_module_name):
+        return os.path.join(self.cache_dir, fingerprint[:2], "%s-%s.pickle" % (full_module_name, fingerprint))
+
+    def load(self, fingerprint, source_desc, full_module_name):
+        if not self.is_private():
+            return None
+        path = self.entry_path(fingerprint, full_module_name)
+        try:
+            with open(path, 'rb') as f:
+                unpickler = pickle.Unpickler(f)
+                unpickler.persistent_load = lambda pid: source_desc
+                return unpickler.load()
+        except Exception:
+            # Missing or broken entries (e.g. truncated files) are simply parsed and written again.
+            return None
+
+    def store(self, fingerprint, source_desc, full_module_name, tree):
+        def persistent_id(obj):
+            if obj is source_desc:
+                return 'source'
+            if isinstance(obj, (SourceDescriptor, Scope)):
+                # Trees from included files or with references into the
+                # compilation state cannot be restored in another compilation.
+                raise pickle.PicklingError("Cannot cache %r" % obj)
+            return None
+
+        if not self.is_private():
+            return False
+        path = self.entry_path(fingerprint, full_module_name)
+        try:
+            safe_makedirs(os.path.dirname(path))
+            fd, tmp_path = tempfile.mkstemp(suffix='.tmp', dir=os.path.dirname(path))
+        except (IOError, OSError):
+            return False
+        try:
+            with os.fdopen(fd, 'wb') as f:
+                pickler = pickle.Pickler(f, self.pickle_protocol)
+                pickler.persistent_id = persistent_id
+                pickler.dump(tree)
+            os.rename(tmp_path, path)
+        except Exception:
+            # Includes RecursionError for deeply nested trees, and failures
+            # to rename on Windows if another process published the entry first.
+            try:
+                os.remove(tmp_path)
+            except OSError:
+                pass
+            return False
+        return True
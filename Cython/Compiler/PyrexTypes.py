@@ -44,6 +44,9 @@ class BaseType(object):
     def convert_to_pystring(self, cvalue, code, format_spec=None):
         raise NotImplementedError("C types that support string formatting must override this method")
 
+    def can_convert_to_ascii(self, format_spec=None):
+        return False
+
     def cast_code(self, expr_code):
         return "((%s)%s)" % (self.empty_declaration_code(), expr_code)
 
@@ -192,6 +195,7 @@ class PyrexType(BaseType):
     #  is_string             boolean     Is a C char * type
     #  is_pyunicode_ptr      boolean     Is a C PyUNICODE * type
     #  is_cpp_string         boolean     Is a C++ std::string type
+    #  is_cpp_string_view    boolean     Is a C++ std::string_view type (borrows the data)
     #  is_unicode_char       boolean     Is either Py_UCS4 or Py_UNICODE
     #  is_returncode         boolean     Is used only to signal exceptions
     #  is_error              boolean     Is the dummy error type
@@ -254,6 +258,7 @@ class PyrexType(BaseType):
     is_struct_or_union = 0
     is_cpp_class = 0
     is_cpp_string = 0
+    is_cpp_string_view = 0
     is_struct = 0
     is_enum = 0
     is_cpp_enum = False
@@ -2023,13 +2028,19 @@ class CIntLike(object):
         format_type, width, padding = self._parse_format(format_spec)
         return format_type is not None and width <= 2**30
 
+    def _pystring_utility_context(self):
+        return {
+            "TYPE": self.empty_declaration_code(),
+            "TO_PY_FUNCTION": "__Pyx_PyUnicode_From_" + self.specialization_name(),
+            "TO_ASCII_FUNCTION": "__Pyx_Ascii_From_" + self.specialization_name(),
+        }
+
     def convert_to_pystring(self, cvalue, code, format_spec=None):
         if self.to_pyunicode_utility is None:
-            utility_code_name = "__Pyx_PyUnicode_From_" + self.specialization_name()
+            context = self._pystring_utility_context()
+            utility_code_name = context["TO_PY_FUNCTION"]
             to_pyunicode_utility = TempitaUtilityCode.load_cached(
-                "CIntToPyUnicode", "TypeConversion.c",
-                context={"TYPE": self.empty_declaration_code(),
-                         "TO_PY_FUNCTION": utility_code_name})
+                "CIntToPyUnicode", "TypeConversion.c", context=context)
             self.to_pyunicode_utility = (utility_code_name, to_pyunicode_utility)
         else:
             utility_code_name, to_pyunicode_utility = self.to_pyunicode_utility
@@ -2037,6 +2048,26 @@ class CIntLike(object):
         format_type, width, padding_char = self._parse_format(format_spec)
         return "%s(%s, %d, '%s', '%s')" % (utility_code_name, cvalue, width, padding_char, format_type)
 
+    # Formatting into a character buffer on the stack, used when building f-strings.
+    max_ascii_width = 64
+
+    def can_convert_to_ascii(self, format_spec=None):
+        format_type, width, padding = self._parse_format(format_spec)
+        return format_type is not None and width <= self.max_ascii_width
+
+    def ascii_buffer_size(self, format_spec=None):
+        format_type, width, padding = self._parse_format(format_spec)
+        size = "sizeof(%s)*3+2" % self.empty_declaration_code()
+        return "%s+%d" % (size, width) if width else size
+
+    def convert_to_ascii(self, cvalue, buffer_end, code, format_spec=None):
+        context = self._pystring_utility_context()
+        code.globalstate.use_utility_code(TempitaUtilityCode.load_cached(
+            "CIntToAscii", "TypeConversion.c", context=context))
+        format_type, width, padding_char = self._parse_format(format_spec)
+        return "%s(%s, %d, '%s', '%s', %s)" % (
+            context["TO_ASCII_FUNCTION"], cvalue, width, padding_char, format_type, buffer_end)
+
 
 class CIntType(CIntLike, CNumericType):
 
@@ -2116,6 +2147,14 @@ def _load_overflow_base(env):
         env.use_utility_code(TempitaUtilityCode.load_cached(
             "BaseCaseUnsigned", "Overflow.c",
             context={'UINT': type, 'NAME': type.replace(' ', '_')}))
+    # Only compiled if the C compiler supports __int128.  The names must not clash
+    # with the specialisation name of a typedef, e.g. of "ctypedef ... int128 '__int128'".
+    env.use_utility_code(TempitaUtilityCode.load_cached(
+        "BaseCaseSigned", "Overflow.c",
+        context={'INT': '__int128', 'NAME': 'pyx_int128'}))
+    env.use_utility_code(TempitaUtilityCode.load_cached(
+        "BaseCaseUnsigned", "Overflow.c",
+        context={'UINT': 'unsigned __int128', 'NAME': 'pyx_uint128'}))
 
 
 class CAnonEnumType(CIntType):
@@ -2137,6 +2176,9 @@ class CReturnCodeType(CIntType):
     def can_coerce_to_pystring(self, env, format_spec=None):
         return not format_spec
 
+    def can_convert_to_ascii(self, format_spec=None):
+        return False
+
     def convert_to_pystring(self, cvalue, code, format_spec=None):
         return "__Pyx_NewRef(%s)" % code.globalstate.get_py_string_const(StringEncoding.EncodedString("None")).cname
 
@@ -2151,6 +2193,10 @@ class CBIntType(CIntType):
     def can_coerce_to_pystring(self, env, format_spec=None):
         return not format_spec or super(CBIntType, self).can_coerce_to_pystring(env, format_spec)
 
+    def can_convert_to_ascii(self, format_spec=None):
+        # 'True' and 'False' are string constants
+        return bool(format_spec) and super(CBIntType, self).can_convert_to_ascii(format_spec)
+
     def convert_to_pystring(self, cvalue, code, format_spec=None):
         if format_spec:
             return super(CBIntType, self).convert_to_pystring(cvalue, code, format_spec)
@@ -2291,6 +2337,32 @@ class CFloatType(CNumericType):
     def invalid_value(self):
         return Naming.PYX_NAN
 
+    default_format_spec = ''
+
+    @staticmethod
+    def _parse_format(format_spec):
+        # Only the subset '[0][width][.precision][type]' that PyOS_double_to_string() supports directly.
+        match = re.match(r'^(0?)([1-9][0-9]{0,8})?(?:\.([0-9]{1,9}))?([eEfFgG]?)$', format_spec or '')
+        if match is None:
+            return None
+        zero_padding, width, precision, format_type = match.groups()
+        flags = 0
+        if not format_type:
+            # like repr(), or like 'g' with at least one digit after the decimal point
+            flags = 'Py_DTSF_ADD_DOT_0'
+            format_type = 'g' if precision else 'r'
+        precision = int(precision) if precision else 0 if format_type == 'r' else 6
+        return (format_type, int(width or 0), zero_padding or ' ', precision, flags)
+
+    def can_coerce_to_pystring(self, env, format_spec=None):
+        return self._parse_format(format_spec) is not None
+
+    def convert_to_pystring(self, cvalue, code, format_spec=None):
+        code.globalstate.use_utility_code(UtilityCode.load_cached("CFloatToPyUnicode", "TypeConversion.c"))
+        format_type, width, padding_char, precision, flags = self._parse_format(format_spec)
+        return "__Pyx_PyUnicode_From_double((double) %s, %d, '%s', '%s', %d, %s)" % (
+            cvalue, width, padding_char, format_type, precision, flags)
+
 class CComplexType(CNumericType):
 
     is_complex = 1
@@ -2435,6 +2507,17 @@ class CComplexType(CNumericType):
         except KeyError:
             return None
 
+    def fastmath_op(self, nargs, op, env):
+        # Branch-free variants of some operations, used by the 'complex_fastmath' directive.
+        if not self.real_type.is_float:
+            return None
+        op_name = complex_fastmath_ops.get((nargs, op))
+        if op_name is None:
+            return None
+        env.use_utility_code(TempitaUtilityCode.load_cached(
+            'FastArithmetic', 'Complex.c', self._utility_code_context()))
+        return "__Pyx_c_%s_fast%s" % (op_name, self.funcsuffix)
+
     def unary_op(self, op):
         return self.lookup_op(1, op)
 
@@ -2458,6 +2541,12 @@ complex_ops = {
     (2, '=='): 'eq',
 }
 
+complex_fastmath_ops = {
+    (1, 'abs'): 'abs',
+    (2, '*'): 'prod',
+    (2, '/'): 'quot',
+}
+
 
 class CPyTSSTType(CType):
     #
@@ -3701,7 +3790,7 @@ class CStructOrUnionType(CType):
             return expr_code
         return super(CStructOrUnionType, self).cast_code(expr_code)
 
-cpp_string_conversions = ("std::string",)
+cpp_string_conversions = ("std::string", "std::string_view")
 
 builtin_cpp_conversions = {
     # type                element template params
@@ -3715,6 +3804,21 @@ builtin_cpp_conversions = {
     "std::complex":       1,
 }
 
+
+def cpp_buffer_item_kind(type):
+    """
+    Return the kind of items ('i'nteger, 'u'nsigned or 'f'loat) in which values
+    of a C++ container item type can be copied in bulk from and into Python
+    buffers, or None if the items must be converted one by one.
+    """
+    type = type.resolve()
+    if type.is_float:
+        return 'f'
+    if type.is_int and not (type.is_enum or type.is_unicode_char or isinstance(type, CBIntType)):
+        return 'i' if type.signed else 'u'
+    return None
+
+
 class CppClassType(CType):
     #  name          string
     #  cname         string
@@ -3748,6 +3852,7 @@ class CppClassType(CType):
         else:
             self.specializations = {}
         self.is_cpp_string = cname in cpp_string_conversions
+        self.is_cpp_string_view = cname == "std::string_view"
 
     def use_conversion_utility(self, from_or_to):
         pass
@@ -3806,6 +3911,13 @@ class CppClassType(CType):
                 'maybe_unordered': self.maybe_unordered(),
                 'type': self.cname,
             })
+            requires = []
+            if cls in ('vector', 'unordered_set'):
+                requires.append(UtilityCode.load_cached("CppLengthHint", "CppSupport.cpp"))
+            if cls == 'vector':
+                context['buffer_kind'] = cpp_buffer_item_kind(self.templates[0])
+                if context['buffer_kind']:
+                    requires.append(UtilityCode.load_cached("CppBufferFormatMatches", "CppSupport.cpp"))
             from .UtilityCode import CythonUtilityCode
             if has_operator:
                 templates = X[:len(self.templates)]
@@ -3829,6 +3941,7 @@ class CppClassType(CType):
                     cls.replace('unordered_', '') + ".from_py",
                     "CppConvert.pyx",
                     context=context,
+                    requires=requires or None,
                     compiler_directives=env.directives
                 )
             env.use_utility_code(utility_code)
@@ -3875,6 +3988,13 @@ class CppClassType(CType):
             else:
                 cls = self.cname[5:]
                 prefix = ''
+            requires = None
+            if cls == 'vector':
+                context['buffer_kind'] = cpp_buffer_item_kind(self.templates[0])
+                context['to_py_type'] = env.directives['cpp_vector_to_py'] if context['buffer_kind'] else 'list'
+                if context['to_py_type'] != 'list':
+                    prefix = context['to_py_type'] + '_'
+                    requires = [UtilityCode.load_cached("CppArrayFromData", "CppSupport.cpp")]
             cname = "__pyx_convert_%s%s_to_py_%s" % (prefix, cls, "____".join(tags))
             context.update({
                 'cname': cname,
@@ -3903,6 +4023,7 @@ class CppClassType(CType):
                 utility_code = CythonUtilityCode.load(
                     cls.replace('unordered_', '') + ".to_py", "CppConvert.pyx",
                     context=context,
+                    requires=requires,
                     compiler_directives=env.directives
                 )
             env.use_utility_code(utility_code)
@@ -4546,6 +4667,7 @@ cy_numeric_type = FusedType([c_short_type,
 c_buf_diminfo_type =  CStructOrUnionType("__Pyx_Buf_DimInfo", "struct",
                                       None, 1, "__Pyx_Buf_DimInfo")
 c_pyx_buffer_type = CStructOrUnionType("__Pyx_Buffer", "struct", None, 1, "__Pyx_Buffer")
+c_pyx_unicode_part_type = CStructOrUnionType("__Pyx_UnicodePart", "struct", None, 1, "__Pyx_UnicodePart")
 c_pyx_buffer_ptr_type = CPtrType(c_pyx_buffer_type)
 c_pyx_buffer_nd_type = CStructOrUnionType("__Pyx_LocalBuf_ND", "struct",
                                       None, 1, "__Pyx_LocalBuf_ND")
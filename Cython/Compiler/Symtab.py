@@ -91,6 +91,7 @@ class Entry(object):
     # is_pyglobal      boolean    Is a Python module-level variable
     #                               or class attribute during
     #                               class construction
+    # is_declared_global boolean  Is declared 'global' in a function or class
     # is_member        boolean    Is an assigned class member
     # is_pyclass_attr  boolean    Is a name in a Python class namespace
     # is_variable      boolean    Is a variable
@@ -169,6 +170,7 @@ class Entry(object):
     is_builtin = 0
     is_cglobal = 0
     is_pyglobal = 0
+    is_declared_global = 0
     is_member = 0
     is_pyclass_attr = 0
     is_variable = 0
@@ -1866,6 +1868,7 @@ class LocalScope(Scope):
             warning(pos, "'%s' redeclared  ", 0)
         else:
             entry = self.global_scope().lookup_target(name)
+            entry.is_declared_global = 1
             self.entries[name] = entry
 
     def declare_nonlocal(self, name, pos):
@@ -2120,6 +2123,7 @@ class PyClassScope(ClassScope):
             warning(pos, "'%s' redeclared  ", 0)
         else:
             entry = self.global_scope().lookup_target(name)
+            entry.is_declared_global = 1
             self.entries[name] = entry
 
     def add_default_value(self, type):
@@ -165,6 +165,26 @@ class CmdLineParserTest(TestCase):
         self.check_default_global_options()
         self.check_default_options(options, ['working_path'])
 
+    def test_pxd_cache(self):
+        options, sources = parse_command_line([
+            '--pxd-cache', 'my_cache_dir',
+            'source.pyx'
+        ])
+        self.assertEqual(sources, ['source.pyx'])
+        self.assertEqual(options.pxd_cache, 'my_cache_dir')
+        self.check_default_global_options()
+        self.check_default_options(options, ['pxd_cache'])
+
+    def test_timing_report(self):
+        options, sources = parse_command_line([
+            '--timing-report', 'report.json',
+            'source.pyx'
+        ])
+        self.assertEqual(sources, ['source.pyx'])
+        self.assertEqual(options.timing_report, 'report.json')
+        self.check_default_global_options()
+        self.check_default_options(options, ['timing_report'])
+
     def test_short_o(self):
         options, sources = parse_command_line([
             '-o', 'my_output',
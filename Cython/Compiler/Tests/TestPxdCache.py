@@ -0,0 +1,118 @@
+import glob
+import os
+import shutil
+import sys
+import tempfile
+from unittest import TestCase
+
+try:
+    from StringIO import StringIO
+except ImportError:
+    from io import StringIO
+
+from .. import Main, Options, Parsing
+
+
+class TestPxdCache(TestCase):
+
+    def setUp(self):
+        self.temp_dir = tempfile.mkdtemp(
+            prefix='pxdcache-test',
+            dir='TEST_TMP' if os.path.isdir('TEST_TMP') else None)
+        self.src_dir = os.path.join(self.temp_dir, 'src')
+        self.cache_dir = os.path.join(self.temp_dir, 'cache')
+        os.mkdir(self.src_dir)
+        self.parsed = []
+        self._p_module = Parsing.p_module
+
+        def p_module(s, pxd, full_module_name, *args, **kwargs):
+            if pxd:
+                self.parsed.append(full_module_name)
+            return self._p_module(s, pxd, full_module_name, *args, **kwargs)
+        Parsing.p_module = p_module
+
+    def tearDown(self):
+        Parsing.p_module = self._p_module
+        shutil.rmtree(self.temp_dir)
+
+    def write_file(self, name, content):
+        with open(os.path.join(self.src_dir, name), 'w') as f:
+            f.write(content)
+
+    def cache_files(self):
+        return glob.glob(os.path.join(self.cache_dir, '*', '*.pickle'))
+
+    def find_module(self, module_name, **options):
+        options.setdefault('language_level', 3)
+        options = Options.CompilationOptions(
+            Options.default_options, include_path=[self.src_dir], pxd_cache=self.cache_dir, **options)
+        context = Main.Context.from_options(options)
+        return context.find_module(module_name)
+
+    def test_reuse_parse_tree(self):
+        self.write_file('decls.pxd', 'cdef int f(int x)\nctypedef double real\n')
+        scope = self.find_module('decls')
+        self.assertEqual(['decls'], self.parsed)
+        self.assertEqual(1, len(self.cache_files()))
+        self.assertTrue(scope.lookup('f'))
+
+        scope = self.find_module('decls')
+        self.assertEqual(['decls'], self.parsed)
+        self.assertEqual(1, len(self.cache_files()))
+        self.assertTrue(scope.lookup('f'))
+        self.assertTrue(scope.lookup('real'))
+        self.assertEqual(
+            os.path.join(self.src_dir, 'decls.pxd'),
+            scope.lookup('f').pos[0].filename)
+
+    def test_invalidation(self):
+        self.write_file('decls.pxd', 'cdef int f(int x)\n')
+        self.find_module('decls')
+        self.write_file('decls.pxd', 'cdef int g(int x)\n')
+        scope = self.find_module('decls')
+        self.assertEqual(['decls', 'decls'], self.parsed)
+        self.assertEqual(2, len(self.cache_files()))
+        self.assertTrue(scope.lookup('g'))
+
+        # The parser depends on the language level.
+        self.find_module('decls', language_level=2)
+        self.find_module('decls', language_level=2)
+        self.assertEqual(['decls', 'decls', 'decls'], self.parsed)
+        self.assertEqual(3, len(self.cache_files()))
+
+    def test_include_is_not_cached(self):
+        self.write_file('included.pxi', 'cdef int f(int x)\n')
+        self.write_file('decls.pxd', 'include "included.pxi"\n')
+        self.find_module('decls')
+        scope = self.find_module('decls')
+        self.assertEqual(['decls', 'decls'], self.parsed)
+        self.assertEqual([], self.cache_files())
+        self.assertTrue(scope.lookup('f'))
+
+    def test_broken_entry(self):
+        self.write_file('decls.pxd', 'cdef int f(int x)\n')
+        self.find_module('decls')
+        for path in self.cache_files():
+            with open(path, 'wb') as f:
+                f.write(b'broken')
+        scope = self.find_module('decls')
+        self.assertEqual(['decls', 'decls'], self.parsed)
+        self.assertTrue(scope.lookup('f'))
+
+    def test_shared_directory_is_not_used(self):
+        if not hasattr(os, 'getuid'):
+            return
+        self.write_file('decls.pxd', 'cdef int f(int x)\n')
+        os.mkdir(self.cache_dir)
+        os.chmod(self.cache_dir, 0o777)
+        stderr = sys.stderr
+        sys.stderr = StringIO()
+        try:
+            self.find_module('decls')
+            self.find_module('decls')
+            output = sys.stderr.getvalue()
+        finally:
+            sys.stderr = stderr
+        self.assertEqual(['decls', 'decls'], self.parsed)
+        self.assertEqual([], self.cache_files())
+        self.assertIn('Not using the .pxd cache', output)
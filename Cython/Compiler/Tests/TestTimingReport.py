@@ -0,0 +1,121 @@
+import json
+import os
+import shutil
+import tempfile
+from unittest import TestCase
+
+from .. import TimingReport
+from ..Scanning import StringSourceDescriptor
+
+
+class _CompilationSource(object):
+    source_desc = None
+    full_module_name = 'mod'
+
+
+class TestTimingReport(TestCase):
+
+    def run_phase(self, timer, source, phase_name, run=None, module_name=None):
+        return timer.run_phase(source, module_name, phase_name, run or (lambda phase, data: data), None, None)
+
+    def test_nested_pipelines(self):
+        timer = TimingReport.PhaseTimer()
+        module = _CompilationSource()
+        pxd = StringSourceDescriptor('decls', 'cdef int x')
+
+        def run_module_phase(phase, data):
+            self.run_phase(timer, pxd, 'parse_pxd', module_name='pkg.decls')
+            self.run_phase(timer, pxd, 'parse_pxd', module_name='pkg.decls')
+            return data
+
+        self.run_phase(timer, module, 'parse', run_module_phase)
+        self.run_phase(timer, module, 'parse')
+
+        report = timer.report
+        self.assertEqual(['mod'], list(report['modules']))
+        self.assertEqual(['pkg.decls'], list(report['pxds']))
+        self.assertEqual({}, report['utility_code'])
+        self.assertEqual(2, report['modules']['mod']['phases']['parse']['calls'])
+        self.assertEqual(2, report['pxds']['pkg.decls']['phases']['parse_pxd']['calls'])
+        for stats in report['modules']['mod'], report['pxds']['pkg.decls']:
+            self.assertGreaterEqual(stats['time'], 0.0)
+
+    def test_peak_memory_growth(self):
+        timer = TimingReport.PhaseTimer()
+        module = _CompilationSource()
+        pxd = StringSourceDescriptor('decls', 'cdef int x')
+        memory = [1000]
+
+        def allocate(size):
+            def run(phase, data):
+                memory[0] += size
+                return data
+            return run
+
+        def run_module_phase(phase, data):
+            memory[0] += 100
+            self.run_phase(timer, pxd, 'parse_pxd', allocate(30), module_name='decls')
+            return data
+
+        peak_memory = TimingReport.peak_memory
+        TimingReport.peak_memory = lambda: memory[0]
+        try:
+            self.run_phase(timer, module, 'parse', run_module_phase)
+            self.run_phase(timer, module, 'analyse', allocate(0))
+        finally:
+            TimingReport.peak_memory = peak_memory
+
+        phases = timer.report['modules']['mod']['phases']
+        self.assertEqual(100, phases['parse']['peak_memory_growth'])
+        self.assertEqual(0, phases['analyse']['peak_memory_growth'])
+        self.assertEqual(1130, phases['analyse']['process_peak_memory'])
+        self.assertEqual(100, timer.report['modules']['mod']['peak_memory_growth'])
+        self.assertEqual(30, timer.report['pxds']['decls']['peak_memory_growth'])
+
+    def test_merge_reports(self):
+        def report(name, seconds):
+            memory = {'peak_memory_growth': 10, 'process_peak_memory': int(seconds * 100)}
+            phase = dict(memory, time=seconds, calls=1)
+            return {
+                'modules': {name: dict(memory, time=seconds, phases={'parse': phase})},
+                'pxds': {},
+                'utility_code': {},
+            }
+
+        merged = TimingReport.merge_reports([report('a', 1.0), report('b', 2.0), report('a', 0.5)])
+        self.assertEqual({'a', 'b'}, set(merged['modules']))
+        self.assertEqual(1.5, merged['modules']['a']['time'])
+        self.assertEqual(2, merged['modules']['a']['phases']['parse']['calls'])
+        self.assertEqual(3, merged['phases']['parse']['calls'])
+        self.assertEqual(3.5, merged['total_time'])
+        self.assertEqual(20, merged['modules']['a']['peak_memory_growth'])
+        self.assertEqual(100, merged['modules']['a']['process_peak_memory'])
+        self.assertEqual(30, merged['phases']['parse']['peak_memory_growth'])
+        self.assertEqual(200, merged['phases']['parse']['process_peak_memory'])
+
+    def test_report_file(self):
+        temp_dir = tempfile.mkdtemp(
+            prefix='timingreport-test',
+            dir='TEST_TMP' if os.path.isdir('TEST_TMP') else None)
+        try:
+            report_file = os.path.join(temp_dir, 'report.json')
+            # A fragment of a worker process and one left behind by an earlier run.
+            self.run_phase(TimingReport.enable(), _CompilationSource(), 'parse')
+            worker_fragment = dict(TimingReport.get_timer().report, merge_pid=os.getpid())
+            stale_fragment = dict(worker_fragment, merge_pid=-1)
+            TimingReport._timer = None
+            for name, fragment in [('1.part', worker_fragment), ('2.part', stale_fragment)]:
+                with open('%s.%s' % (report_file, name), 'w') as f:
+                    json.dump(fragment, f)
+
+            for _ in range(2):
+                self.run_phase(TimingReport.enable(), _CompilationSource(), 'parse')
+                TimingReport.merge_report_file(report_file)
+            self.assertIsNone(TimingReport.get_timer())
+            self.assertEqual(['report.json', 'report.json.2.part'], sorted(os.listdir(temp_dir)))
+            with open(report_file) as f:
+                report = json.load(f)
+            # Reports of the same process accumulate.
+            self.assertEqual(3, report['modules']['mod']['phases']['parse']['calls'])
+        finally:
+            shutil.rmtree(temp_dir)
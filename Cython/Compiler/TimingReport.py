@@ -0,0 +1,235 @@
+#
+#   Per-module and per-phase compile time report
+#
+
+from __future__ import absolute_import
+
+import glob
+import json
+import os
+import sys
+from time import time
+
+try:
+    import resource
+except ImportError:
+    # not available on Windows
+    resource = None
+
+
+def peak_memory():
+    """
+    Return the peak resident memory of the process in bytes, or None if unknown.
+
+    This is the maximum over the whole lifetime of the process, so it never
+    decreases and includes whatever ran before the compiler.
+    """
+    if resource is None:
+        return None
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    # kilobytes everywhere except on macOS
+    return peak if sys.platform == 'darwin' else peak * 1024
+
+
+SECTIONS = ('modules', 'pxds', 'utility_code')
+
+
+def _new_stats():
+    return {'time': 0.0, 'peak_memory_growth': None, 'process_peak_memory': None}
+
+
+class PhaseTimer(object):
+    """
+    Collects the wall time and the memory use of each pipeline phase,
+    separately for each compiled module, .pxd file and Cython utility code.
+
+    Memory is reported in two ways: 'peak_memory_growth' is how far a phase
+    raised the peak resident memory of the process, and 'process_peak_memory'
+    is the (cumulative) peak of the process when the phase ended.  Phases that
+    stay below an earlier peak do not grow it, so the growth attributes the
+    memory use of the process to the phases that drove it up.
+
+    Pipelines of .pxd files and utility code run nested inside of a phase
+    of the module pipeline.  The time and memory growth of a phase do not
+    include those of the nested pipelines, so that the values of all phases
+    add up to the total compile time and peak memory growth.
+    """
+    def __init__(self):
+        self.report = dict((section, {}) for section in SECTIONS)
+        self._nested = [[0.0, 0]]
+
+    def run_phase(self, source, module_name, phase_name, run, phase, data):
+        self._nested.append([0.0, 0])
+        t = time()
+        memory = peak_memory()
+        try:
+            return run(phase, data)
+        finally:
+            elapsed = time() - t
+            end_memory = peak_memory()
+            growth = None if memory is None else end_memory - memory
+            nested_time, nested_growth = self._nested.pop()
+            self._nested[-1][0] += elapsed
+            if growth is not None:
+                self._nested[-1][1] += growth
+                growth -= nested_growth
+            self._add_phase(source, module_name, phase_name, elapsed - nested_time, growth, end_memory)
+
+    def _add_phase(self, source, module_name, phase_name, seconds, growth, memory):
+        if hasattr(source, 'source_desc'):
+            # CompilationSource
+            section, name = 'modules', source.full_module_name
+        elif hasattr(source, 'get_description'):
+            # .pxd pipelines only get the source descriptor
+            section, name = 'pxds', module_name or source.get_description()
+        else:
+            # parse tree of Cython utility code
+            section, name = 'utility_code', module_name or getattr(source, 'full_module_name', None) or '?'
+        section = self.report[section]
+        phase_stats = {'time': seconds, 'calls': 1, 'peak_memory_growth': growth, 'process_peak_memory': memory}
+        stats = section.get(name)
+        if stats is None:
+            stats = section[name] = dict(_new_stats(), phases={})
+        _merge_stats(stats, phase_stats)
+        target_phase = stats['phases'].get(phase_name)
+        if target_phase is None:
+            target_phase = stats['phases'][phase_name] = dict(_new_stats(), calls=0)
+        _merge_stats(target_phase, phase_stats)
+
+
+_timer = None
+
+
+def get_timer():
+    return _timer
+
+
+def enable(report_file=None):
+    """
+    Start recording.  Worker processes of cythonize() write what they recorded
+    to a fragment next to 'report_file' once, when they exit.
+    """
+    global _timer
+    if _timer is None:
+        _timer = PhaseTimer()
+        if report_file and _in_worker_process():
+            from multiprocessing.util import Finalize
+            Finalize(None, write_fragment, args=(report_file,), exitpriority=10)
+    return _timer
+
+
+def _combine(combine, a, b):
+    if a is None:
+        return b
+    if b is None:
+        return a
+    return combine(a, b)
+
+
+def _merge_stats(target, stats):
+    target['time'] += stats['time']
+    target['peak_memory_growth'] = _combine(
+        lambda a, b: a + b, target['peak_memory_growth'], stats['peak_memory_growth'])
+    target['process_peak_memory'] = _combine(
+        max, target['process_peak_memory'], stats['process_peak_memory'])
+    if 'calls' in target:
+        target['calls'] += stats['calls']
+
+
+def merge_reports(reports):
+    """
+    Combine the reports of several processes and add a summary of the
+    time spent in each phase over all modules.
+    """
+    result = dict((section, {}) for section in SECTIONS)
+    for report in reports:
+        for section in SECTIONS:
+            for name, stats in report.get(section, {}).items():
+                target = result[section].get(name)
+                if target is None:
+                    target = result[section][name] = dict(_new_stats(), phases={})
+                _merge_stats(target, stats)
+                for phase_name, phase_stats in stats['phases'].items():
+                    target_phase = target['phases'].setdefault(phase_name, dict(_new_stats(), calls=0))
+                    _merge_stats(target_phase, phase_stats)
+
+    phases = {}
+    for section in SECTIONS:
+        for stats in result[section].values():
+            for phase_name, phase_stats in stats['phases'].items():
+                _merge_stats(phases.setdefault(phase_name, dict(_new_stats(), calls=0)), phase_stats)
+    result['phases'] = phases
+    result['total_time'] = sum(stats['time'] for stats in phases.values())
+    return result
+
+
+def _in_worker_process():
+    import multiprocessing
+    return multiprocessing.current_process().name != 'MainProcess'
+
+
+def _merging_pid():
+    # The process that started the workers merges their fragments.
+    if _in_worker_process() and hasattr(os, 'getppid'):
+        return os.getppid()
+    return os.getpid()
+
+
+def _fragment_path(report_file):
+    return "%s.%d.part" % (report_file, os.getpid())
+
+
+def _write_json(path, data):
+    tmp_path = "%s.%d.tmp" % (path, os.getpid())
+    with open(tmp_path, 'w') as f:
+        json.dump(data, f, indent=1, sort_keys=True)
+    if os.path.exists(path) and sys.platform == 'win32':
+        os.remove(path)
+    os.rename(tmp_path, path)
+
+
+def write_fragment(report_file):
+    """
+    Write what this process recorded next to the report file.
+    Each worker process writes its own file, which merge_report_file()
+    in the parent process later collects.
+    """
+    if _timer is not None:
+        _write_json(_fragment_path(report_file), dict(_timer.report, merge_pid=_merging_pid()))
+
+
+# Reports written by the same process, e.g. by several cythonize() calls in a setup.py,
+# are extended instead of being overwritten.
+_run_id = "%d-%f" % (os.getpid(), time())
+
+
+def merge_report_file(report_file):
+    """
+    Collect the fragments of all processes into the JSON report file.
+    """
+    global _timer
+    reports = []
+    if _timer is not None:
+        reports.append(_timer.report)
+    _timer = None
+    try:
+        with open(report_file) as f:
+            report = json.load(f)
+        if report.get('run_id') == _run_id:
+            reports.append(report)
+    except (IOError, OSError, ValueError):
+        pass
+    for path in glob.glob(report_file + '.*.part'):
+        try:
+            with open(path) as f:
+                fragment = json.load(f)
+        except (IOError, OSError, ValueError):
+            continue
+        if fragment.get('merge_pid') != os.getpid():
+            # Left behind by another (e.g. crashed) run.
+            continue
+        reports.append(fragment)
+        os.remove(path)
+    report = merge_reports(reports)
+    report['run_id'] = _run_id
+    _write_json(report_file, report)
@@ -67,6 +67,18 @@ class MarkParallelAssignments(EnvTransform):
                 parallel_node.assignments[lhs.entry] = (pos, inplace_op)
                 parallel_node.assigned_nodes.append(lhs)
 
+        elif isinstance(lhs, ExprNodes.IndexNode) and self.parallel_block_stack:
+            # Items of C arrays and memoryviews may be reductions, see
+            # prange(reduction=...)
+            base = lhs.base
+            while isinstance(base, ExprNodes.IndexNode):
+                base = base.base
+            entry = base.is_name and self.current_env().lookup(base.name)
+            if entry:
+                for parallel_node in self.parallel_block_stack:
+                    parallel_node.item_assignments.setdefault(entry, []).append(
+                        (lhs.pos, inplace_op))
+
         elif isinstance(lhs, ExprNodes.SequenceNode):
             for i, arg in enumerate(lhs.args):
                 if not rhs or arg.is_starred:
@@ -210,7 +222,10 @@ class MarkParallelAssignments(EnvTransform):
             node.parent = None
 
         nested = False
-        if node.is_prange:
+        if node.is_task:
+            # tasks run on the threads of the enclosing parallel section
+            node.is_parallel = False
+        elif node.is_prange:
             if not node.parent:
                 node.is_parallel = True
             else:
@@ -227,7 +242,7 @@ class MarkParallelAssignments(EnvTransform):
         self.parallel_block_stack.append(node)
 
         nested = nested or len(self.parallel_block_stack) > 2
-        if not self.parallel_errors and nested and not node.is_prange:
+        if not self.parallel_errors and nested and not (node.is_prange or node.is_task):
             error(node.pos, "Only prange() may be nested")
             self.parallel_errors = True
 
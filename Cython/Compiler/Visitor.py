@@ -610,9 +610,11 @@ class MethodDispatcherTransform(EnvTransform):
             if not function.entry:
                 return node
             entry = function.entry
+            builtin_entry = self.current_env().builtin_scope().lookup_here(function.name)
             is_builtin = (
                 entry.is_builtin or
-                entry is self.current_env().builtin_scope().lookup_here(function.name))
+                # including the C overloads of a builtin, e.g. abs(double complex)
+                (builtin_entry is not None and entry in builtin_entry.all_alternatives()))
             if not is_builtin:
                 if function.cf_state and function.cf_state.is_single:
                     # we know the value of the variable
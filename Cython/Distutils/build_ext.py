@@ -1,4 +1,6 @@
+import os
 import sys
+import time
 
 if 'setuptools' in sys.modules:
     try:
@@ -11,15 +13,292 @@ else:
     from distutils.command.build_ext import build_ext as _build_ext
 
 
+def _timed_cythonize_one(args):
+    # Runs in the worker processes of the pipelined build.
+    import time
+    import traceback
+    from Cython.Build.Dependencies import cythonize_one
+    t = time.time()
+    try:
+        cythonize_one(*args)
+    except Exception:
+        return time.time() - t, traceback.format_exc()
+    return time.time() - t, None
+
+
 class new_build_ext(_build_ext, object):
+
+    user_options = _build_ext.user_options + [
+        ('cache=', None,
+         "directory for caching the generated C files and the compiled extension modules"),
+        ('pipeline', None,
+         "start the C compilation of each module as soon as it is cythonized, "
+         "running up to 'parallel' jobs at a time"),
+        ('job-timeout=', None,
+         "seconds to wait for the next job of a pipelined build to finish "
+         "(default: 3600)"),
+    ]
+
+    boolean_options = _build_ext.boolean_options + ['pipeline']
+
+    build_times_file = 'cython_build_times.json'
+
+    def initialize_options(self):
+        super(new_build_ext, self).initialize_options()
+        self.cache = None
+        self.pipeline = False
+        self.job_timeout = None
+        self.cythonize_jobs = None
+
     def finalize_options(self):
+        self.job_timeout = float(self.job_timeout) if self.job_timeout else 3600
         if self.distribution.ext_modules:
             nthreads = getattr(self, 'parallel', None)  # -j option in Py3.5+
             nthreads = int(nthreads) if nthreads else None
-            from Cython.Build.Dependencies import cythonize
-            self.distribution.ext_modules[:] = cythonize(
-                self.distribution.ext_modules, nthreads=nthreads, force=self.force)
+            if self.pipeline:
+                from Cython.Build.Dependencies import create_cythonize_jobs
+                module_list, self.cythonize_jobs, _, self.cache = create_cythonize_jobs(
+                    self.distribution.ext_modules, force=self.force, cache=self.cache)
+                self.distribution.ext_modules[:] = module_list
+            else:
+                from Cython.Build.Dependencies import cythonize
+                self.distribution.ext_modules[:] = cythonize(
+                    self.distribution.ext_modules, nthreads=nthreads, force=self.force,
+                    cache=self.cache)
         super(new_build_ext, self).finalize_options()
 
+    def build_extensions(self):
+        if self.cythonize_jobs is None:
+            return super(new_build_ext, self).build_extensions()
+        self.check_extensions_list(self.extensions)
+        self.build_pipelined(self.extensions, self.cythonize_jobs)
+        if self.cache:
+            from Cython.Build.Dependencies import cleanup_cache
+            cleanup_cache(self.cache, 1024 * 1024 * 100)
+
+    def _timed_build_extension(self, ext):
+        t = time.time()
+        try:
+            self.build_extension(ext)
+        except Exception as e:
+            return time.time() - t, e
+        return time.time() - t, None
+
+    def build_pipelined(self, extensions, cythonize_jobs):
+        """
+        Cythonize the modules in a process pool and start the C compilation
+        of each extension module in a thread as soon as all of its C files
+        are generated.  At most 'parallel' jobs of either kind run at the same
+        time, those with the longest way to a compiled module first, going by
+        the times of earlier builds.  Modules without earlier times go first.
+        """
+        import collections
+        import json
+        import multiprocessing
+        from multiprocessing.pool import ThreadPool
+        from distutils import log
+        from distutils.errors import DistutilsError
+        from Cython.Build.Dependencies import _init_multiprocessing_helper
+        from Cython.Compiler.Errors import CompileError
+        try:
+            import queue
+        except ImportError:
+            import Queue as queue
+
+        parallel = getattr(self, 'parallel', None)
+        nthreads = int(parallel) if parallel else multiprocessing.cpu_count()
+        times_file = os.path.join(self.build_temp, self.build_times_file)
+        try:
+            with open(times_file) as f:
+                build_times = json.load(f)
+        except (IOError, OSError, ValueError):
+            build_times = {}
+
+        extensions_by_name = dict((ext.name, ext) for ext in extensions)
+        extensions_by_source = collections.defaultdict(list)
+        for ext in extensions:
+            for source in ext.sources:
+                extensions_by_source[source].append(ext.name)
+        missing_sources = collections.defaultdict(int)
+        for job in cythonize_jobs:
+            for name in extensions_by_source[job[1]]:
+                missing_sources[name] += 1
+
+        def compile_time(name):
+            return build_times[name][1] if name in build_times else float('inf')
+
+        def remaining_time(job):
+            return max([
+                build_times[name][0] + build_times[name][1] if name in build_times else float('inf')
+                for name in extensions_by_source[job[1]]] or [0])
+
+        pending_jobs = sorted(cythonize_jobs, key=remaining_time, reverse=True)
+        ready = [ext.name for ext in extensions if not missing_sources[ext.name]]
+        cythonize_times = collections.defaultdict(float)
+        compile_times = {}
+        results = queue.Queue()
+        failures = []
+        running = 0
+
+        def callbacks(kind, item):
+            # Jobs report their own errors, but a job can also fail outside of
+            # its wrapper, e.g. if its result cannot be pickled.
+            kwargs = dict(callback=lambda result: results.put((kind, item, result)))
+            if sys.version_info[0] >= 3:
+                kwargs['error_callback'] = lambda exc: results.put((kind, item, (0, exc)))
+            return kwargs
+
+        nprocesses = min(nthreads, len(pending_jobs)) or 1
+        if sys.version_info >= (3, 7):
+            # Unlike multiprocessing.Pool, which silently replaces a worker process
+            # that died (e.g. killed for running out of memory) and loses its job,
+            # the executor fails the jobs with a BrokenProcessPool error.
+            from concurrent.futures import ProcessPoolExecutor
+            process_pool = ProcessPoolExecutor(nprocesses, initializer=_init_multiprocessing_helper)
+            futures = []
+
+            def report_result(job, future):
+                if not future.cancelled():
+                    error = future.exception()
+                    results.put(('cythonize', job, (0, error) if error is not None else future.result()))
+
+            def start_cythonize(job):
+                future = process_pool.submit(_timed_cythonize_one, job)
+                future.add_done_callback(lambda future: report_result(job, future))
+                futures.append(future)
+
+            def stop_processes():
+                for future in futures:
+                    future.cancel()
+                if hasattr(process_pool, 'terminate_workers'):  # Py3.14+
+                    process_pool.terminate_workers()
+                else:
+                    for process in list((process_pool._processes or {}).values()):
+                        process.terminate()
+
+            join_processes = process_pool.shutdown
+        else:
+            process_pool = multiprocessing.Pool(nprocesses, initializer=_init_multiprocessing_helper)
+
+            def start_cythonize(job):
+                process_pool.apply_async(_timed_cythonize_one, (job,), **callbacks('cythonize', job))
+
+            stop_processes = process_pool.terminate
+
+            def join_processes():
+                process_pool.close()
+                process_pool.join()
+
+        start = time.time()
+        thread_pool = ThreadPool(nthreads)
+        try:
+            while running or (not failures and (pending_jobs or ready)):
+                while running < nthreads and not failures and (pending_jobs or ready):
+                    ready.sort(key=compile_time)
+                    if ready and (not pending_jobs or
+                                  compile_time(ready[-1]) >= remaining_time(pending_jobs[0])):
+                        name = ready.pop()
+                        thread_pool.apply_async(
+                            self._timed_build_extension, (extensions_by_name[name],),
+                            **callbacks('compile', name))
+                    else:
+                        start_cythonize(pending_jobs.pop(0))
+                    running += 1
+                try:
+                    kind, item, (elapsed, error) = results.get(True, self.job_timeout)
+                except queue.Empty:
+                    stop_processes()
+                    raise DistutilsError(
+                        "no build job finished within %d seconds" % self.job_timeout)
+                running -= 1
+                if error is not None:
+                    failures.append((kind, item, error))
+                elif kind == 'cythonize':
+                    for name in extensions_by_source[item[1]]:
+                        cythonize_times[name] += elapsed
+                        missing_sources[name] -= 1
+                        if not missing_sources[name]:
+                            ready.append(name)
+                else:
+                    compile_times[item] = elapsed
+        except KeyboardInterrupt:
+            stop_processes()
+            raise
+        finally:
+            thread_pool.close()
+            join_processes()
+            thread_pool.join()
+
+        for kind, item, error in failures:
+            if kind == 'cythonize' and not isinstance(error, BaseException):
+                sys.stderr.write(error)
+                raise CompileError(None, item[0])
+            raise error
+
+        for name in compile_times:
+            if name in cythonize_times or name not in build_times:
+                build_times[name] = [
+                    cythonize_times.get(name, build_times.get(name, [0])[0]), compile_times[name]]
+        self.mkpath(self.build_temp)
+        with open(times_file, 'w') as f:
+            json.dump(build_times, f, indent=1, sort_keys=True)
+
+        log.info("build times in seconds (Cython, C), %.2f in total:", time.time() - start)
+        for name in sorted(compile_times, key=lambda name: -cythonize_times[name] - compile_times[name]):
+            log.info("%8.2f %8.2f  %s", cythonize_times[name], compile_times[name], name)
+
+    def get_ext_fingerprint(self, ext):
+        """
+        Return a fingerprint of everything that goes into building the
+        extension module: the sources and depends, the build settings and
+        the compiler.  Headers that are not listed in 'depends' are not
+        taken into account.
+        """
+        import hashlib
+        from Cython import __version__
+        m = hashlib.sha1(__version__.encode('UTF-8'))
+        for value in [
+                sys.version, sys.platform, self.get_ext_filename(ext.name),
+                self.compiler.__class__.__name__,
+                getattr(self.compiler, 'compiler_so', None),
+                getattr(self.compiler, 'linker_so', None),
+                self.include_dirs, self.define, self.undef, self.libraries,
+                self.library_dirs, self.rpath, self.link_objects, self.debug,
+                ext.define_macros, ext.undef_macros, ext.include_dirs,
+                ext.libraries, ext.library_dirs, ext.runtime_library_dirs,
+                ext.extra_objects, ext.extra_compile_args, ext.extra_link_args,
+                ext.export_symbols, ext.language]:
+            m.update(repr(value).encode('UTF-8'))
+        for filename in list(ext.sources) + list(ext.depends or ()):
+            with open(filename, 'rb') as f:
+                m.update(f.read())
+        return m.hexdigest()
+
+    def build_extension(self, ext):
+        if not self.cache or self.force:
+            return super(new_build_ext, self).build_extension(ext)
+        import shutil
+        from Cython.Build.Dependencies import (
+            cache_entry_path, publish_cache_entry, CacheEntryLock)
+        if self.cache is True:
+            from Cython.Utils import get_cython_cache_dir
+            self.cache = os.path.join(get_cython_cache_dir(), 'compiler')
+        ext_path = self.get_ext_fullpath(ext.name)
+        cache_file = cache_entry_path(
+            self.cache, os.path.basename(ext_path), self.get_ext_fingerprint(ext))
+        lock = CacheEntryLock(cache_file)
+        if lock.acquire([cache_file]):
+            try:
+                super(new_build_ext, self).build_extension(ext)
+                publish_cache_entry(
+                    self.cache, cache_file, lambda path: shutil.copyfile(ext_path, path))
+            finally:
+                lock.release()
+        else:
+            self.announce("copying cached extension module for '%s'" % ext.name, level=2)
+            os.utime(cache_file, None)
+            self.mkpath(os.path.dirname(ext_path))
+            shutil.copyfile(cache_file, ext_path)
+
 # This will become new_build_ext in the future.
 from .old_build_ext import old_build_ext as build_ext
@@ -0,0 +1,84 @@
+# C++17 std::string_view, a non-owning view of a char sequence.
+#
+# Coercing a bytes object (or a unicode string with c_string_encoding set) to
+# a string_view does not copy the data.  The view borrows the buffer of the
+# Python object and is only valid as long as that object is alive, just like
+# a char* obtained from it.
+
+from libcpp.string cimport string
+
+
+cdef extern from "<string_view>" namespace "std" nogil:
+
+    cdef cppclass string_view:
+        ctypedef char value_type
+        ctypedef size_t size_type
+
+        cppclass iterator:
+            iterator()
+            const char& operator*()
+            iterator(iterator &)
+            iterator operator++()
+            iterator operator--()
+            bint operator==(iterator)
+            bint operator!=(iterator)
+        cppclass const_iterator(iterator):
+            pass
+
+        string_view()
+        string_view(const char *)
+        string_view(const char *, size_t)
+        string_view(const string_view&)
+
+        const_iterator begin()
+        const_iterator end()
+
+        const char* data()
+        size_t size()
+        size_t length()
+        size_t max_size()
+        bint empty()
+
+        const char& at(size_t) except +
+        const char& operator[](size_t)
+        const char& front()
+        const char& back()
+
+        void remove_prefix(size_t)
+        void remove_suffix(size_t)
+
+        size_t copy(char *, size_t, size_t) except +
+        string_view substr(size_t, size_t) except +
+        string_view substr(size_t) except +
+        string_view substr()
+
+        int compare(string_view)
+
+        size_t find(string_view, size_t)
+        size_t find(string_view)
+        size_t find(char, size_t)
+        size_t find(char)
+        size_t rfind(string_view, size_t)
+        size_t rfind(string_view)
+        size_t rfind(char, size_t)
+        size_t rfind(char)
+        size_t find_first_of(string_view, size_t)
+        size_t find_first_of(string_view)
+        size_t find_last_of(string_view, size_t)
+        size_t find_last_of(string_view)
+        size_t find_first_not_of(string_view, size_t)
+        size_t find_first_not_of(string_view)
+        size_t find_last_not_of(string_view, size_t)
+        size_t find_last_not_of(string_view)
+
+        bint operator==(string_view)
+        bint operator!=(string_view)
+        bint operator<(string_view)
+        bint operator>(string_view)
+        bint operator<=(string_view)
+        bint operator>=(string_view)
+
+    size_t npos "std::string_view::npos"
+
+    # copies the viewed characters into a new std::string
+    string to_string "std::string"(string_view) except +
@@ -0,0 +1,79 @@
+"""
+Control the sampling profiler of modules compiled with the
+``profile=sampling`` directive.
+
+The sampler lives in the shared Cython runtime module of each Cython
+version that was used to compile the imported extension modules.  It
+records the call stacks of Cython functions (including ``nogil`` code)
+at regular intervals of consumed CPU time and reports them as
+"folded stacks", the input format of flame graph tools::
+
+    from Cython import Sampling
+
+    with Sampling.profile("out.folded"):
+        run_workload()
+
+Only POSIX platforms provide the SIGPROF timer that drives the sampler.
+"""
+
+from __future__ import absolute_import
+
+import sys
+from contextlib import contextmanager
+
+
+def _runtimes():
+    """Find the shared runtime modules that provide a sampler.
+    """
+    return [module for name, module in list(sys.modules.items())
+            if name.startswith('_cython_') and hasattr(module, 'sampling_start')]
+
+
+def start(interval=0.001):
+    """Start sampling every 'interval' seconds of CPU time.
+    """
+    runtimes = _runtimes()
+    if not runtimes:
+        raise RuntimeError("No module compiled with 'profile=sampling' was imported")
+    for runtime in runtimes:
+        runtime.sampling_start(interval)
+
+
+def stop():
+    for runtime in _runtimes():
+        runtime.sampling_stop()
+
+
+def stacks(clear=False):
+    """Return a dict that maps folded stacks to their sample counts.
+    Samples that were lost, e.g. because the stack table overflowed,
+    are counted under the key "[dropped]".
+    """
+    result = {}
+    for runtime in _runtimes():
+        for stack, count in runtime.sampling_stacks(clear).items():
+            result[stack] = result.get(stack, 0) + count
+    return result
+
+
+def write_folded(path, clear=False):
+    """Write the recorded stacks in folded format, one "stack count" line each.
+    """
+    with open(path, 'w') as f:
+        for stack, count in sorted(stacks(clear).items()):
+            if stack != '[dropped]':
+                f.write("%s %d\n" % (stack, count))
+
+
+@contextmanager
+def profile(path=None, interval=0.001):
+    """Sample the code in the 'with' block and optionally write the folded stacks to 'path'.
+    """
+    stacks(clear=True)
+    start(interval)
+    try:
+        yield
+    finally:
+        stop()
+        if path is not None:
+            write_folded(path)
@@ -108,7 +108,7 @@ class _Optimization(object):
 cclass = ccall = cfunc = _EmptyDecoratorAndManager()
 
 returns = wraparound = boundscheck = initializedcheck = nonecheck = \
-    embedsignature = cdivision = cdivision_warnings = \
+    embedsignature = cdivision = cdivision_warnings = complex_fastmath = \
     always_allows_keywords = profile = linetrace = infer_types = \
     unraisable_tracebacks = freelist = \
         lambda _: _EmptyDecoratorAndManager()
@@ -490,12 +490,12 @@ class CythonDotParallel(object):
     The cython.parallel module.
     """
 
-    __all__ = ['parallel', 'prange', 'threadid']
+    __all__ = ['parallel', 'prange', 'threadid', 'task', 'taskwait']
 
     def parallel(self, num_threads=None):
         return nogil
 
-    def prange(self, start=0, stop=None, step=1, nogil=False, schedule=None, chunksize=None, num_threads=None):
+    def prange(self, start=0, stop=None, step=1, nogil=False, schedule=None, chunksize=None, num_threads=None, backend=None, reduction=None):
         if stop is None:
             stop = start
             start = 0
@@ -504,6 +504,12 @@ class CythonDotParallel(object):
     def threadid(self):
         return 0
 
+    def task(self):
+        return nogil
+
+    def taskwait(self):
+        pass
+
     # def threadsavailable(self):
         # return 1
 
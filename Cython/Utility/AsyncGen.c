@@ -33,13 +33,27 @@ static PyObject *__Pyx_async_gen_athrow_close(PyObject *o, PyObject *args);
 
 static PyObject *__Pyx__PyAsyncGenValueWrapperNew(PyObject *val);
 
+#if __Pyx_Coroutine_USE_FREELIST
+static __pyx_PyAsyncGenObject *__Pyx_AsyncGen_freelist[__Pyx_Coroutine_MAXFREELIST];
+static int __Pyx_AsyncGen_freelist_free = 0;
+#endif
+
 
 static __pyx_CoroutineObject *__Pyx_AsyncGen_New(
             __pyx_coroutine_body_t body, PyObject *code, PyObject *closure,
             PyObject *name, PyObject *qualname, PyObject *module_name) {
-    __pyx_PyAsyncGenObject *gen = PyObject_GC_New(__pyx_PyAsyncGenObject, __pyx_AsyncGenType);
-    if (unlikely(!gen))
-        return NULL;
+    __pyx_PyAsyncGenObject *gen;
+#if __Pyx_Coroutine_USE_FREELIST
+    if (likely(__Pyx_AsyncGen_freelist_free)) {
+        gen = __Pyx_AsyncGen_freelist[--__Pyx_AsyncGen_freelist_free];
+        (void) PyObject_INIT((PyObject*) gen, __pyx_AsyncGenType);
+    } else
+#endif
+    {
+        gen = PyObject_GC_New(__pyx_PyAsyncGenObject, __pyx_AsyncGenType);
+        if (unlikely(!gen))
+            return NULL;
+    }
     gen->ag_finalizer = NULL;
     gen->ag_closed = 0;
     gen->ag_hooks_inited = 0;
@@ -456,6 +470,13 @@ __Pyx_PyAsyncGen_ClearFreeLists(void)
         PyObject_GC_Del(o);
     }
 
+#if __Pyx_Coroutine_USE_FREELIST
+    ret += __Pyx_AsyncGen_freelist_free;
+    while (__Pyx_AsyncGen_freelist_free) {
+        PyObject_GC_Del(__Pyx_AsyncGen_freelist[--__Pyx_AsyncGen_freelist_free]);
+    }
+#endif
+
     return ret;
 }
 
@@ -289,3 +289,37 @@ static {{type}} __Pyx_PyComplex_As_{{type_name}}(PyObject* o) {
         }
     #endif
 #endif
+
+
+/////////////// FastArithmetic.proto ///////////////
+
+// Used by the 'complex_fastmath' directive: the plain textbook formulas, without
+// the checks for infinite, NaN and zero operands and without rescaling the divisor.
+// They compile to a fixed sequence of multiplications and additions that the C
+// compiler can inline and vectorise, also in the C99 and C++ modes, where the
+// native operators call out to the IEEE conforming __muldc3() and __divdc3().
+
+static CYTHON_INLINE {{type}} __Pyx_c_prod_fast{{func_suffix}}({{type}}, {{type}});
+static CYTHON_INLINE {{type}} __Pyx_c_quot_fast{{func_suffix}}({{type}}, {{type}});
+static CYTHON_INLINE {{real_type}} __Pyx_c_abs_fast{{func_suffix}}({{type}});
+
+/////////////// FastArithmetic ///////////////
+
+static CYTHON_INLINE {{type}} __Pyx_c_prod_fast{{func_suffix}}({{type}} a, {{type}} b) {
+    {{real_type}} ar = __Pyx_CREAL(a), ai = __Pyx_CIMAG(a);
+    {{real_type}} br = __Pyx_CREAL(b), bi = __Pyx_CIMAG(b);
+    return {{type_name}}_from_parts(ar * br - ai * bi, ar * bi + ai * br);
+}
+
+static CYTHON_INLINE {{type}} __Pyx_c_quot_fast{{func_suffix}}({{type}} a, {{type}} b) {
+    {{real_type}} ar = __Pyx_CREAL(a), ai = __Pyx_CIMAG(a);
+    {{real_type}} br = __Pyx_CREAL(b), bi = __Pyx_CIMAG(b);
+    {{real_type}} inv_denom = ({{real_type}})(1.0) / (br * br + bi * bi);
+    return {{type_name}}_from_parts(
+        (ar * br + ai * bi) * inv_denom, (ai * br - ar * bi) * inv_denom);
+}
+
+static CYTHON_INLINE {{real_type}} __Pyx_c_abs_fast{{func_suffix}}({{type}} z) {
+    {{real_type}} zr = __Pyx_CREAL(z), zi = __Pyx_CIMAG(z);
+    return sqrt{{m}}(zr * zr + zi * zi);
+}
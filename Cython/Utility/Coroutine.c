@@ -57,6 +57,9 @@ static CYTHON_INLINE PyObject* __Pyx_Generator_Yield_From(__pyx_CoroutineObject
 
 //////////////////// CoroutineYieldFrom.proto ////////////////////
 
+// Returns the value to yield while 'gen' delegates to 'source' (gen->yieldfrom is set),
+// the result of 'source' if it completed without suspending (gen->yieldfrom is NULL),
+// or NULL on errors and after completion through StopIteration.
 static CYTHON_INLINE PyObject* __Pyx_Coroutine_Yield_From(__pyx_CoroutineObject *gen, PyObject *source);
 
 //////////////////// CoroutineYieldFrom ////////////////////
@@ -83,6 +86,27 @@ static PyObject* __Pyx__Coroutine_Yield_From_Generic(__pyx_CoroutineObject *gen,
     return NULL;
 }
 
+// Runs a Cython coroutine that was not started yet directly until it suspends or completes.
+// Awaiting a coroutine that completes without suspending thus avoids the delegation
+// through __Pyx_Coroutine_Send() and passes its result back without raising StopIteration.
+static PyObject* __Pyx__Coroutine_Await_Eager(__pyx_CoroutineObject *gen, __pyx_CoroutineObject *source) {
+    PyObject *retval = __Pyx_Coroutine_SendEx(source, Py_None, 0);
+    if (likely(retval)) {
+        // suspended, continue by delegation
+        Py_INCREF((PyObject*) source);
+        gen->yieldfrom = (PyObject*) source;
+        return retval;
+    }
+    if (unlikely(source->resume_label != -1)) {
+        return NULL;
+    }
+    // completed: fetch the result from StopIteration or pass on the exception
+    if (unlikely(__Pyx_PyGen__FetchStopIterationValue(__Pyx_PyThreadState_Current, &retval) < 0)) {
+        return NULL;
+    }
+    return retval;
+}
+
 static CYTHON_INLINE PyObject* __Pyx_Coroutine_Yield_From(__pyx_CoroutineObject *gen, PyObject *source) {
     PyObject *retval;
     if (__Pyx_Coroutine_Check(source)) {
@@ -92,6 +116,10 @@ static CYTHON_INLINE PyObject* __Pyx_Coroutine_Yield_From(__pyx_CoroutineObject
                 "coroutine is being awaited already");
             return NULL;
         }
+        if (likely(((__pyx_CoroutineObject*)source)->resume_label == 0) &&
+                likely(!((__pyx_CoroutineObject*)source)->is_running)) {
+            return __Pyx__Coroutine_Await_Eager(gen, (__pyx_CoroutineObject*)source);
+        }
         retval = __Pyx_Generator_Next(source);
 #ifdef __Pyx_AsyncGen_USED
     // inlined "__pyx_PyAsyncGenASend" handling to avoid the series of generic calls
@@ -409,6 +437,7 @@ static __pyx_CoroutineObject *__Pyx__Coroutine_NewInit(
 
 static CYTHON_INLINE void __Pyx_Coroutine_ExceptionClear(__Pyx_ExcInfoStruct *self);
 static int __Pyx_Coroutine_clear(PyObject *self); /*proto*/
+static PyObject *__Pyx_Coroutine_SendEx(__pyx_CoroutineObject *self, PyObject *value, int closing); /*proto*/
 static PyObject *__Pyx_Coroutine_Send(PyObject *self, PyObject *value); /*proto*/
 static PyObject *__Pyx_Coroutine_Close(PyObject *self); /*proto*/
 static PyObject *__Pyx_Coroutine_Throw(PyObject *gen, PyObject *args); /*proto*/
@@ -438,6 +467,36 @@ static PyObject *__Pyx_Coroutine_Throw(PyObject *gen, PyObject *args); /*proto*/
 static int __Pyx_PyGen__FetchStopIterationValue(PyThreadState *tstate, PyObject **pvalue); /*proto*/
 static CYTHON_INLINE void __Pyx_Coroutine_ResetFrameBackpointer(__Pyx_ExcInfoStruct *exc_state); /*proto*/
 
+// Freelists for short-lived generator, coroutine and async generator objects.
+// Generators and coroutines share their object size and thus their freelist.
+#ifndef __Pyx_Coroutine_MAXFREELIST
+#define __Pyx_Coroutine_MAXFREELIST 80
+#endif
+
+#if CYTHON_COMPILING_IN_CPYTHON && __Pyx_Coroutine_MAXFREELIST > 0
+#define __Pyx_Coroutine_USE_FREELIST 1
+static __pyx_CoroutineObject *__Pyx_Coroutine_freelist[__Pyx_Coroutine_MAXFREELIST];
+static int __Pyx_Coroutine_freelist_free = 0;
+// The GC header remembers that tp_finalize was called, so only objects that were not
+// finalized can be reused.  Otherwise, their next life would not be finalized.
+#if PY_VERSION_HEX >= 0x030900B1
+#define __Pyx_Coroutine_CanReuse(obj)  (!PyObject_GC_IsFinalized(obj))
+#elif CYTHON_USE_TP_FINALIZE
+#define __Pyx_Coroutine_CanReuse(obj)  (!_PyGC_FINALIZED(obj))
+#else
+#define __Pyx_Coroutine_CanReuse(obj)  (1)
+#endif
+#else
+#define __Pyx_Coroutine_USE_FREELIST 0
+#endif
+
+static CYTHON_UNUSED void __Pyx_Coroutine_ClearFreeList(void); /*proto*/
+
+
+//////////////////// CoroutineBase.cleanup ////////////////////
+
+__Pyx_Coroutine_ClearFreeList();
+
 
 //////////////////// Coroutine.proto ////////////////////
 
@@ -1184,9 +1243,34 @@ static void __Pyx_Coroutine_dealloc(PyObject *self) {
     }
 #endif
     __Pyx_Coroutine_clear(self);
+#if __Pyx_Coroutine_USE_FREELIST
+    if (likely(__Pyx_Coroutine_CanReuse(self))) {
+#ifdef __Pyx_AsyncGen_USED
+        if (__Pyx_AsyncGen_CheckExact(self)) {
+            if (likely(__Pyx_AsyncGen_freelist_free < __Pyx_Coroutine_MAXFREELIST)) {
+                __Pyx_AsyncGen_freelist[__Pyx_AsyncGen_freelist_free++] = (__pyx_PyAsyncGenObject*) self;
+                return;
+            }
+        } else
+#endif
+        if (likely((__Pyx_Coroutine_freelist_free < __Pyx_Coroutine_MAXFREELIST) &
+                   (Py_TYPE(self)->tp_basicsize == sizeof(__pyx_CoroutineObject)))) {
+            __Pyx_Coroutine_freelist[__Pyx_Coroutine_freelist_free++] = gen;
+            return;
+        }
+    }
+#endif
     PyObject_GC_Del(gen);
 }
 
+static void __Pyx_Coroutine_ClearFreeList(void) {
+#if __Pyx_Coroutine_USE_FREELIST
+    while (__Pyx_Coroutine_freelist_free) {
+        PyObject_GC_Del(__Pyx_Coroutine_freelist[--__Pyx_Coroutine_freelist_free]);
+    }
+#endif
+}
+
 static void __Pyx_Coroutine_del(PyObject *self) {
     PyObject *error_type, *error_value, *error_traceback;
     __pyx_CoroutineObject *gen = (__pyx_CoroutineObject *) self;
@@ -1397,9 +1481,18 @@ __Pyx_Coroutine_get_frame(__pyx_CoroutineObject *self, CYTHON_UNUSED void *conte
 static __pyx_CoroutineObject *__Pyx__Coroutine_New(
             PyTypeObject* type, __pyx_coroutine_body_t body, PyObject *code, PyObject *closure,
             PyObject *name, PyObject *qualname, PyObject *module_name) {
-    __pyx_CoroutineObject *gen = PyObject_GC_New(__pyx_CoroutineObject, type);
-    if (unlikely(!gen))
-        return NULL;
+    __pyx_CoroutineObject *gen;
+#if __Pyx_Coroutine_USE_FREELIST
+    if (likely((__Pyx_Coroutine_freelist_free > 0) & (type->tp_basicsize == sizeof(__pyx_CoroutineObject)))) {
+        gen = __Pyx_Coroutine_freelist[--__Pyx_Coroutine_freelist_free];
+        (void) PyObject_INIT((PyObject*) gen, type);
+    } else
+#endif
+    {
+        gen = PyObject_GC_New(__pyx_CoroutineObject, type);
+        if (unlikely(!gen))
+            return NULL;
+    }
     return __Pyx__Coroutine_NewInit(gen, body, code, closure, name, qualname, module_name);
 }
 
@@ -40,10 +40,50 @@ cdef inline object {{cname.replace("PyObject", py_type, 1)}}(const string& s):
 cdef extern from *:
     cdef cppclass vector "std::vector" [T]:
         void push_back(T&) except +
+        void reserve(size_t) except +
+{{if buffer_kind}}
+        void resize(size_t) except +
+        T* data()
+{{endif}}
+    Py_ssize_t __Pyx_CppLengthHint(object)
+{{if buffer_kind}}
+
+    int __Pyx_CppBufferFormatMatches(const char *format, char kind, size_t itemsize)
+
+cdef extern from "Python.h":
+    int PyObject_CheckBuffer(object)
+    int PyObject_GetBuffer(object, Py_buffer *, int)
+    void PyBuffer_Release(Py_buffer *)
+    void PyErr_Clear()
+    int PyBuffer_IsContiguous(Py_buffer *, char)
+    enum: PyBUF_RECORDS_RO
+
+cdef extern from "<string.h>":
+    void *memcpy(void *dest, const void *src, size_t n)
+{{endif}}
 
 @cname("{{cname}}")
 cdef vector[X] {{cname}}(object o) except *:
     cdef vector[X] v
+{{if buffer_kind}}
+    cdef Py_buffer view
+    if PyObject_CheckBuffer(o):
+        # Copy one-dimensional buffers of the same item type in one go.
+        if PyObject_GetBuffer(o, &view, PyBUF_RECORDS_RO) == -1:
+            # The exporter does not provide a format or strides, convert item by item.
+            PyErr_Clear()
+        else:
+            try:
+                if (view.ndim == 1 and PyBuffer_IsContiguous(&view, b'C') and
+                        __Pyx_CppBufferFormatMatches(view.format, b'{{buffer_kind}}', sizeof(X))):
+                    v.resize(view.shape[0])
+                    if view.len:
+                        memcpy(v.data(), view.buf, view.len)
+                    return v
+            finally:
+                PyBuffer_Release(&view)
+{{endif}}
+    v.reserve(__Pyx_CppLengthHint(o))
     for item in o:
         v.push_back(<X>item)
     return v
@@ -55,9 +95,33 @@ cdef extern from *:
     cdef cppclass vector "const std::vector" [T]:
         size_t size()
         T& operator[](size_t)
+{{if to_py_type != 'list'}}
+        const T* data()
+
+    int PY_MAJOR_VERSION
+    char __Pyx_CppArrayTypecode(char kind, size_t itemsize)
+    object __Pyx_CppReadOnlyBuffer(const char *data, Py_ssize_t size)
+{{endif}}
 
 @cname("{{cname}}")
 cdef object {{cname}}(vector[X]& v):
+{{if to_py_type != 'list'}}
+    # Copy the items into an array.array in one go, if there is a matching typecode.
+    cdef char typecode = __Pyx_CppArrayTypecode(b'{{buffer_kind}}', sizeof(X))
+    if typecode:
+        from array import array
+        if PY_MAJOR_VERSION >= 3:
+            result = array(chr(typecode))
+            if v.size():
+                result.frombytes(__Pyx_CppReadOnlyBuffer(<const char*> v.data(), v.size() * sizeof(X)))
+        else:
+            result = array(chr(typecode), __Pyx_CppReadOnlyBuffer(<const char*> v.data(), v.size() * sizeof(X)))
+{{if to_py_type == 'memoryview'}}
+        return memoryview(result)
+{{else}}
+        return result
+{{endif}}
+{{endif}}
     return [v[i] for i in range(v.size())]
 
 
@@ -103,10 +167,17 @@ cdef object {{cname}}(const cpp_list[X]& v):
 cdef extern from *:
     cdef cppclass set "std::{{maybe_unordered}}set" [T]:
         void insert(T&) except +
+{{if maybe_unordered}}
+        void reserve(size_t) except +
+    Py_ssize_t __Pyx_CppLengthHint(object)
+{{endif}}
 
 @cname("{{cname}}")
 cdef set[X] {{cname}}(object o) except *:
     cdef set[X] s
+{{if maybe_unordered}}
+    s.reserve(__Pyx_CppLengthHint(o))
+{{endif}}
     for item in o:
         s.insert(<X>item)
     return s
@@ -166,6 +237,9 @@ cdef extern from *:
         pair(T&, U&) except +
     cdef cppclass map "std::{{maybe_unordered}}map" [T, U]:
         void insert(pair[T, U]&) except +
+{{if maybe_unordered}}
+        void reserve(size_t) except +
+{{endif}}
     cdef cppclass vector "std::vector" [T]:
         pass
 
@@ -174,6 +248,9 @@ cdef extern from *:
 cdef map[X,Y] {{cname}}(object o) except *:
     cdef dict d = o
     cdef map[X,Y] m
+{{if maybe_unordered}}
+    m.reserve(len(d))
+{{endif}}
     for key, value in d.iteritems():
         m.insert(pair[X,Y](<X>key, <Y>value))
     return m
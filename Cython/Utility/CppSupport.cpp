@@ -69,6 +69,98 @@ auto __Pyx_pythran_to_python(T &&value) -> decltype(to_python(
   #define __PYX_STD_MOVE_IF_SUPPORTED(x) x
 #endif
 
+////////////// CppBufferItemKind.proto //////////////////
+
+// Returns the kind ('i'nteger, 'u'nsigned or 'f'loat) and size of the native
+// items of a buffer format or array.array typecode, or 0 if it is unknown.
+static char __Pyx_CppBufferItemKind(char code, size_t *itemsize);
+
+////////////// CppBufferItemKind //////////////////
+
+static char __Pyx_CppBufferItemKind(char code, size_t *itemsize) {
+    switch (code) {
+        case 'b': *itemsize = sizeof(signed char); return 'i';
+        case 'B': *itemsize = sizeof(unsigned char); return 'u';
+        case 'h': *itemsize = sizeof(short); return 'i';
+        case 'H': *itemsize = sizeof(unsigned short); return 'u';
+        case 'i': *itemsize = sizeof(int); return 'i';
+        case 'I': *itemsize = sizeof(unsigned int); return 'u';
+        case 'l': *itemsize = sizeof(long); return 'i';
+        case 'L': *itemsize = sizeof(unsigned long); return 'u';
+        case 'q': *itemsize = sizeof(PY_LONG_LONG); return 'i';
+        case 'Q': *itemsize = sizeof(unsigned PY_LONG_LONG); return 'u';
+        case 'n': *itemsize = sizeof(Py_ssize_t); return 'i';
+        case 'N': *itemsize = sizeof(size_t); return 'u';
+        case 'f': *itemsize = sizeof(float); return 'f';
+        case 'd': *itemsize = sizeof(double); return 'f';
+        case 'g': *itemsize = sizeof(long double); return 'f';
+        default: return 0;
+    }
+}
+
+////////////// CppBufferFormatMatches.proto //////////////////
+
+// Returns 1 if a buffer format describes single native items of the given kind and size.
+static int __Pyx_CppBufferFormatMatches(const char *format, char kind, size_t itemsize);
+
+////////////// CppBufferFormatMatches //////////////////
+//@requires: CppBufferItemKind
+
+static int __Pyx_CppBufferFormatMatches(const char *format, char kind, size_t itemsize) {
+    size_t format_itemsize;
+    // A NULL format means unsigned bytes.
+    if (!format) return kind == 'u' && itemsize == 1;
+    if (*format == '@') format++;
+    if (!format[0] || format[1]) return 0;
+    return __Pyx_CppBufferItemKind(format[0], &format_itemsize) == kind && format_itemsize == itemsize;
+}
+
+////////////// CppArrayFromData.proto //////////////////
+
+// Returns the array.array typecode for native items of the given kind and size, or 0.
+static char __Pyx_CppArrayTypecode(char kind, size_t itemsize);
+// Returns a read-only buffer object over the memory (a copy in Py2).
+static PyObject *__Pyx_CppReadOnlyBuffer(const char *data, Py_ssize_t size);
+
+////////////// CppArrayFromData //////////////////
+//@requires: CppBufferItemKind
+
+static char __Pyx_CppArrayTypecode(char kind, size_t itemsize) {
+    size_t code_itemsize;
+#if PY_MAJOR_VERSION >= 3
+    const char *code = "bBhHiIlLqQfd";
+#else
+    const char *code = "bBhHiIlLfd";
+#endif
+    for (; *code; code++) {
+        if (__Pyx_CppBufferItemKind(*code, &code_itemsize) == kind && code_itemsize == itemsize)
+            return *code;
+    }
+    return 0;
+}
+
+static PyObject *__Pyx_CppReadOnlyBuffer(const char *data, Py_ssize_t size) {
+#if PY_MAJOR_VERSION >= 3
+    return PyMemoryView_FromMemory((char *) data, size, PyBUF_READ);
+#else
+    return PyBytes_FromStringAndSize(data, size);
+#endif
+}
+
+////////////// CppLengthHint.proto //////////////////
+
+// Returns the number of items in lists and tuples, 0 for other iterables.  Asking them
+// for __length_hint__() costs more than growing the container would.
+static CYTHON_INLINE Py_ssize_t __Pyx_CppLengthHint(PyObject *o);
+
+////////////// CppLengthHint //////////////////
+
+static CYTHON_INLINE Py_ssize_t __Pyx_CppLengthHint(PyObject *o) {
+    if (PyList_CheckExact(o) || PyTuple_CheckExact(o))
+        return __Pyx_PySequence_SIZE(o);
+    return 0;
+}
+
 ////////////// EnumClassDecl.proto //////////////////
 
 #if defined (_MSC_VER)
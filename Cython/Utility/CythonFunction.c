@@ -83,7 +83,9 @@ static int __pyx_CyFunction_init(void);
 #if CYTHON_METH_FASTCALL
 static PyObject * __Pyx_CyFunction_Vectorcall_NOARGS(PyObject *func, PyObject *const *args, size_t nargsf, PyObject *kwnames);
 static PyObject * __Pyx_CyFunction_Vectorcall_O(PyObject *func, PyObject *const *args, size_t nargsf, PyObject *kwnames);
+static PyObject * __Pyx_CyFunction_Vectorcall_FASTCALL(PyObject *func, PyObject *const *args, size_t nargsf, PyObject *kwnames);
 static PyObject * __Pyx_CyFunction_Vectorcall_FASTCALL_KEYWORDS(PyObject *func, PyObject *const *args, size_t nargsf, PyObject *kwnames);
+static PyObject * __Pyx_CyFunction_Vectorcall_VARARGS_KEYWORDS(PyObject *func, PyObject *const *args, size_t nargsf, PyObject *kwnames);
 #if CYTHON_BACKPORT_VECTORCALL
 #define __Pyx_CyFunction_func_vectorcall(f) (((__pyx_CyFunctionObject*)f)->func_vectorcall)
 #else
@@ -97,6 +99,7 @@ static PyObject * __Pyx_CyFunction_Vectorcall_FASTCALL_KEYWORDS(PyObject *func,
 //@requires: ObjectHandling.c::PyMethodNew
 //@requires: ObjectHandling.c::PyVectorcallFastCallDict
 //@requires: ObjectHandling.c::PyObjectGetAttrStr
+//@requires: ObjectHandling.c::TupleAndListFromArray
 
 #include <structmember.h>
 
@@ -511,13 +514,22 @@ static PyObject *__Pyx_CyFunction_Init(__pyx_CyFunctionObject *op, PyMethodDef *
     case METH_O:
         __Pyx_CyFunction_func_vectorcall(op) = __Pyx_CyFunction_Vectorcall_O;
         break;
-    // case METH_FASTCALL is not used
+    case METH_FASTCALL:
+        __Pyx_CyFunction_func_vectorcall(op) = __Pyx_CyFunction_Vectorcall_FASTCALL;
+        break;
     case METH_FASTCALL | METH_KEYWORDS:
         __Pyx_CyFunction_func_vectorcall(op) = __Pyx_CyFunction_Vectorcall_FASTCALL_KEYWORDS;
         break;
     // case METH_VARARGS is not used
     case METH_VARARGS | METH_KEYWORDS:
-        __Pyx_CyFunction_func_vectorcall(op) = NULL;
+        // Methods of extension types receive the arguments without 'self', so tp_call
+        // would have to slice the args tuple.  Functions keep using tp_call, which passes
+        // the args tuple through unchanged.
+        if ((flags & __Pyx_CYFUNCTION_CCLASS) && !(flags & __Pyx_CYFUNCTION_STATICMETHOD)) {
+            __Pyx_CyFunction_func_vectorcall(op) = __Pyx_CyFunction_Vectorcall_VARARGS_KEYWORDS;
+        } else {
+            __Pyx_CyFunction_func_vectorcall(op) = NULL;
+        }
         break;
     default:
         PyErr_SetString(PyExc_SystemError, "Bad call flags for CyFunction");
@@ -678,7 +690,8 @@ static PyObject *__Pyx_CyFunction_CallAsMethod(PyObject *func, PyObject *args, P
     // Prefer vectorcall if available. This is not the typical case, as
     // CPython would normally use vectorcall directly instead of tp_call.
      __pyx_vectorcallfunc vc = __Pyx_CyFunction_func_vectorcall(cyfunc);
-    if (vc) {
+    // METH_VARARGS functions need a tuple anyway, which the slicing below creates directly
+    if (vc && !(cyfunc->func.m_ml->ml_flags & METH_VARARGS)) {
 #if CYTHON_ASSUME_SAFE_MACROS
         return __Pyx_PyVectorcall_FastCallDict(func, vc, &PyTuple_GET_ITEM(args, 0), (size_t)PyTuple_GET_SIZE(args), kw);
 #else
@@ -695,6 +708,11 @@ static PyObject *__Pyx_CyFunction_CallAsMethod(PyObject *func, PyObject *args, P
         PyObject *self;
 
         argc = PyTuple_GET_SIZE(args);
+        if (unlikely(argc < 1)) {
+            PyErr_Format(PyExc_TypeError, "%.200s() needs an argument",
+                         cyfunc->func.m_ml->ml_name);
+            return NULL;
+        }
         new_args = PyTuple_GetSlice(args, 1, argc);
 
         if (unlikely(!new_args))
@@ -829,6 +847,72 @@ static PyObject * __Pyx_CyFunction_Vectorcall_FASTCALL_KEYWORDS(PyObject *func,
 
     return ((_PyCFunctionFastWithKeywords)(void(*)(void))def->ml_meth)(self, args, nargs, kwnames);
 }
+
+static PyObject * __Pyx_CyFunction_Vectorcall_FASTCALL(PyObject *func, PyObject *const *args, size_t nargsf, PyObject *kwnames)
+{
+    __pyx_CyFunctionObject *cyfunc = (__pyx_CyFunctionObject *)func;
+    PyMethodDef* def = cyfunc->func.m_ml;
+#if CYTHON_BACKPORT_VECTORCALL
+    Py_ssize_t nargs = (Py_ssize_t)nargsf;
+#else
+    Py_ssize_t nargs = PyVectorcall_NARGS(nargsf);
+#endif
+    PyObject *self;
+    switch (__Pyx_CyFunction_Vectorcall_CheckArgs(cyfunc, nargs, kwnames)) {
+    case 1:
+        self = args[0];
+        args += 1;
+        nargs -= 1;
+        break;
+    case 0:
+        self = cyfunc->func.m_self;
+        break;
+    default:
+        return NULL;
+    }
+
+    return ((__Pyx_PyCFunctionFast)(void(*)(void))def->ml_meth)(self, args, nargs);
+}
+
+static PyObject * __Pyx_CyFunction_Vectorcall_VARARGS_KEYWORDS(PyObject *func, PyObject *const *args, size_t nargsf, PyObject *kwnames)
+{
+    __pyx_CyFunctionObject *cyfunc = (__pyx_CyFunctionObject *)func;
+    PyMethodDef* def = cyfunc->func.m_ml;
+#if CYTHON_BACKPORT_VECTORCALL
+    Py_ssize_t nargs = (Py_ssize_t)nargsf;
+#else
+    Py_ssize_t nargs = PyVectorcall_NARGS(nargsf);
+#endif
+    PyObject *self, *argstuple, *kwdict = NULL, *result;
+    switch (__Pyx_CyFunction_Vectorcall_CheckArgs(cyfunc, nargs, NULL)) {
+    case 1:
+        self = args[0];
+        args += 1;
+        nargs -= 1;
+        break;
+    case 0:
+        self = cyfunc->func.m_self;
+        break;
+    default:
+        return NULL;
+    }
+
+    // METH_VARARGS functions still allocate an args tuple (and a kwargs dict) on each
+    // call, but it is built without 'self' directly from the arguments array
+    argstuple = __Pyx_PyTuple_FromArray(args, nargs);
+    if (unlikely(!argstuple)) return NULL;
+    if (kwnames && PyTuple_GET_SIZE(kwnames)) {
+        kwdict = _PyStack_AsDict(args + nargs, kwnames);
+        if (unlikely(!kwdict)) {
+            Py_DECREF(argstuple);
+            return NULL;
+        }
+    }
+    result = ((PyCFunctionWithKeywords)(void(*)(void))def->ml_meth)(self, argstuple, kwdict);
+    Py_DECREF(argstuple);
+    Py_XDECREF(kwdict);
+    return result;
+}
 #endif
 
 #if CYTHON_COMPILING_IN_LIMITED_API
@@ -1262,6 +1346,14 @@ __pyx_FusedFunction_callfunction(PyObject *func, PyObject *args, PyObject *kw)
     int static_specialized = (cyfunc->flags & __Pyx_CYFUNCTION_STATICMETHOD &&
                               !((__pyx_FusedFunctionObject *) func)->__signatures__);
 
+#if CYTHON_METH_FASTCALL && CYTHON_ASSUME_SAFE_MACROS
+    // The vectorcall functions select 'self' in the same way as the calls below.
+    __pyx_vectorcallfunc vc = __Pyx_CyFunction_func_vectorcall(cyfunc);
+    if (vc && !(cyfunc->func.m_ml->ml_flags & METH_VARARGS)) {
+        return __Pyx_PyVectorcall_FastCallDict(func, vc, &PyTuple_GET_ITEM(args, 0), (size_t)PyTuple_GET_SIZE(args), kw);
+    }
+#endif
+
     if ((cyfunc->flags & __Pyx_CYFUNCTION_CCLASS) && !static_specialized) {
         return __Pyx_CyFunction_CallAsMethod(func, args, kw);
     } else {
@@ -1314,6 +1406,25 @@ __pyx_FusedFunction_call(PyObject *func, PyObject *args, PyObject *kw)
 
     if (binding_func->__signatures__) {
         PyObject *tup;
+#if CYTHON_METH_FASTCALL
+        // Pass the arguments of the dispatcher function on the C stack instead of packing a tuple.
+        PyMethodDef *def = binding_func->func.func.m_ml;
+        if ((def->ml_flags & (METH_VARARGS | METH_FASTCALL | METH_KEYWORDS)) == (METH_FASTCALL | METH_KEYWORDS)) {
+            PyObject *stack[4];
+            stack[0] = binding_func->__signatures__;
+            stack[1] = args;
+            stack[2] = kw == NULL ? Py_None : kw;
+            stack[3] = binding_func->func.defaults_tuple;
+            if (is_staticmethod && binding_func->func.flags & __Pyx_CYFUNCTION_CCLASS) {
+                // FIXME: see below, the signatures dict is passed as 'self' argument
+                new_func = (__pyx_FusedFunctionObject *) ((__Pyx_PyCFunctionFastWithKeywords)(void(*)(void))def->ml_meth)(
+                    stack[0], stack + 1, 3, NULL);
+            } else {
+                new_func = (__pyx_FusedFunctionObject *) __Pyx_CyFunction_func_vectorcall(binding_func)(
+                    func, stack, 4, NULL);
+            }
+        } else
+#endif
         if (is_staticmethod && binding_func->func.flags & __Pyx_CYFUNCTION_CCLASS) {
             // FIXME: this seems wrong, but we must currently pass the signatures dict as 'self' argument
             tup = PyTuple_Pack(3, args,
@@ -1322,14 +1433,15 @@ __pyx_FusedFunction_call(PyObject *func, PyObject *args, PyObject *kw)
             if (unlikely(!tup)) goto bad;
             new_func = (__pyx_FusedFunctionObject *) __Pyx_CyFunction_CallMethod(
                 func, binding_func->__signatures__, tup, NULL);
+            Py_DECREF(tup);
         } else {
             tup = PyTuple_Pack(4, binding_func->__signatures__, args,
                                kw == NULL ? Py_None : kw,
                                binding_func->func.defaults_tuple);
             if (unlikely(!tup)) goto bad;
             new_func = (__pyx_FusedFunctionObject *) __pyx_FusedFunction_callfunction(func, tup, NULL);
+            Py_DECREF(tup);
         }
-        Py_DECREF(tup);
 
         if (unlikely(!new_func))
             goto bad;
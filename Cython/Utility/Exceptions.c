@@ -782,12 +782,12 @@ static void __Pyx_AddTraceback(const char *funcname, int c_line,
     }
 
     // Negate to avoid collisions between py and c lines.
-    py_code = $global_code_object_cache_find(c_line ? -c_line : py_line);
+    py_code = $global_code_object_cache_find(funcname, c_line ? -c_line : py_line);
     if (!py_code) {
         py_code = __Pyx_CreateCodeObjectForTraceback(
             funcname, c_line, py_line, filename);
         if (!py_code) goto bad;
-        $global_code_object_cache_insert(c_line ? -c_line : py_line, py_code);
+        $global_code_object_cache_insert(funcname, c_line ? -c_line : py_line, py_code);
     }
     py_frame = PyFrame_New(
         tstate,            /*PyThreadState *tstate,*/
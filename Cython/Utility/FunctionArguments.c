@@ -349,6 +349,102 @@ bad:
 }
 
 
+//////////////////// ParseKeywordsHashed.proto ////////////////////
+
+// Perfect hash table over the keyword argument names of a function, as
+// computed by the compiler (Nodes.find_keyword_hash()).  Each slot holds
+// the index of the name in the argnames array or -1 if it is unused.
+typedef struct {
+    unsigned int seed;
+    unsigned int mask;
+    const short *slots;
+} __Pyx_KeywordHashTable;
+
+static int __Pyx_ParseOptionalKeywordsHashed(PyObject *kwds, PyObject *const *kwvalues,
+    PyObject **argnames[],
+    PyObject *kwds2, PyObject *values[], Py_ssize_t num_pos_args,
+    const char* function_name, const __Pyx_KeywordHashTable *table); /*proto*/
+
+//////////////////// ParseKeywordsHashed ////////////////////
+//@requires: ParseKeywords
+
+//  Same as __Pyx_ParseOptionalKeywords(), but looks up each keyword in a
+//  perfect hash table of the argument names, which takes constant time
+//  instead of a linear search through all names.  Anything unusual
+//  (non-string keywords, unexpected or duplicate keywords) is left to
+//  __Pyx_ParseOptionalKeywords(), which then processes all keywords again
+//  and raises the appropriate error.
+
+#if PY_MAJOR_VERSION >= 3
+// FNV-1a over the code points of the name, must match Nodes.find_keyword_hash().
+static CYTHON_INLINE unsigned int __Pyx_KeywordHash(PyObject *key, unsigned int seed) {
+    Py_ssize_t i, length = __Pyx_PyUnicode_GET_LENGTH(key);
+    int kind = __Pyx_PyUnicode_KIND(key);
+    void *data = __Pyx_PyUnicode_DATA(key);
+    unsigned int h = seed ^ 2166136261U;
+    for (i = 0; i < length; i++) {
+        h ^= (unsigned int) __Pyx_PyUnicode_READ(kind, data, i);
+        h *= 16777619U;
+    }
+    return h;
+}
+#endif
+
+static int __Pyx_ParseOptionalKeywordsHashed(
+    PyObject *kwds,
+    PyObject *const *kwvalues,
+    PyObject **argnames[],
+    PyObject *kwds2,
+    PyObject *values[],
+    Py_ssize_t num_pos_args,
+    const char* function_name,
+    const __Pyx_KeywordHashTable *table)
+{
+#if PY_MAJOR_VERSION >= 3
+    PyObject *key = 0, *value = 0;
+    Py_ssize_t pos = 0;
+    int kwds_is_tuple = CYTHON_METH_FASTCALL && likely(PyTuple_Check(kwds));
+
+    while (1) {
+        short index;
+        PyObject *name;
+        if (kwds_is_tuple) {
+            if (pos >= PyTuple_GET_SIZE(kwds)) break;
+            key = PyTuple_GET_ITEM(kwds, pos);
+            value = kwvalues[pos];
+            pos++;
+        }
+        else
+        {
+            if (!PyDict_Next(kwds, &pos, &key, &value)) break;
+        }
+
+        if (unlikely(!PyUnicode_Check(key)) || unlikely(__Pyx_PyUnicode_READY(key) < 0)) goto fallback;
+        index = table->slots[__Pyx_KeywordHash(key, table->seed) & table->mask];
+        if (likely(index >= 0)) {
+            name = *argnames[index];
+            if (likely(name == key) || (
+                    __Pyx_PyUnicode_GET_LENGTH(name) == __Pyx_PyUnicode_GET_LENGTH(key) &&
+                    PyUnicode_Compare(name, key) == 0)) {
+                // passing a positional argument also as keyword is an error
+                if (unlikely(index < num_pos_args)) goto fallback;
+                values[index] = value;
+                continue;
+            }
+            if (unlikely(PyErr_Occurred())) return -1;
+        }
+        if (unlikely(!kwds2)) goto fallback;
+        if (unlikely(PyDict_SetItem(kwds2, key, value))) return -1;
+    }
+    return 0;
+fallback:
+#else
+    (void) table;
+#endif
+    return __Pyx_ParseOptionalKeywords(kwds, kwvalues, argnames, kwds2, values, num_pos_args, function_name);
+}
+
+
 //////////////////// MergeKeywords.proto ////////////////////
 
 static int __Pyx_MergeKeywords(PyObject *kwdict, PyObject *source_mapping); /*proto*/
@@ -94,6 +94,24 @@ cdef extern from *:
     bint slices_overlap "__pyx_slices_overlap" ({{memviewslice_name}} *slice1,
                                                 {{memviewslice_name}} *slice2,
                                                 int ndim, size_t itemsize) nogil
+    void copy_strided_1d "__pyx_memview_copy_strided_1d" (
+                            char *src, Py_ssize_t src_stride,
+                            char *dst, Py_ssize_t dst_stride,
+                            Py_ssize_t extent, size_t itemsize) nogil
+    void copy_strided_2d "__pyx_memview_copy_strided_2d" (
+                            char *src, Py_ssize_t src_stride0, Py_ssize_t src_stride1,
+                            char *dst, Py_ssize_t dst_stride0, Py_ssize_t dst_stride1,
+                            Py_ssize_t extent0, Py_ssize_t extent1, size_t itemsize) nogil
+    int parallel_threads "__pyx_memview_parallel_threads" (size_t nbytes) nogil
+    void copy_strided_parallel "__pyx_memview_copy_strided_parallel" (
+                            char *src_data, Py_ssize_t *src_strides,
+                            char *dst_data, Py_ssize_t *dst_strides,
+                            Py_ssize_t *shape, int ndim, size_t itemsize,
+                            int num_threads) nogil
+    void assign_scalar_parallel "__pyx_memview_assign_scalar_parallel" (
+                            char *data, Py_ssize_t *shape, Py_ssize_t *strides,
+                            int ndim, size_t itemsize, void *item,
+                            int num_threads) nogil
 
 
 cdef extern from "<stdlib.h>":
@@ -308,38 +326,6 @@ cdef indirect_contiguous = Enum("<contiguous and indirect>")
 # 'follow' is implied when the first or last axis is ::1
 
 
-@cname('__pyx_align_pointer')
-cdef void *align_pointer(void *memory, size_t alignment) nogil:
-    "Align pointer memory on a given boundary"
-    cdef Py_intptr_t aligned_p = <Py_intptr_t> memory
-    cdef size_t offset
-
-    with cython.cdivision(True):
-        offset = aligned_p % alignment
-
-    if offset > 0:
-        aligned_p += alignment - offset
-
-    return <void *> aligned_p
-
-
-# pre-allocate thread locks for reuse
-## note that this could be implemented in a more beautiful way in "normal" Cython,
-## but this code gets merged into the user module and not everything works there.
-DEF THREAD_LOCKS_PREALLOCATED = 8
-cdef int __pyx_memoryview_thread_locks_used = 0
-cdef PyThread_type_lock[THREAD_LOCKS_PREALLOCATED] __pyx_memoryview_thread_locks = [
-    PyThread_allocate_lock(),
-    PyThread_allocate_lock(),
-    PyThread_allocate_lock(),
-    PyThread_allocate_lock(),
-    PyThread_allocate_lock(),
-    PyThread_allocate_lock(),
-    PyThread_allocate_lock(),
-    PyThread_allocate_lock(),
-]
-
-
 @cname('__pyx_memoryview')
 cdef class memoryview:
 
@@ -347,10 +333,7 @@ cdef class memoryview:
     cdef object _size
     cdef object _array_interface
     cdef PyThread_type_lock lock
-    # the following array will contain a single __pyx_atomic int with
-    # suitable alignment
-    cdef __pyx_atomic_int acquisition_count[2]
-    cdef __pyx_atomic_int *acquisition_count_aligned_p
+    cdef __pyx_atomic_int acquisition_count
     cdef Py_buffer view
     cdef int flags
     cdef bint dtype_is_object
@@ -365,22 +348,16 @@ cdef class memoryview:
                 (<__pyx_buffer *> &self.view).obj = Py_None
                 Py_INCREF(Py_None)
 
-        global __pyx_memoryview_thread_locks_used
-        if __pyx_memoryview_thread_locks_used < THREAD_LOCKS_PREALLOCATED:
-            self.lock = __pyx_memoryview_thread_locks[__pyx_memoryview_thread_locks_used]
-            __pyx_memoryview_thread_locks_used += 1
+        # Also needed with atomics: modules compiled without them share this type.
+        self.lock = PyThread_allocate_lock()
         if self.lock is NULL:
-            self.lock = PyThread_allocate_lock()
-            if self.lock is NULL:
-                raise MemoryError
+            raise MemoryError
 
         if flags & PyBUF_FORMAT:
             self.dtype_is_object = (self.view.format[0] == b'O' and self.view.format[1] == b'\0')
         else:
             self.dtype_is_object = dtype_is_object
 
-        self.acquisition_count_aligned_p = <__pyx_atomic_int *> align_pointer(
-                  <void *> &self.acquisition_count[0], sizeof(__pyx_atomic_int))
         self.typeinfo = NULL
 
     def __dealloc__(memoryview self):
@@ -391,18 +368,8 @@ cdef class memoryview:
             (<__pyx_buffer *> &self.view).obj = NULL
             Py_DECREF(Py_None)
 
-        cdef int i
-        global __pyx_memoryview_thread_locks_used
         if self.lock != NULL:
-            for i in range(__pyx_memoryview_thread_locks_used):
-                if __pyx_memoryview_thread_locks[i] is self.lock:
-                    __pyx_memoryview_thread_locks_used -= 1
-                    if i != __pyx_memoryview_thread_locks_used:
-                        __pyx_memoryview_thread_locks[i], __pyx_memoryview_thread_locks[__pyx_memoryview_thread_locks_used] = (
-                            __pyx_memoryview_thread_locks[__pyx_memoryview_thread_locks_used], __pyx_memoryview_thread_locks[i])
-                    break
-            else:
-                PyThread_free_lock(self.lock)
+            PyThread_free_lock(self.lock)
 
     cdef char *get_item_pointer(memoryview self, object index) except NULL:
         cdef Py_ssize_t dim
@@ -1145,7 +1112,7 @@ cdef char get_best_order({{memviewslice_name}} *mslice, int ndim) nogil:
     else:
         return 'F'
 
-@cython.cdivision(True)
+@cname('__pyx_memoryview__copy_strided_to_strided')
 cdef void _copy_strided_to_strided(char *src_data, Py_ssize_t *src_strides,
                                    char *dst_data, Py_ssize_t *dst_strides,
                                    Py_ssize_t *src_shape, Py_ssize_t *dst_shape,
@@ -1153,20 +1120,16 @@ cdef void _copy_strided_to_strided(char *src_data, Py_ssize_t *src_strides,
     # Note: src_extent is 1 if we're broadcasting
     # dst_extent always >= src_extent as we don't do reductions
     cdef Py_ssize_t i
-    cdef Py_ssize_t src_extent = src_shape[0]
     cdef Py_ssize_t dst_extent = dst_shape[0]
     cdef Py_ssize_t src_stride = src_strides[0]
     cdef Py_ssize_t dst_stride = dst_strides[0]
 
     if ndim == 1:
-       if (src_stride > 0 and dst_stride > 0 and
-           <size_t> src_stride == itemsize == <size_t> dst_stride):
-           memcpy(dst_data, src_data, itemsize * dst_extent)
-       else:
-           for i in range(dst_extent):
-               memcpy(dst_data, src_data, itemsize)
-               src_data += src_stride
-               dst_data += dst_stride
+        copy_strided_1d(src_data, src_stride, dst_data, dst_stride, dst_extent, itemsize)
+    elif ndim == 2:
+        copy_strided_2d(src_data, src_stride, src_strides[1],
+                        dst_data, dst_stride, dst_strides[1],
+                        dst_extent, dst_shape[1], itemsize)
     else:
         for i in range(dst_extent):
             _copy_strided_to_strided(src_data, src_strides + 1,
@@ -1179,8 +1142,52 @@ cdef void _copy_strided_to_strided(char *src_data, Py_ssize_t *src_strides,
 cdef void copy_strided_to_strided({{memviewslice_name}} *src,
                                   {{memviewslice_name}} *dst,
                                   int ndim, size_t itemsize) nogil:
-    _copy_strided_to_strided(src.data, src.strides, dst.data, dst.strides,
-                             src.shape, dst.shape, ndim, itemsize)
+    cdef Py_ssize_t src_strides[{{max_dims}}]
+    cdef Py_ssize_t dst_strides[{{max_dims}}]
+    cdef Py_ssize_t dst_shape[{{max_dims}}]
+    cdef int i, inner = ndim - 1
+    cdef int num_threads = parallel_threads(slice_get_size(dst, ndim))
+
+    # The copy is element-wise, so the dimensions can be visited in any order.
+    # Move the dimension that is contiguous in the destination next to the
+    # innermost one, so that the 2D kernel can copy both in cache sized tiles.
+    for i in range(ndim - 2):
+        if (abs_py_ssize_t(dst.strides[i]) < abs_py_ssize_t(dst.strides[inner]) and
+                abs_py_ssize_t(dst.strides[i]) < abs_py_ssize_t(dst.strides[ndim - 2]) and
+                dst.shape[i] > 1):
+            inner = i
+
+    if inner >= ndim - 2:
+        if num_threads > 1:
+            copy_strided_parallel(src.data, src.strides, dst.data, dst.strides,
+                                  dst.shape, ndim, itemsize, num_threads)
+        else:
+            _copy_strided_to_strided(src.data, src.strides, dst.data, dst.strides,
+                                     src.shape, dst.shape, ndim, itemsize)
+        return
+
+    for i in range(ndim):
+        src_strides[i] = src.strides[i]
+        dst_strides[i] = dst.strides[i]
+        dst_shape[i] = dst.shape[i]
+    src_strides[inner], src_strides[ndim - 2] = src_strides[ndim - 2], src_strides[inner]
+    dst_strides[inner], dst_strides[ndim - 2] = dst_strides[ndim - 2], dst_strides[inner]
+    dst_shape[inner], dst_shape[ndim - 2] = dst_shape[ndim - 2], dst_shape[inner]
+
+    if num_threads > 1:
+        copy_strided_parallel(src.data, src_strides, dst.data, dst_strides,
+                              dst_shape, ndim, itemsize, num_threads)
+    else:
+        _copy_strided_to_strided(src.data, src_strides, dst.data, dst_strides,
+                                 dst_shape, dst_shape, ndim, itemsize)
+
+cdef void copy_contiguous(char *dst, char *src, size_t size) nogil:
+    cdef Py_ssize_t extent = size, stride = 1
+    cdef int num_threads = parallel_threads(size)
+    if num_threads > 1:
+        copy_strided_parallel(src, &stride, dst, &stride, &extent, 1, 1, num_threads)
+    else:
+        memcpy(dst, src, size)
 
 @cname('__pyx_memoryview_slice_get_size')
 cdef Py_ssize_t slice_get_size({{memviewslice_name}} *src, int ndim) nogil:
@@ -1247,7 +1254,7 @@ cdef void *copy_data_to_temp({{memviewslice_name}} *src,
             tmpslice.strides[i] = 0
 
     if slice_is_contig(src[0], order, ndim):
-        memcpy(result, src.data, size)
+        copy_contiguous(<char *> result, src.data, size)
     else:
         copy_strided_to_strided(src, tmpslice, ndim, itemsize)
 
@@ -1327,7 +1334,7 @@ cdef int memoryview_copy_contents({{memviewslice_name}} src,
         if direct_copy:
             # Contiguous slices with same order
             refcount_copying(&dst, dtype_is_object, ndim, inc=False)
-            memcpy(dst.data, src.data, slice_get_size(&src, ndim))
+            copy_contiguous(dst.data, src.data, slice_get_size(&src, ndim))
             refcount_copying(&dst, dtype_is_object, ndim, inc=True)
             free(tmpdata)
             return 0
@@ -1403,8 +1410,12 @@ cdef void refcount_objects_in_slice(char *data, Py_ssize_t *shape,
 cdef void slice_assign_scalar({{memviewslice_name}} *dst, int ndim,
                               size_t itemsize, void *item,
                               bint dtype_is_object) nogil:
+    cdef int num_threads = parallel_threads(slice_get_size(dst, ndim))
     refcount_copying(dst, dtype_is_object, ndim, inc=False)
-    _slice_assign_scalar(dst.data, dst.shape, dst.strides, ndim, itemsize, item)
+    if num_threads > 1:
+        assign_scalar_parallel(dst.data, dst.shape, dst.strides, ndim, itemsize, item, num_threads)
+    else:
+        _slice_assign_scalar(dst.data, dst.shape, dst.strides, ndim, itemsize, item)
     refcount_copying(dst, dtype_is_object, ndim, inc=True)
 
 
@@ -25,53 +25,73 @@ typedef struct {
     #define CYTHON_ATOMICS 1
 #endif
 
+// The acquisition count of a memoryview is incremented with relaxed ordering
+// (taking a new reference requires holding one already), and decremented with
+// acquire-release ordering, so that the last release sees all prior accesses.
 #define __pyx_atomic_int_type int
-// todo: Portland pgcc, maybe OS X's OSAtomicIncrement32,
-//       libatomic + autotools-like distutils support? Such a pain...
-#if CYTHON_ATOMICS && __GNUC__ >= 4 && (__GNUC_MINOR__ > 1 ||           \
-                    (__GNUC_MINOR__ == 1 && __GNUC_PATCHLEVEL >= 2)) && \
+#if CYTHON_ATOMICS && defined(__cplusplus) && (__cplusplus >= 201103L || \
+                    (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L))
+    /* C++11 */
+    #include <atomic>
+    typedef std::atomic<__pyx_atomic_int_type> __pyx_atomic_int;
+    #define __pyx_atomic_incr_aligned(value) std::atomic_fetch_add_explicit(value, 1, std::memory_order_relaxed)
+    #define __pyx_atomic_decr_aligned(value) std::atomic_fetch_sub_explicit(value, 1, std::memory_order_acq_rel)
+
+    #ifdef __PYX_DEBUG_ATOMICS
+        #pragma message ("Using C++11 atomics")
+    #endif
+#elif CYTHON_ATOMICS && !defined(__cplusplus) && defined(__STDC_VERSION__) && \
+                    __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+    /* C11 */
+    #include <stdatomic.h>
+    typedef atomic_int __pyx_atomic_int;
+    #define __pyx_atomic_incr_aligned(value) atomic_fetch_add_explicit(value, 1, memory_order_relaxed)
+    #define __pyx_atomic_decr_aligned(value) atomic_fetch_sub_explicit(value, 1, memory_order_acq_rel)
+
+    #ifdef __PYX_DEBUG_ATOMICS
+        #pragma message ("Using C11 atomics")
+    #endif
+#elif CYTHON_ATOMICS && (__GNUC__ > 4 || (__GNUC__ == 4 && (__GNUC_MINOR__ > 1 || \
+                    (__GNUC_MINOR__ == 1 && __GNUC_PATCHLEVEL__ >= 2)))) && \
                     !defined(__i386__)
     /* gcc >= 4.1.2 */
-    #define __pyx_atomic_incr_aligned(value, lock) __sync_fetch_and_add(value, 1)
-    #define __pyx_atomic_decr_aligned(value, lock) __sync_fetch_and_sub(value, 1)
+    typedef volatile __pyx_atomic_int_type __pyx_atomic_int;
+    #define __pyx_atomic_incr_aligned(value) __sync_fetch_and_add(value, 1)
+    #define __pyx_atomic_decr_aligned(value) __sync_fetch_and_sub(value, 1)
 
     #ifdef __PYX_DEBUG_ATOMICS
         #warning "Using GNU atomics"
     #endif
-#elif CYTHON_ATOMICS && defined(_MSC_VER) && 0
-    /* msvc */
-    #include <Windows.h>
+#elif CYTHON_ATOMICS && defined(_MSC_VER)
+    /* msvc and Intel on Windows */
+    #include <intrin.h>
     #undef __pyx_atomic_int_type
-    #define __pyx_atomic_int_type LONG
-    #define __pyx_atomic_incr_aligned(value, lock) InterlockedIncrement(value)
-    #define __pyx_atomic_decr_aligned(value, lock) InterlockedDecrement(value)
+    #define __pyx_atomic_int_type long
+    typedef volatile __pyx_atomic_int_type __pyx_atomic_int;
+    #pragma intrinsic (_InterlockedExchangeAdd)
+    // Like the other implementations, these return the value before the change.
+    #define __pyx_atomic_incr_aligned(value) _InterlockedExchangeAdd(value, 1)
+    #define __pyx_atomic_decr_aligned(value) _InterlockedExchangeAdd(value, -1)
 
     #ifdef __PYX_DEBUG_ATOMICS
         #pragma message ("Using MSVC atomics")
     #endif
-#elif CYTHON_ATOMICS && (defined(__ICC) || defined(__INTEL_COMPILER)) && 0
-    #define __pyx_atomic_incr_aligned(value, lock) _InterlockedIncrement(value)
-    #define __pyx_atomic_decr_aligned(value, lock) _InterlockedDecrement(value)
-
-    #ifdef __PYX_DEBUG_ATOMICS
-        #warning "Using Intel atomics"
-    #endif
 #else
     #undef CYTHON_ATOMICS
     #define CYTHON_ATOMICS 0
 
+    typedef volatile __pyx_atomic_int_type __pyx_atomic_int;
+
     #ifdef __PYX_DEBUG_ATOMICS
         #warning "Not using atomics"
     #endif
 #endif
 
-typedef volatile __pyx_atomic_int_type __pyx_atomic_int;
-
 #if CYTHON_ATOMICS
     #define __pyx_add_acquisition_count(memview) \
-             __pyx_atomic_incr_aligned(__pyx_get_slice_count_pointer(memview), memview->lock)
+             __pyx_atomic_incr_aligned(__pyx_get_slice_count_pointer(memview))
     #define __pyx_sub_acquisition_count(memview) \
-            __pyx_atomic_decr_aligned(__pyx_get_slice_count_pointer(memview), memview->lock)
+            __pyx_atomic_decr_aligned(__pyx_get_slice_count_pointer(memview))
 #else
     #define __pyx_add_acquisition_count(memview) \
             __pyx_add_acquisition_count_locked(__pyx_get_slice_count_pointer(memview), memview->lock)
@@ -110,8 +130,7 @@ static CYTHON_INLINE int __pyx_add_acquisition_count_locked(
 static CYTHON_INLINE int __pyx_sub_acquisition_count_locked(
     __pyx_atomic_int *acquisition_count, PyThread_type_lock lock);
 
-#define __pyx_get_slice_count_pointer(memview) (memview->acquisition_count_aligned_p)
-#define __pyx_get_slice_count(memview) (*__pyx_get_slice_count_pointer(memview))
+#define __pyx_get_slice_count_pointer(memview) (&memview->acquisition_count)
 #define __PYX_INC_MEMVIEW(slice, have_gil) __Pyx_INC_MEMVIEW(slice, have_gil, __LINE__)
 #define __PYX_XCLEAR_MEMVIEW(slice, have_gil) __Pyx_XCLEAR_MEMVIEW(slice, have_gil, __LINE__)
 static CYTHON_INLINE void __Pyx_INC_MEMVIEW({{memviewslice_name}} *, int, int);
@@ -507,7 +526,7 @@ __Pyx_INC_MEMVIEW({{memviewslice_name}} *memslice, int have_gil, int lineno)
             }
         } else {
             __pyx_fatalerror("Acquisition count is %d (line %d)",
-                             __pyx_get_slice_count(memview), lineno);
+                             (int) old_acquisition_count + 1, lineno);
         }
     }
 }
@@ -539,7 +558,7 @@ static CYTHON_INLINE void __Pyx_XCLEAR_MEMVIEW({{memviewslice_name}} *memslice,
         }
     } else {
         __pyx_fatalerror("Acquisition count is %d (line %d)",
-                         __pyx_get_slice_count(memview), lineno);
+                         (int) old_acquisition_count - 1, lineno);
     }
 }
 
@@ -699,6 +718,241 @@ __pyx_slices_overlap({{memviewslice_name}} *slice1,
 }
 
 
+////////// StridedCopyKernels.proto //////////
+
+static void __pyx_memview_copy_strided_1d(char *src, Py_ssize_t src_stride,
+                                          char *dst, Py_ssize_t dst_stride,
+                                          Py_ssize_t extent, size_t itemsize);
+static void __pyx_memview_copy_strided_2d(char *src, Py_ssize_t src_stride0, Py_ssize_t src_stride1,
+                                          char *dst, Py_ssize_t dst_stride0, Py_ssize_t dst_stride1,
+                                          Py_ssize_t extent0, Py_ssize_t extent1, size_t itemsize);
+
+
+////////// StridedCopyKernels //////////
+
+/* Copy kernels for the innermost dimensions of a memoryview copy.  */
+/* The kernels are inlined with the common item sizes as compile time */
+/* constants, so that the memcpy() calls turn into plain (unaligned) loads */
+/* and stores that the C compiler can unroll and vectorise, instead of one */
+/* library call per element. */
+
+/* Number of items per side of the tiles of a blocked 2D copy */
+#define __PYX_COPY_BLOCK_SIZE 16
+
+#define __PYX_COPY_ABS(x) ((x) < 0 ? -(x) : (x))
+
+static CYTHON_INLINE void
+__pyx_memview_copy_strided_1d_sized(char *src, Py_ssize_t src_stride,
+                                    char *dst, Py_ssize_t dst_stride,
+                                    Py_ssize_t extent, size_t itemsize)
+{
+    Py_ssize_t i;
+    const Py_ssize_t size = (Py_ssize_t) itemsize;
+
+    if (src_stride == size && dst_stride == size) {
+        memcpy(dst, src, itemsize * (size_t) extent);
+    } else if (dst_stride == size) {
+        /* gather */
+        for (i = 0; i < extent; i++)
+            memcpy(dst + i * size, src + i * src_stride, itemsize);
+    } else if (src_stride == size) {
+        /* scatter */
+        for (i = 0; i < extent; i++)
+            memcpy(dst + i * dst_stride, src + i * size, itemsize);
+    } else {
+        for (i = 0; i < extent; i++)
+            memcpy(dst + i * dst_stride, src + i * src_stride, itemsize);
+    }
+}
+
+static CYTHON_INLINE void
+__pyx_memview_copy_strided_2d_sized(char *src, Py_ssize_t src_stride0, Py_ssize_t src_stride1,
+                                    char *dst, Py_ssize_t dst_stride0, Py_ssize_t dst_stride1,
+                                    Py_ssize_t extent0, Py_ssize_t extent1, size_t itemsize)
+{
+    Py_ssize_t i;
+    for (i = 0; i < extent0; i++) {
+        __pyx_memview_copy_strided_1d_sized(src, src_stride1, dst, dst_stride1, extent1, itemsize);
+        src += src_stride0;
+        dst += dst_stride0;
+    }
+}
+
+/* Copy in square tiles that stay in the cache.  Used when the source and */
+/* destination disagree about the fastest varying dimension, e.g. between */
+/* C and Fortran order, where copying row by row would touch a new cache */
+/* line of one of the buffers for each item. */
+static CYTHON_INLINE void
+__pyx_memview_copy_blocked_2d_sized(char *src, Py_ssize_t src_stride0, Py_ssize_t src_stride1,
+                                    char *dst, Py_ssize_t dst_stride0, Py_ssize_t dst_stride1,
+                                    Py_ssize_t extent0, Py_ssize_t extent1, size_t itemsize)
+{
+    Py_ssize_t i, j, block0, block1;
+    /* Inside of a tile, write along the destination's contiguous dimension. */
+    int gather0 = __PYX_COPY_ABS(dst_stride0) < __PYX_COPY_ABS(dst_stride1);
+
+    for (i = 0; i < extent0; i += __PYX_COPY_BLOCK_SIZE) {
+        block0 = extent0 - i < __PYX_COPY_BLOCK_SIZE ? extent0 - i : __PYX_COPY_BLOCK_SIZE;
+        for (j = 0; j < extent1; j += __PYX_COPY_BLOCK_SIZE) {
+            block1 = extent1 - j < __PYX_COPY_BLOCK_SIZE ? extent1 - j : __PYX_COPY_BLOCK_SIZE;
+            if (gather0)
+                __pyx_memview_copy_strided_2d_sized(
+                    src + i * src_stride0 + j * src_stride1, src_stride1, src_stride0,
+                    dst + i * dst_stride0 + j * dst_stride1, dst_stride1, dst_stride0,
+                    block1, block0, itemsize);
+            else
+                __pyx_memview_copy_strided_2d_sized(
+                    src + i * src_stride0 + j * src_stride1, src_stride0, src_stride1,
+                    dst + i * dst_stride0 + j * dst_stride1, dst_stride0, dst_stride1,
+                    block0, block1, itemsize);
+        }
+    }
+}
+
+static void
+__pyx_memview_copy_strided_1d(char *src, Py_ssize_t src_stride,
+                              char *dst, Py_ssize_t dst_stride,
+                              Py_ssize_t extent, size_t itemsize)
+{
+    switch (itemsize) {
+        case 1: __pyx_memview_copy_strided_1d_sized(src, src_stride, dst, dst_stride, extent, 1); break;
+        case 2: __pyx_memview_copy_strided_1d_sized(src, src_stride, dst, dst_stride, extent, 2); break;
+        case 4: __pyx_memview_copy_strided_1d_sized(src, src_stride, dst, dst_stride, extent, 4); break;
+        case 8: __pyx_memview_copy_strided_1d_sized(src, src_stride, dst, dst_stride, extent, 8); break;
+        case 16: __pyx_memview_copy_strided_1d_sized(src, src_stride, dst, dst_stride, extent, 16); break;
+        default: __pyx_memview_copy_strided_1d_sized(src, src_stride, dst, dst_stride, extent, itemsize);
+    }
+}
+
+static CYTHON_INLINE void
+__pyx_memview_copy_2d_sized(char *src, Py_ssize_t src_stride0, Py_ssize_t src_stride1,
+                            char *dst, Py_ssize_t dst_stride0, Py_ssize_t dst_stride1,
+                            Py_ssize_t extent0, Py_ssize_t extent1, size_t itemsize, int blocked)
+{
+    if (blocked)
+        __pyx_memview_copy_blocked_2d_sized(src, src_stride0, src_stride1, dst, dst_stride0, dst_stride1,
+                                            extent0, extent1, itemsize);
+    else
+        __pyx_memview_copy_strided_2d_sized(src, src_stride0, src_stride1, dst, dst_stride0, dst_stride1,
+                                            extent0, extent1, itemsize);
+}
+
+static void
+__pyx_memview_copy_strided_2d(char *src, Py_ssize_t src_stride0, Py_ssize_t src_stride1,
+                              char *dst, Py_ssize_t dst_stride0, Py_ssize_t dst_stride1,
+                              Py_ssize_t extent0, Py_ssize_t extent1, size_t itemsize)
+{
+    /* Broadcast source dimensions have a zero stride and never need blocking. */
+    int blocked = (
+        extent0 > __PYX_COPY_BLOCK_SIZE && extent1 > __PYX_COPY_BLOCK_SIZE && (
+            (src_stride0 != 0 && __PYX_COPY_ABS(src_stride1) > __PYX_COPY_ABS(src_stride0)) ||
+            __PYX_COPY_ABS(dst_stride1) > __PYX_COPY_ABS(dst_stride0)));
+
+    switch (itemsize) {
+        case 1: __pyx_memview_copy_2d_sized(src, src_stride0, src_stride1, dst, dst_stride0, dst_stride1,
+                                            extent0, extent1, 1, blocked); break;
+        case 2: __pyx_memview_copy_2d_sized(src, src_stride0, src_stride1, dst, dst_stride0, dst_stride1,
+                                            extent0, extent1, 2, blocked); break;
+        case 4: __pyx_memview_copy_2d_sized(src, src_stride0, src_stride1, dst, dst_stride0, dst_stride1,
+                                            extent0, extent1, 4, blocked); break;
+        case 8: __pyx_memview_copy_2d_sized(src, src_stride0, src_stride1, dst, dst_stride0, dst_stride1,
+                                            extent0, extent1, 8, blocked); break;
+        case 16: __pyx_memview_copy_2d_sized(src, src_stride0, src_stride1, dst, dst_stride0, dst_stride1,
+                                             extent0, extent1, 16, blocked); break;
+        default: __pyx_memview_copy_2d_sized(src, src_stride0, src_stride1, dst, dst_stride0, dst_stride1,
+                                             extent0, extent1, itemsize, blocked);
+    }
+}
+
+
+////////// MemviewParallelCopy.proto //////////
+
+/* Copies and scalar fills of slices of at least this many bytes are split */
+/* across OpenMP threads in modules that are compiled with OpenMP support. */
+/* The default of 0 disables this. */
+#ifndef CYTHON_MEMVIEW_PARALLEL_THRESHOLD
+  #define CYTHON_MEMVIEW_PARALLEL_THRESHOLD 0
+#endif
+
+static int __pyx_memview_parallel_threads(size_t nbytes);
+static void __pyx_memview_copy_strided_parallel(char *src_data, Py_ssize_t *src_strides,
+                                                char *dst_data, Py_ssize_t *dst_strides,
+                                                Py_ssize_t *shape, int ndim, size_t itemsize,
+                                                int num_threads);
+static void __pyx_memview_assign_scalar_parallel(char *data, Py_ssize_t *shape,
+                                                 Py_ssize_t *strides, int ndim,
+                                                 size_t itemsize, void *item,
+                                                 int num_threads);
+
+
+////////// MemviewParallelCopy //////////
+
+/* Returns the number of threads to use for a copy of 'nbytes' bytes. */
+static int __pyx_memview_parallel_threads(size_t nbytes) {
+#if defined(_OPENMP) && CYTHON_MEMVIEW_PARALLEL_THRESHOLD > 0
+    /* Do not start nested threads inside of a prange() or parallel() block. */
+    if (nbytes >= (size_t) CYTHON_MEMVIEW_PARALLEL_THRESHOLD && !omp_in_parallel())
+        return omp_get_max_threads();
+#endif
+    (void) nbytes;
+    return 1;
+}
+
+/* The outer dimension is split into a few chunks per thread, */
+/* which lets the threads balance out uneven progress. */
+static CYTHON_INLINE Py_ssize_t __pyx_memview_parallel_chunksize(Py_ssize_t extent, int num_threads) {
+    Py_ssize_t nchunks = 4 * (Py_ssize_t) num_threads;
+    Py_ssize_t chunksize = (extent + nchunks - 1) / nchunks;
+    return chunksize > 0 ? chunksize : 1;
+}
+
+static void __pyx_memview_copy_strided_parallel(char *src_data, Py_ssize_t *src_strides,
+                                                char *dst_data, Py_ssize_t *dst_strides,
+                                                Py_ssize_t *shape, int ndim, size_t itemsize,
+                                                int num_threads)
+{
+    Py_ssize_t start;
+    Py_ssize_t extent = shape[0];
+    Py_ssize_t chunksize = __pyx_memview_parallel_chunksize(extent, num_threads);
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+    #endif
+    for (start = 0; start < extent; start += chunksize) {
+        Py_ssize_t chunk_shape[{{max_dims}}];
+        memcpy(chunk_shape, shape, (size_t) ndim * sizeof(Py_ssize_t));
+        chunk_shape[0] = extent - start < chunksize ? extent - start : chunksize;
+        __pyx_memoryview__copy_strided_to_strided(
+            src_data + start * src_strides[0], src_strides,
+            dst_data + start * dst_strides[0], dst_strides,
+            chunk_shape, chunk_shape, ndim, itemsize);
+    }
+    (void) num_threads;
+}
+
+static void __pyx_memview_assign_scalar_parallel(char *data, Py_ssize_t *shape,
+                                                 Py_ssize_t *strides, int ndim,
+                                                 size_t itemsize, void *item,
+                                                 int num_threads)
+{
+    Py_ssize_t start;
+    Py_ssize_t extent = shape[0];
+    Py_ssize_t chunksize = __pyx_memview_parallel_chunksize(extent, num_threads);
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+    #endif
+    for (start = 0; start < extent; start += chunksize) {
+        Py_ssize_t chunk_shape[{{max_dims}}];
+        memcpy(chunk_shape, shape, (size_t) ndim * sizeof(Py_ssize_t));
+        chunk_shape[0] = extent - start < chunksize ? extent - start : chunksize;
+        __pyx_memoryview__slice_assign_scalar(
+            data + start * strides[0], chunk_shape, strides, ndim, itemsize, item);
+    }
+    (void) num_threads;
+}
+
+
 ////////// MemviewSliceCheckContig.proto //////////
 
 #define __pyx_memviewslice_is_contig_{{contig_type}}{{ndim}}(slice) \
@@ -284,6 +284,11 @@
 #define CYTHON_VECTORCALL  (CYTHON_FAST_PYCCALL && PY_VERSION_HEX >= 0x030800B1)
 #endif
 
+/* Per call site caches of attribute lookups, keyed on the type version tag */
+#if !defined(CYTHON_USE_INLINE_CACHES)
+#define CYTHON_USE_INLINE_CACHES  (CYTHON_COMPILING_IN_CPYTHON && CYTHON_USE_TYPE_SLOTS && CYTHON_USE_PYTYPE_LOOKUP && PY_MAJOR_VERSION >= 3)
+#endif
+
 /* Whether to use METH_FASTCALL with a fake backported implementation of vectorcall */
 #define CYTHON_BACKPORT_VECTORCALL (CYTHON_METH_FASTCALL && PY_VERSION_HEX < 0x030800B1)
 
@@ -1255,106 +1260,121 @@ bad:
 #if !CYTHON_COMPILING_IN_LIMITED_API
 typedef struct {
     PyCodeObject* code_object;
+    const char *funcname;  /* NULL marks an unused slot */
     int code_line;
 } __Pyx_CodeObjectCacheEntry;
 
 struct __Pyx_CodeObjectCache {
-    int count;
-    int max_count;
+    Py_ssize_t count;
+    Py_ssize_t mask;  /* table size - 1, the size is always a power of 2 */
     __Pyx_CodeObjectCacheEntry* entries;
 };
 
 static struct __Pyx_CodeObjectCache __pyx_code_cache = {0,0,NULL};
 
-static int __pyx_bisect_code_objects(__Pyx_CodeObjectCacheEntry* entries, int count, int code_line);
-static PyCodeObject *__pyx_find_code_object(int code_line);
-static void __pyx_insert_code_object(int code_line, PyCodeObject* code_object);
+static PyCodeObject *__pyx_find_code_object(const char *funcname, int code_line);
+static void __pyx_insert_code_object(const char *funcname, int code_line, PyCodeObject* code_object);
 #endif
 
 /////////////// CodeObjectCache ///////////////
 // Note that errors are simply ignored in the code below.
 // This is just a cache, if a lookup or insertion fails - so what?
+//
+// The cache is an open addressing hash table keyed by the (function name, line) pair.
+// Function names are C string literals, so their addresses identify the call sites.
+// The table is not safe for concurrent access: it relies on the GIL, which is held in
+// __Pyx_AddTraceback(), the only user, to serialise lookups and insertions. Growing the
+// table frees the old one right away.
 
 #if !CYTHON_COMPILING_IN_LIMITED_API
-static int __pyx_bisect_code_objects(__Pyx_CodeObjectCacheEntry* entries, int count, int code_line) {
-    int start = 0, mid = 0, end = count - 1;
-    if (end >= 0 && code_line > entries[end].code_line) {
-        return count;
+#ifndef CYTHON_CODE_CACHE_PRESIZE
+  #define CYTHON_CODE_CACHE_PRESIZE 1
+#endif
+#ifndef __Pyx_CODE_CACHE_SIZE_HINT
+  // Number of traceback sites in the module, provided by the compiler.
+  #define __Pyx_CODE_CACHE_SIZE_HINT 0
+#endif
+
+static CYTHON_INLINE size_t __pyx_code_cache_hash(const char *funcname, int code_line) {
+    size_t h = ((size_t) funcname) >> 3;
+    h ^= ((size_t) (unsigned int) code_line) * (size_t) 0x9E3779B1UL;
+    return h ^ (h >> 16);
+}
+
+static PyCodeObject *__pyx_find_code_object(const char *funcname, int code_line) {
+    PyCodeObject* code_object;
+    __Pyx_CodeObjectCacheEntry* entries = __pyx_code_cache.entries;
+    size_t mask, i;
+    if (unlikely(!code_line) || unlikely(!entries)) {
+        return NULL;
     }
-    while (start < end) {
-        mid = start + (end - start) / 2;
-        if (code_line < entries[mid].code_line) {
-            end = mid;
-        } else if (code_line > entries[mid].code_line) {
-             start = mid + 1;
-        } else {
-            return mid;
+    mask = (size_t) __pyx_code_cache.mask;
+    for (i = __pyx_code_cache_hash(funcname, code_line) & mask; entries[i].funcname; i = (i + 1) & mask) {
+        if (entries[i].code_line == code_line && entries[i].funcname == funcname) {
+            code_object = entries[i].code_object;
+            Py_INCREF(code_object);
+            return code_object;
         }
     }
-    if (code_line <= entries[mid].code_line) {
-        return mid;
-    } else {
-        return mid + 1;
+    return NULL;
+}
+
+static __Pyx_CodeObjectCacheEntry* __pyx_code_cache_slot(
+        __Pyx_CodeObjectCacheEntry* entries, size_t mask, const char *funcname, int code_line) {
+    size_t i;
+    for (i = __pyx_code_cache_hash(funcname, code_line) & mask; entries[i].funcname; i = (i + 1) & mask) {
+        if (entries[i].code_line == code_line && entries[i].funcname == funcname) break;
     }
+    return entries + i;
 }
 
-static PyCodeObject *__pyx_find_code_object(int code_line) {
-    PyCodeObject* code_object;
-    int pos;
-    if (unlikely(!code_line) || unlikely(!__pyx_code_cache.entries)) {
-        return NULL;
+static int __pyx_resize_code_cache(Py_ssize_t new_size) {
+    __Pyx_CodeObjectCacheEntry *old_entries = __pyx_code_cache.entries, *entries, *slot;
+    Py_ssize_t i, old_size = old_entries ? __pyx_code_cache.mask + 1 : 0;
+    entries = (__Pyx_CodeObjectCacheEntry*)PyMem_Malloc(((size_t)new_size) * sizeof(__Pyx_CodeObjectCacheEntry));
+    if (unlikely(!entries)) {
+        return -1;
     }
-    pos = __pyx_bisect_code_objects(__pyx_code_cache.entries, __pyx_code_cache.count, code_line);
-    if (unlikely(pos >= __pyx_code_cache.count) || unlikely(__pyx_code_cache.entries[pos].code_line != code_line)) {
-        return NULL;
+    memset(entries, 0, ((size_t)new_size) * sizeof(__Pyx_CodeObjectCacheEntry));
+    for (i=0; i<old_size; i++) {
+        if (!old_entries[i].funcname) continue;
+        slot = __pyx_code_cache_slot(entries, (size_t) (new_size - 1), old_entries[i].funcname, old_entries[i].code_line);
+        *slot = old_entries[i];
     }
-    code_object = __pyx_code_cache.entries[pos].code_object;
-    Py_INCREF(code_object);
-    return code_object;
+    __pyx_code_cache.entries = entries;
+    __pyx_code_cache.mask = new_size - 1;
+    PyMem_Free(old_entries);
+    return 0;
 }
 
-static void __pyx_insert_code_object(int code_line, PyCodeObject* code_object) {
-    int pos, i;
-    __Pyx_CodeObjectCacheEntry* entries = __pyx_code_cache.entries;
-    if (unlikely(!code_line)) {
+static void __pyx_insert_code_object(const char *funcname, int code_line, PyCodeObject* code_object) {
+    __Pyx_CodeObjectCacheEntry* slot;
+    if (unlikely(!code_line) || unlikely(!funcname)) {
         return;
     }
-    if (unlikely(!entries)) {
-        entries = (__Pyx_CodeObjectCacheEntry*)PyMem_Malloc(64*sizeof(__Pyx_CodeObjectCacheEntry));
-        if (likely(entries)) {
-            __pyx_code_cache.entries = entries;
-            __pyx_code_cache.max_count = 64;
-            __pyx_code_cache.count = 1;
-            entries[0].code_line = code_line;
-            entries[0].code_object = code_object;
-            Py_INCREF(code_object);
-        }
-        return;
+    if (unlikely(!__pyx_code_cache.entries)) {
+        Py_ssize_t size = 64;
+    #if CYTHON_CODE_CACHE_PRESIZE
+        // Most traceback sites never see an exception, so only plan for a fraction of them.
+        while (size < 4096 && size < (__Pyx_CODE_CACHE_SIZE_HINT) / 2) size *= 2;
+    #endif
+        if (unlikely(__pyx_resize_code_cache(size) < 0)) return;
+    } else if (unlikely((__pyx_code_cache.count + 1) * 2 > __pyx_code_cache.mask + 1)) {
+        // Keep the load factor below 1/2 to keep the probe sequences short.
+        if (unlikely(__pyx_resize_code_cache((__pyx_code_cache.mask + 1) * 2) < 0)) return;
     }
-    pos = __pyx_bisect_code_objects(__pyx_code_cache.entries, __pyx_code_cache.count, code_line);
-    if ((pos < __pyx_code_cache.count) && unlikely(__pyx_code_cache.entries[pos].code_line == code_line)) {
-        PyCodeObject* tmp = entries[pos].code_object;
-        entries[pos].code_object = code_object;
+    slot = __pyx_code_cache_slot(__pyx_code_cache.entries, (size_t) __pyx_code_cache.mask, funcname, code_line);
+    Py_INCREF(code_object);
+    if (slot->funcname) {
+        PyCodeObject* tmp = slot->code_object;
+        slot->code_object = code_object;
         Py_DECREF(tmp);
         return;
     }
-    if (__pyx_code_cache.count == __pyx_code_cache.max_count) {
-        int new_max = __pyx_code_cache.max_count + 64;
-        entries = (__Pyx_CodeObjectCacheEntry*)PyMem_Realloc(
-            __pyx_code_cache.entries, ((size_t)new_max) * sizeof(__Pyx_CodeObjectCacheEntry));
-        if (unlikely(!entries)) {
-            return;
-        }
-        __pyx_code_cache.entries = entries;
-        __pyx_code_cache.max_count = new_max;
-    }
-    for (i=__pyx_code_cache.count; i>pos; i--) {
-        entries[i] = entries[i-1];
-    }
-    entries[pos].code_line = code_line;
-    entries[pos].code_object = code_object;
+    slot->code_object = code_object;
+    slot->code_line = code_line;
+    slot->funcname = funcname;
     __pyx_code_cache.count++;
-    Py_INCREF(code_object);
 }
 #endif
 
@@ -1363,12 +1383,14 @@ static void __pyx_insert_code_object(int code_line, PyCodeObject* code_object) {
   #if !CYTHON_COMPILING_IN_LIMITED_API
   if (__pyx_code_cache.entries) {
       __Pyx_CodeObjectCacheEntry* entries = __pyx_code_cache.entries;
-      int i, count = __pyx_code_cache.count;
+      Py_ssize_t i, size = __pyx_code_cache.mask + 1;
       __pyx_code_cache.count = 0;
-      __pyx_code_cache.max_count = 0;
+      __pyx_code_cache.mask = 0;
       __pyx_code_cache.entries = NULL;
-      for (i=0; i<count; i++) {
-          Py_DECREF(entries[i].code_object);
+      for (i=0; i<size; i++) {
+          if (entries[i].funcname) {
+              Py_DECREF(entries[i].code_object);
+          }
       }
       PyMem_Free(entries);
   }
@@ -1621,8 +1643,24 @@ __Pyx_FastGilFuncInit();
 #define __Pyx_FastGIL_Forget()
 #define __Pyx_FastGilFuncInit()
 
+/////////////// ThreadLocal.proto ///////////////
+//@proto_block: utility_code_proto_before_types
+
+#ifdef WITH_THREAD
+  #ifndef CYTHON_THREAD_LOCAL
+    #if __STDC_VERSION__ >= 201112
+      #define CYTHON_THREAD_LOCAL _Thread_local
+    #elif defined(__GNUC__)
+      #define CYTHON_THREAD_LOCAL __thread
+    #elif defined(_MSC_VER)
+      #define CYTHON_THREAD_LOCAL __declspec(thread)
+    #endif
+  #endif
+#endif
+
 /////////////// FastGil.proto ///////////////
 //@proto_block: utility_code_proto_before_types
+//@requires: ThreadLocal
 
 #if CYTHON_FAST_GIL
 
@@ -1648,18 +1686,6 @@ static void __Pyx_FastGilFuncInit(void);
 #define __Pyx_FastGIL_Remember __Pyx_FastGilFuncs.FastGIL_Remember
 #define __Pyx_FastGIL_Forget __Pyx_FastGilFuncs.FastGIL_Forget
 
-#ifdef WITH_THREAD
-  #ifndef CYTHON_THREAD_LOCAL
-    #if __STDC_VERSION__ >= 201112
-      #define CYTHON_THREAD_LOCAL _Thread_local
-    #elif defined(__GNUC__)
-      #define CYTHON_THREAD_LOCAL __thread
-    #elif defined(_MSC_VER)
-      #define CYTHON_THREAD_LOCAL __declspec(thread)
-    #endif
-  #endif
-#endif
-
 #else
 #define __Pyx_PyGILState_Ensure PyGILState_Ensure
 #define __Pyx_PyGILState_Release PyGILState_Release
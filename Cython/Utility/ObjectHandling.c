@@ -1544,19 +1544,26 @@ static int __Pyx_SetNewInClass(PyObject *ns, PyObject *name, PyObject *value) {
 //@substitute: naming
 
 #if CYTHON_USE_DICT_VERSIONS
+// Two level cache: a value from the module dict stays valid as long as the module dict
+// is unchanged, a value from the builtins dict additionally requires the builtins dict
+// to be unchanged.  'builtins_version' is 0 for values from the module dict.
 #define __Pyx_GetModuleGlobalName(var, name)  { \
     static PY_UINT64_T __pyx_dict_version = 0; \
+    static PY_UINT64_T __pyx_builtins_version = 0; \
     static PyObject *__pyx_dict_cached_value = NULL; \
-    (var) = (likely(__pyx_dict_version == __PYX_GET_DICT_VERSION($moddict_cname))) ? \
-        (likely(__pyx_dict_cached_value) ? __Pyx_NewRef(__pyx_dict_cached_value) : __Pyx_GetBuiltinName(name)) : \
-        __Pyx__GetModuleGlobalName(name, &__pyx_dict_version, &__pyx_dict_cached_value); \
+    (var) = (likely(__pyx_dict_version == __PYX_GET_DICT_VERSION($moddict_cname)) && likely(__pyx_dict_cached_value) && \
+             (likely(!__pyx_builtins_version) || likely(__pyx_builtins_version == __Pyx_BuiltinsDictVersion()))) ? \
+        __Pyx_NewRef(__pyx_dict_cached_value) : \
+        __Pyx__GetModuleGlobalName(name, &__pyx_dict_version, &__pyx_dict_cached_value, &__pyx_builtins_version); \
 }
 #define __Pyx_GetModuleGlobalNameUncached(var, name)  { \
-    PY_UINT64_T __pyx_dict_version; \
+    PY_UINT64_T __pyx_dict_version, __pyx_builtins_version; \
     PyObject *__pyx_dict_cached_value; \
-    (var) = __Pyx__GetModuleGlobalName(name, &__pyx_dict_version, &__pyx_dict_cached_value); \
+    (var) = __Pyx__GetModuleGlobalName(name, &__pyx_dict_version, &__pyx_dict_cached_value, &__pyx_builtins_version); \
 }
-static PyObject *__Pyx__GetModuleGlobalName(PyObject *name, PY_UINT64_T *dict_version, PyObject **dict_cached_value); /*proto*/
+#define __Pyx_BuiltinsDictVersion()  __PYX_GET_DICT_VERSION(PyModule_GetDict($builtins_cname))
+static PyObject *__Pyx__GetModuleGlobalName(PyObject *name, PY_UINT64_T *dict_version, PyObject **dict_cached_value,
+                                            PY_UINT64_T *builtins_version); /*proto*/
 #else
 #define __Pyx_GetModuleGlobalName(var, name)  (var) = __Pyx__GetModuleGlobalName(name)
 #define __Pyx_GetModuleGlobalNameUncached(var, name)  (var) = __Pyx__GetModuleGlobalName(name)
@@ -1569,7 +1576,8 @@ static CYTHON_INLINE PyObject *__Pyx__GetModuleGlobalName(PyObject *name); /*pro
 //@substitute: naming
 
 #if CYTHON_USE_DICT_VERSIONS
-static PyObject *__Pyx__GetModuleGlobalName(PyObject *name, PY_UINT64_T *dict_version, PyObject **dict_cached_value)
+static PyObject *__Pyx__GetModuleGlobalName(PyObject *name, PY_UINT64_T *dict_version, PyObject **dict_cached_value,
+                                            PY_UINT64_T *builtins_version)
 #else
 static CYTHON_INLINE PyObject *__Pyx__GetModuleGlobalName(PyObject *name)
 #endif
@@ -1581,10 +1589,27 @@ static CYTHON_INLINE PyObject *__Pyx__GetModuleGlobalName(PyObject *name)
     result = _PyDict_GetItem_KnownHash($moddict_cname, name, ((PyASCIIObject *) name)->hash);
     __PYX_UPDATE_DICT_CACHE($moddict_cname, result, *dict_cached_value, *dict_version)
     if (likely(result)) {
+#if CYTHON_USE_DICT_VERSIONS
+        *builtins_version = 0;
+#endif
         return __Pyx_NewRef(result);
     } else if (unlikely(PyErr_Occurred())) {
         return NULL;
     }
+#if CYTHON_USE_DICT_VERSIONS
+    {
+        // Look up and cache builtins directly, to avoid going through the module's getattr.
+        PyObject *builtins = PyModule_GetDict($builtins_cname);
+        result = _PyDict_GetItem_KnownHash(builtins, name, ((PyASCIIObject *) name)->hash);
+        if (likely(result)) {
+            *dict_cached_value = result;
+            *builtins_version = __PYX_GET_DICT_VERSION(builtins);
+            return __Pyx_NewRef(result);
+        } else if (unlikely(PyErr_Occurred())) {
+            return NULL;
+        }
+    }
+#endif
 #elif CYTHON_COMPILING_IN_LIMITED_API
     if (unlikely(!$module_cname)) {
         return NULL;
@@ -1596,6 +1621,9 @@ static CYTHON_INLINE PyObject *__Pyx__GetModuleGlobalName(PyObject *name)
 #else
     result = PyDict_GetItem($moddict_cname, name);
     __PYX_UPDATE_DICT_CACHE($moddict_cname, result, *dict_cached_value, *dict_version)
+#if CYTHON_USE_DICT_VERSIONS
+    *builtins_version = 0;
+#endif
     if (likely(result)) {
         return __Pyx_NewRef(result);
     }
@@ -1603,6 +1631,9 @@ static CYTHON_INLINE PyObject *__Pyx__GetModuleGlobalName(PyObject *name)
 #else
     result = PyObject_GetItem($moddict_cname, name);
     __PYX_UPDATE_DICT_CACHE($moddict_cname, result, *dict_cached_value, *dict_version)
+#if CYTHON_USE_DICT_VERSIONS
+    *builtins_version = 0;
+#endif
     if (likely(result)) {
         return __Pyx_NewRef(result);
     }
@@ -1967,6 +1998,236 @@ try_unpack:
 }
 
 
+/////////////// PyObjectInlineCache.proto ///////////////
+//@requires: PyDictVersioning
+
+// Per call site caches for attribute lookups on objects with generic attribute access.
+// An entry remembers what the type lookup of the name found for one type, as long as
+// the version tag of the type does not change, i.e. the type and its bases are unmodified.
+
+#ifndef __PYX_INLINE_CACHE_SIZE
+#define __PYX_INLINE_CACHE_SIZE 4
+#endif
+
+#if CYTHON_USE_INLINE_CACHES
+enum __Pyx_InlineCacheKind {
+    __Pyx_INLINE_CACHE_EMPTY = 0,
+    __Pyx_INLINE_CACHE_METHOD,       /* function-like non-data descriptor */
+    __Pyx_INLINE_CACHE_DATA_DESCR,   /* data descriptor, takes precedence over the instance dict */
+    __Pyx_INLINE_CACHE_OTHER         /* other descriptor or class attribute, or nothing (descr == NULL) */
+};
+
+typedef struct {
+    unsigned int type_version;
+    unsigned int kind;
+    // Borrowed reference, kept alive by the type for as long as its version tag is unchanged.
+    PyObject *descr;
+#if CYTHON_USE_DICT_VERSIONS
+    // Version of the last instance dict that was found not to contain the name.
+    PY_UINT64_T dict_version;
+#endif
+} __Pyx_InlineCacheEntry;
+
+typedef struct {
+    __Pyx_InlineCacheEntry entries[__PYX_INLINE_CACHE_SIZE];
+    unsigned int next;
+} __Pyx_InlineCache;
+
+static __Pyx_InlineCacheEntry *__Pyx_InlineCache_Lookup(PyTypeObject *tp, PyObject *name, __Pyx_InlineCache *cache); /*proto*/
+static PyObject *__Pyx_InlineCache_GetInstanceAttr(PyObject *obj, PyObject *name, __Pyx_InlineCacheEntry *entry); /*proto*/
+#endif
+
+/////////////// PyObjectInlineCache ///////////////
+
+#if CYTHON_USE_INLINE_CACHES
+static __Pyx_InlineCacheEntry *__Pyx_InlineCache_Lookup(PyTypeObject *tp, PyObject *name, __Pyx_InlineCache *cache) {
+    __Pyx_InlineCacheEntry *entry;
+    PyObject *descr;
+    unsigned int i, kind;
+    if (unlikely(tp->tp_getattro != PyObject_GenericGetAttr) || unlikely(!tp->tp_dict))
+        return NULL;
+    if (likely(__Pyx_PyType_HasFeature(tp, Py_TPFLAGS_VALID_VERSION_TAG))) {
+        for (i = 0; i < __PYX_INLINE_CACHE_SIZE; i++) {
+            entry = &cache->entries[i];
+            if (likely(entry->type_version == tp->tp_version_tag) && likely(entry->kind))
+                return entry;
+        }
+    }
+
+    // Cache miss, the type lookup also assigns a version tag to the type if possible.
+    descr = _PyType_Lookup(tp, name);
+    if (unlikely(!__Pyx_PyType_HasFeature(tp, Py_TPFLAGS_VALID_VERSION_TAG)))
+        return NULL;
+    if (!descr) {
+        kind = __Pyx_INLINE_CACHE_OTHER;
+    } else if (
+#if defined(Py_TPFLAGS_METHOD_DESCRIPTOR) && Py_TPFLAGS_METHOD_DESCRIPTOR
+            // Same as __Pyx_PyObject_GetMethod(), e.g. fused functions bind differently.
+            __Pyx_PyType_HasFeature(Py_TYPE(descr), Py_TPFLAGS_METHOD_DESCRIPTOR)
+#else
+            PyFunction_Check(descr) || __Pyx_IS_TYPE(descr, &PyMethodDescr_Type)
+#ifdef __Pyx_CyFunction_USED
+            || __Pyx_CyFunction_Check(descr)
+#endif
+#endif
+            ) {
+        kind = __Pyx_INLINE_CACHE_METHOD;
+    } else if (__Pyx_PyType_HasFeature(Py_TYPE(descr), Py_TPFLAGS_HEAPTYPE)) {
+        // The descriptor protocol of mutable types can change without a new version tag of 'tp'.
+        return NULL;
+    } else if (Py_TYPE(descr)->tp_descr_get && PyDescr_IsData(descr)) {
+        kind = __Pyx_INLINE_CACHE_DATA_DESCR;
+    } else {
+        kind = __Pyx_INLINE_CACHE_OTHER;
+    }
+    entry = &cache->entries[cache->next];
+    cache->next = (cache->next + 1) % __PYX_INLINE_CACHE_SIZE;
+    entry->type_version = tp->tp_version_tag;
+    entry->kind = kind;
+    entry->descr = descr;
+#if CYTHON_USE_DICT_VERSIONS
+    entry->dict_version = __PYX_DICT_VERSION_INIT;
+#endif
+    return entry;
+}
+
+// Returns a new reference to the value in the instance dict, or NULL if it is not there.
+static PyObject *__Pyx_InlineCache_GetInstanceAttr(PyObject *obj, PyObject *name, __Pyx_InlineCacheEntry *entry) {
+    PyObject **dictptr, *dict, *attr;
+    Py_ssize_t offset = Py_TYPE(obj)->tp_dictoffset;
+    if (!offset)
+        return NULL;
+    dictptr = likely(offset > 0) ? (PyObject **) ((char *)obj + offset) : _PyObject_GetDictPtr(obj);
+    dict = dictptr ? *dictptr : NULL;
+    if (!dict)
+        return NULL;
+#if CYTHON_USE_DICT_VERSIONS
+    // Dict versions are unique across all dicts, so this also works for other instances.
+    if (__PYX_GET_DICT_VERSION(dict) == entry->dict_version)
+        return NULL;
+#endif
+    Py_INCREF(dict);
+    attr = __Pyx_PyDict_GetItemStr(dict, name);
+    if (attr) {
+        Py_INCREF(attr);
+#if CYTHON_USE_DICT_VERSIONS
+    } else if (likely(!PyErr_Occurred())) {
+        entry->dict_version = __PYX_GET_DICT_VERSION(dict);
+#endif
+    }
+    Py_DECREF(dict);
+    return attr;
+}
+#endif
+
+
+/////////////// PyObjectGetAttrStrCached.proto ///////////////
+//@requires: PyObjectGetAttrStr
+//@requires: PyObjectInlineCache
+
+#if CYTHON_USE_INLINE_CACHES
+#define __Pyx_PyObject_GetAttrStrCached(var, obj, name)  { \
+    static __Pyx_InlineCache __pyx_inline_cache; \
+    (var) = __Pyx__PyObject_GetAttrStrCached(obj, name, &__pyx_inline_cache); \
+}
+static PyObject *__Pyx__PyObject_GetAttrStrCached(PyObject *obj, PyObject *name, __Pyx_InlineCache *cache); /*proto*/
+#else
+#define __Pyx_PyObject_GetAttrStrCached(var, obj, name)  (var) = __Pyx_PyObject_GetAttrStr(obj, name)
+#endif
+
+/////////////// PyObjectGetAttrStrCached ///////////////
+
+#if CYTHON_USE_INLINE_CACHES
+static PyObject *__Pyx__PyObject_GetAttrStrCached(PyObject *obj, PyObject *name, __Pyx_InlineCache *cache) {
+    PyObject *descr, *attr;
+    descrgetfunc f;
+    __Pyx_InlineCacheEntry *entry = __Pyx_InlineCache_Lookup(Py_TYPE(obj), name, cache);
+    if (unlikely(!entry))
+        return __Pyx_PyObject_GetAttrStr(obj, name);
+    descr = entry->descr;
+    if (unlikely(!descr)) {
+        attr = __Pyx_InlineCache_GetInstanceAttr(obj, name, entry);
+        // Let the generic lookup raise the AttributeError.
+        return (attr || PyErr_Occurred()) ? attr : __Pyx_PyObject_GetAttrStr(obj, name);
+    }
+    // The descriptor may be the last reference to itself if a getter or the dict lookup changes the type.
+    Py_INCREF(descr);
+    if (entry->kind == __Pyx_INLINE_CACHE_DATA_DESCR) {
+        attr = Py_TYPE(descr)->tp_descr_get(descr, obj, (PyObject *)Py_TYPE(obj));
+    } else {
+        attr = __Pyx_InlineCache_GetInstanceAttr(obj, name, entry);
+        if (!attr && likely(!PyErr_Occurred())) {
+            f = Py_TYPE(descr)->tp_descr_get;
+            attr = f ? f(descr, obj, (PyObject *)Py_TYPE(obj)) : __Pyx_NewRef(descr);
+        }
+    }
+    Py_DECREF(descr);
+    return attr;
+}
+#endif
+
+
+/////////////// PyObjectGetMethodCached.proto ///////////////
+//@requires: PyObjectGetMethod
+//@requires: PyObjectInlineCache
+
+// Same as __Pyx_PyObject_GetMethod(), 'var' is set to 1 if 'method' is an unbound method of 'obj'.
+#if CYTHON_USE_INLINE_CACHES
+#define __Pyx_PyObject_GetMethodCached(var, obj, name, method)  { \
+    static __Pyx_InlineCache __pyx_inline_cache; \
+    (var) = __Pyx__PyObject_GetMethodCached(obj, name, method, &__pyx_inline_cache); \
+}
+static int __Pyx__PyObject_GetMethodCached(PyObject *obj, PyObject *name, PyObject **method, __Pyx_InlineCache *cache); /*proto*/
+#else
+#define __Pyx_PyObject_GetMethodCached(var, obj, name, method)  (var) = __Pyx_PyObject_GetMethod(obj, name, method)
+#endif
+
+/////////////// PyObjectGetMethodCached ///////////////
+
+#if CYTHON_USE_INLINE_CACHES
+static int __Pyx__PyObject_GetMethodCached(PyObject *obj, PyObject *name, PyObject **method, __Pyx_InlineCache *cache) {
+    PyObject *descr, *attr;
+    descrgetfunc f;
+    unsigned int kind;
+    __Pyx_InlineCacheEntry *entry = __Pyx_InlineCache_Lookup(Py_TYPE(obj), name, cache);
+    if (unlikely(!entry))
+        return __Pyx_PyObject_GetMethod(obj, name, method);
+    descr = entry->descr;
+    kind = entry->kind;
+    if (unlikely(!descr)) {
+        attr = __Pyx_InlineCache_GetInstanceAttr(obj, name, entry);
+        *method = (attr || PyErr_Occurred()) ? attr : __Pyx_PyObject_GetAttrStr(obj, name);
+        return 0;
+    }
+    Py_INCREF(descr);
+    if (kind == __Pyx_INLINE_CACHE_DATA_DESCR) {
+        *method = Py_TYPE(descr)->tp_descr_get(descr, obj, (PyObject *)Py_TYPE(obj));
+        Py_DECREF(descr);
+        return 0;
+    }
+    attr = __Pyx_InlineCache_GetInstanceAttr(obj, name, entry);
+    if (attr || unlikely(PyErr_Occurred())) {
+        *method = attr;
+        Py_DECREF(descr);
+        return 0;
+    }
+    if (likely(kind == __Pyx_INLINE_CACHE_METHOD)) {
+        // Cache hit for a method: no bound method object needed.
+        *method = descr;
+        return 1;
+    }
+    f = Py_TYPE(descr)->tp_descr_get;
+    if (f) {
+        *method = f(descr, obj, (PyObject *)Py_TYPE(obj));
+        Py_DECREF(descr);
+    } else {
+        *method = descr;
+    }
+    return 0;
+}
+#endif
+
+
 /////////////// UnpackUnboundCMethod.proto ///////////////
 
 typedef struct {
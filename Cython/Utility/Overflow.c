@@ -13,8 +13,12 @@ accuracy (a low rate of falsely "detected" overflows are acceptable,
 undetected overflows are not).
 
 
+Where the C compiler provides them, the basecases use the __builtin_*_overflow()
+intrinsics, which compile to the arithmetic instruction followed by a branch on the
+overflow/carry flag.  If the compiler supports __int128, integer types of that size
+are checked as well.
+
 TODO: Hook up checking.
-TODO: Conditionally support 128-bit with intmax_t?
 */
 
 /////////////// Common.proto ///////////////
@@ -54,6 +58,10 @@ static int __Pyx_check_twos_complement(void) {
 #  define __PYX_HAVE_BUILTIN_OVERFLOW
 #endif
 
+#if defined(__SIZEOF_INT128__) && !defined(__PYX_HAVE_INT128)
+#  define __PYX_HAVE_INT128
+#endif
+
 #if defined(__GNUC__)
 #  define __Pyx_is_constant(x) (__builtin_constant_p(x))
 #elif defined(__has_builtin)
@@ -74,7 +82,7 @@ if (unlikely(__Pyx_check_twos_complement())) {
 
 /////////////// BaseCaseUnsigned.proto ///////////////
 
-{{if UINT == "long long"}}#ifdef HAVE_LONG_LONG{{endif}}
+{{if UINT == "unsigned long long"}}#ifdef HAVE_LONG_LONG{{elif UINT == "unsigned __int128"}}#ifdef __PYX_HAVE_INT128{{endif}}
 
 static CYTHON_INLINE {{UINT}} __Pyx_add_{{NAME}}_checking_overflow({{UINT}} a, {{UINT}} b, int *overflow);
 static CYTHON_INLINE {{UINT}} __Pyx_sub_{{NAME}}_checking_overflow({{UINT}} a, {{UINT}} b, int *overflow);
@@ -91,11 +99,11 @@ static CYTHON_INLINE {{UINT}} __Pyx_mul_const_{{NAME}}_checking_overflow({{UINT}
 #endif
 #define __Pyx_div_const_{{NAME}}_checking_overflow __Pyx_div_{{NAME}}_checking_overflow
 
-{{if UINT == "long long"}}#endif{{endif}}
+{{if UINT in ("unsigned long long", "unsigned __int128")}}#endif{{endif}}
 
 /////////////// BaseCaseUnsigned ///////////////
 
-{{if UINT == "long long"}}#ifdef HAVE_LONG_LONG{{endif}}
+{{if UINT == "unsigned long long"}}#ifdef HAVE_LONG_LONG{{elif UINT == "unsigned __int128"}}#ifdef __PYX_HAVE_INT128{{endif}}
 
 #if defined(__PYX_HAVE_BUILTIN_OVERFLOW)
 
@@ -181,12 +189,12 @@ static CYTHON_INLINE {{UINT}} __Pyx_div_{{NAME}}_checking_overflow({{UINT}} a, {
     return a / b;
 }
 
-{{if UINT == "long long"}}#endif{{endif}}
+{{if UINT in ("unsigned long long", "unsigned __int128")}}#endif{{endif}}
 
 
 /////////////// BaseCaseSigned.proto ///////////////
 
-{{if INT == "long long"}}#ifdef HAVE_LONG_LONG{{endif}}
+{{if INT == "long long"}}#ifdef HAVE_LONG_LONG{{elif INT == "__int128"}}#ifdef __PYX_HAVE_INT128{{endif}}
 
 static CYTHON_INLINE {{INT}} __Pyx_add_{{NAME}}_checking_overflow({{INT}} a, {{INT}} b, int *overflow);
 static CYTHON_INLINE {{INT}} __Pyx_sub_{{NAME}}_checking_overflow({{INT}} a, {{INT}} b, int *overflow);
@@ -204,11 +212,11 @@ static CYTHON_INLINE {{INT}} __Pyx_mul_const_{{NAME}}_checking_overflow({{INT}}
 #endif
 #define __Pyx_div_const_{{NAME}}_checking_overflow __Pyx_div_{{NAME}}_checking_overflow
 
-{{if INT == "long long"}}#endif{{endif}}
+{{if INT in ("long long", "__int128")}}#endif{{endif}}
 
 /////////////// BaseCaseSigned ///////////////
 
-{{if INT == "long long"}}#ifdef HAVE_LONG_LONG{{endif}}
+{{if INT == "long long"}}#ifdef HAVE_LONG_LONG{{elif INT == "__int128"}}#ifdef __PYX_HAVE_INT128{{endif}}
 
 #if defined(__PYX_HAVE_BUILTIN_OVERFLOW)
 
@@ -321,7 +329,7 @@ static CYTHON_INLINE {{INT}} __Pyx_div_{{NAME}}_checking_overflow({{INT}} a, {{I
     return ({{INT}}) ((unsigned {{INT}}) a / (unsigned {{INT}}) b);
 }
 
-{{if INT == "long long"}}#endif{{endif}}
+{{if INT in ("long long", "__int128")}}#endif{{endif}}
 
 
 /////////////// SizeCheck.init ///////////////
@@ -338,6 +346,9 @@ static int __Pyx_check_sane_{{NAME}}(void) {
     if (((sizeof({{TYPE}}) <= sizeof(int)) ||
 #ifdef HAVE_LONG_LONG
             (sizeof({{TYPE}}) == sizeof(PY_LONG_LONG)) ||
+#endif
+#ifdef __PYX_HAVE_INT128
+            (sizeof({{TYPE}}) == sizeof(__int128)) ||
 #endif
             (sizeof({{TYPE}}) == sizeof(long)))) {
         return 0;
@@ -366,6 +377,10 @@ static CYTHON_INLINE {{TYPE}} __Pyx_{{BINOP}}_{{NAME}}_checking_overflow({{TYPE}
 #ifdef HAVE_LONG_LONG
         } else if ((sizeof({{TYPE}}) == sizeof(unsigned PY_LONG_LONG))) {
             return ({{TYPE}}) __Pyx_{{BINOP}}_unsigned_long_long_checking_overflow(a, b, overflow);
+#endif
+#ifdef __PYX_HAVE_INT128
+        } else if ((sizeof({{TYPE}}) == sizeof(unsigned __int128))) {
+            return ({{TYPE}}) __Pyx_{{BINOP}}_pyx_uint128_checking_overflow(a, b, overflow);
 #endif
         } else {
             abort(); return 0; /* handled elsewhere */
@@ -378,6 +393,10 @@ static CYTHON_INLINE {{TYPE}} __Pyx_{{BINOP}}_{{NAME}}_checking_overflow({{TYPE}
 #ifdef HAVE_LONG_LONG
         } else if ((sizeof({{TYPE}}) == sizeof(PY_LONG_LONG))) {
             return ({{TYPE}}) __Pyx_{{BINOP}}_long_long_checking_overflow(a, b, overflow);
+#endif
+#ifdef __PYX_HAVE_INT128
+        } else if ((sizeof({{TYPE}}) == sizeof(__int128))) {
+            return ({{TYPE}}) __Pyx_{{BINOP}}_pyx_int128_checking_overflow(a, b, overflow);
 #endif
         } else {
             abort(); return 0; /* handled elsewhere */
@@ -0,0 +1,406 @@
+/////////////// WorkStealing.proto ///////////////
+
+// A work stealing scheduler for 'prange(..., backend="threads")' that does not
+// depend on OpenMP.  The iteration space of a loop is split into one range per
+// thread.  Threads take chunks from the front of their own range and, once it
+// is empty, steal the back half of the range of another thread.
+//
+// Each module keeps a pool of worker threads that is started on first use and
+// joined at interpreter exit.  The thread that runs the loop takes part as
+// thread 0.  Loops started while the pool is busy (nested loops, or loops in
+// other threads) run serially.
+
+typedef struct __pyx_ws_loop __pyx_ws_loop;
+typedef void (*__pyx_ws_body)(void *context, __pyx_ws_loop *loop, int thread_id);
+
+static void __Pyx_WorkStealing_Run(__pyx_ws_body body, void *context, Py_ssize_t nsteps,
+                                   int num_threads, Py_ssize_t chunksize); /*proto*/
+static int __Pyx_WorkStealing_Next(__pyx_ws_loop *loop, int thread_id,
+                                   Py_ssize_t *begin, Py_ssize_t *end); /*proto*/
+static void __Pyx_WorkStealing_Lock(__pyx_ws_loop *loop); /*proto*/
+static void __Pyx_WorkStealing_Unlock(__pyx_ws_loop *loop); /*proto*/
+
+/////////////// WorkStealing ///////////////
+
+#if defined(_WIN32) || defined(WIN32) || defined(MS_WINDOWS)
+  #include <windows.h>
+  #include <process.h>
+  #define __PYX_WS_WINDOWS 1
+  typedef CRITICAL_SECTION __pyx_ws_mutex;
+  typedef CONDITION_VARIABLE __pyx_ws_cond;
+  #define __pyx_ws_mutex_init(m)     InitializeCriticalSection(m)
+  #define __pyx_ws_mutex_destroy(m)  DeleteCriticalSection(m)
+  #define __pyx_ws_mutex_lock(m)     EnterCriticalSection(m)
+  #define __pyx_ws_mutex_trylock(m)  TryEnterCriticalSection(m)
+  #define __pyx_ws_mutex_unlock(m)   LeaveCriticalSection(m)
+  #define __pyx_ws_cond_init(c)      InitializeConditionVariable(c)
+  #define __pyx_ws_cond_wait(c, m)   SleepConditionVariableCS(c, m, INFINITE)
+  #define __pyx_ws_cond_broadcast(c) WakeAllConditionVariable(c)
+  typedef HANDLE __pyx_ws_thread;
+#else
+  #include <pthread.h>
+  #include <unistd.h>
+  #define __PYX_WS_WINDOWS 0
+  typedef pthread_mutex_t __pyx_ws_mutex;
+  typedef pthread_cond_t __pyx_ws_cond;
+  #define __pyx_ws_mutex_init(m)     pthread_mutex_init(m, NULL)
+  #define __pyx_ws_mutex_destroy(m)  pthread_mutex_destroy(m)
+  #define __pyx_ws_mutex_lock(m)     pthread_mutex_lock(m)
+  #define __pyx_ws_mutex_trylock(m)  (pthread_mutex_trylock(m) == 0)
+  #define __pyx_ws_mutex_unlock(m)   pthread_mutex_unlock(m)
+  #define __pyx_ws_cond_init(c)      pthread_cond_init(c, NULL)
+  #define __pyx_ws_cond_wait(c, m)   pthread_cond_wait(c, m)
+  #define __pyx_ws_cond_broadcast(c) pthread_cond_broadcast(c)
+  typedef pthread_t __pyx_ws_thread;
+#endif
+
+typedef struct {
+    __pyx_ws_mutex lock;
+    Py_ssize_t begin, end;
+    // keep the ranges of different threads in different cache lines
+    char padding[64];
+} __pyx_ws_range;
+
+struct __pyx_ws_loop {
+    __pyx_ws_range *ranges;
+    int num_threads;
+    Py_ssize_t chunksize;
+    // serialises the reductions and lastprivates of the loop body
+    __pyx_ws_mutex lock;
+};
+
+static struct {
+    __pyx_ws_mutex lock;   // protects all fields below
+    __pyx_ws_cond start;   // signalled when a new loop is published
+    __pyx_ws_cond done;    // signalled when the last worker finished a loop
+    __pyx_ws_mutex busy;   // held while a loop runs in the pool
+    int num_workers;
+    int shutdown;          // set at interpreter exit, makes the workers return
+    __pyx_ws_thread *threads;
+    int threads_allocated;
+    unsigned long generation;
+    unsigned long start_generation;
+    int num_running;
+    int num_threads;
+    __pyx_ws_body body;
+    void *context;
+    __pyx_ws_loop *loop;
+} __pyx_ws_pool;
+
+static void __pyx_ws_pool_reset(void) {
+    __pyx_ws_mutex_init(&__pyx_ws_pool.lock);
+    __pyx_ws_mutex_init(&__pyx_ws_pool.busy);
+    __pyx_ws_cond_init(&__pyx_ws_pool.start);
+    __pyx_ws_cond_init(&__pyx_ws_pool.done);
+    __pyx_ws_pool.num_workers = 0;
+    __pyx_ws_pool.num_running = 0;
+    __pyx_ws_pool.shutdown = 0;
+}
+
+static void __pyx_ws_pool_shutdown(void) {
+    int i, num_workers;
+    // A loop that still runs in a daemon thread keeps the pool alive.
+    if (!__pyx_ws_mutex_trylock(&__pyx_ws_pool.busy)) return;
+    __pyx_ws_mutex_lock(&__pyx_ws_pool.lock);
+    __pyx_ws_pool.shutdown = 1;
+    __pyx_ws_pool.generation++;
+    __pyx_ws_cond_broadcast(&__pyx_ws_pool.start);
+    num_workers = __pyx_ws_pool.num_workers;
+    __pyx_ws_pool.num_workers = 0;
+    __pyx_ws_mutex_unlock(&__pyx_ws_pool.lock);
+
+    for (i = 0; i < num_workers; i++) {
+#if __PYX_WS_WINDOWS
+        WaitForSingleObject(__pyx_ws_pool.threads[i], INFINITE);
+        CloseHandle(__pyx_ws_pool.threads[i]);
+#else
+        pthread_join(__pyx_ws_pool.threads[i], NULL);
+#endif
+    }
+    free(__pyx_ws_pool.threads);
+    __pyx_ws_pool.threads = NULL;
+    __pyx_ws_pool.threads_allocated = 0;
+    __pyx_ws_mutex_unlock(&__pyx_ws_pool.busy);
+}
+
+#if __PYX_WS_WINDOWS
+static INIT_ONCE __pyx_ws_pool_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK __pyx_ws_pool_init_once(PINIT_ONCE once, PVOID param, PVOID *context) {
+    (void) once; (void) param; (void) context;
+    __pyx_ws_pool_reset();
+    (void) Py_AtExit(__pyx_ws_pool_shutdown);
+    return TRUE;
+}
+
+static void __pyx_ws_pool_init(void) {
+    InitOnceExecuteOnce(&__pyx_ws_pool_once, __pyx_ws_pool_init_once, NULL, NULL);
+}
+
+static int __pyx_ws_cpu_count(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int) info.dwNumberOfProcessors;
+}
+#else
+static pthread_once_t __pyx_ws_pool_once = PTHREAD_ONCE_INIT;
+
+static void __pyx_ws_pool_init_once(void) {
+    __pyx_ws_pool_reset();
+    // The worker threads do not survive a fork(), start new ones in the child.
+    pthread_atfork(NULL, NULL, __pyx_ws_pool_reset);
+    (void) Py_AtExit(__pyx_ws_pool_shutdown);
+}
+
+static void __pyx_ws_pool_init(void) {
+    pthread_once(&__pyx_ws_pool_once, __pyx_ws_pool_init_once);
+}
+
+static int __pyx_ws_cpu_count(void) {
+#ifdef _SC_NPROCESSORS_ONLN
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int) count : 1;
+#else
+    return 1;
+#endif
+}
+#endif
+
+static void __pyx_ws_worker_loop(int worker_id) {
+    unsigned long seen;
+    __pyx_ws_mutex_lock(&__pyx_ws_pool.lock);
+    seen = __pyx_ws_pool.start_generation;
+    for (;;) {
+        while (__pyx_ws_pool.generation == seen)
+            __pyx_ws_cond_wait(&__pyx_ws_pool.start, &__pyx_ws_pool.lock);
+        seen = __pyx_ws_pool.generation;
+        if (__pyx_ws_pool.shutdown) break;
+        if (worker_id < __pyx_ws_pool.num_threads) {
+            __pyx_ws_body body = __pyx_ws_pool.body;
+            void *context = __pyx_ws_pool.context;
+            __pyx_ws_loop *loop = __pyx_ws_pool.loop;
+            __pyx_ws_mutex_unlock(&__pyx_ws_pool.lock);
+            body(context, loop, worker_id);
+            __pyx_ws_mutex_lock(&__pyx_ws_pool.lock);
+            if (--__pyx_ws_pool.num_running == 0)
+                __pyx_ws_cond_broadcast(&__pyx_ws_pool.done);
+        }
+    }
+    __pyx_ws_mutex_unlock(&__pyx_ws_pool.lock);
+}
+
+#if __PYX_WS_WINDOWS
+static unsigned __stdcall __pyx_ws_worker(void *arg) {
+    __pyx_ws_worker_loop((int) (Py_ssize_t) arg);
+    return 0;
+}
+#else
+static void *__pyx_ws_worker(void *arg) {
+    __pyx_ws_worker_loop((int) (Py_ssize_t) arg);
+    return NULL;
+}
+#endif
+
+// Start workers until the pool can run 'num_threads' threads.  Must be called
+// with the pool lock held.  Returns the number of threads actually available.
+static int __pyx_ws_start_workers(int num_threads) {
+    __pyx_ws_pool.start_generation = __pyx_ws_pool.generation;
+    while (__pyx_ws_pool.num_workers < num_threads - 1) {
+        void *arg = (void *) (Py_ssize_t) (__pyx_ws_pool.num_workers + 1);
+        __pyx_ws_thread thread;
+        if (__pyx_ws_pool.num_workers == __pyx_ws_pool.threads_allocated) {
+            int allocated = __pyx_ws_pool.threads_allocated ? 2 * __pyx_ws_pool.threads_allocated : 8;
+            __pyx_ws_thread *threads = (__pyx_ws_thread *) realloc(
+                __pyx_ws_pool.threads, (size_t) allocated * sizeof(__pyx_ws_thread));
+            if (!threads) break;
+            __pyx_ws_pool.threads = threads;
+            __pyx_ws_pool.threads_allocated = allocated;
+        }
+#if __PYX_WS_WINDOWS
+        thread = (HANDLE) _beginthreadex(NULL, 0, __pyx_ws_worker, arg, 0, NULL);
+        if (!thread) break;
+#else
+        if (pthread_create(&thread, NULL, __pyx_ws_worker, arg) != 0) break;
+#endif
+        __pyx_ws_pool.threads[__pyx_ws_pool.num_workers++] = thread;
+    }
+    return __pyx_ws_pool.num_workers < num_threads - 1 ? __pyx_ws_pool.num_workers + 1 : num_threads;
+}
+
+static CYTHON_INLINE Py_ssize_t __pyx_ws_chunk(__pyx_ws_loop *loop, Py_ssize_t size) {
+    Py_ssize_t chunk = loop->chunksize;
+    if (chunk <= 0) {
+        // take a fraction of what is left, so that there is work left to steal
+        chunk = (size + 15) / 16;
+    }
+    return chunk < size ? chunk : size;
+}
+
+static int __Pyx_WorkStealing_Next(__pyx_ws_loop *loop, int thread_id, Py_ssize_t *begin, Py_ssize_t *end) {
+    __pyx_ws_range *own = &loop->ranges[thread_id];
+    Py_ssize_t size, chunk;
+    int i;
+
+    __pyx_ws_mutex_lock(&own->lock);
+    size = own->end - own->begin;
+    if (size > 0) {
+        chunk = __pyx_ws_chunk(loop, size);
+        *begin = own->begin;
+        *end = own->begin += chunk;
+        __pyx_ws_mutex_unlock(&own->lock);
+        return 1;
+    }
+    __pyx_ws_mutex_unlock(&own->lock);
+
+    for (i = 1; i < loop->num_threads; i++) {
+        __pyx_ws_range *victim = &loop->ranges[(thread_id + i) % loop->num_threads];
+        Py_ssize_t stolen_begin, stolen_end;
+
+        __pyx_ws_mutex_lock(&victim->lock);
+        size = victim->end - victim->begin;
+        if (size <= 0) {
+            __pyx_ws_mutex_unlock(&victim->lock);
+            continue;
+        }
+        stolen_end = victim->end;
+        victim->end -= (size + 1) / 2;
+        stolen_begin = victim->end;
+        __pyx_ws_mutex_unlock(&victim->lock);
+
+        // run the first chunk and make the rest stealable from our own range
+        chunk = __pyx_ws_chunk(loop, stolen_end - stolen_begin);
+        __pyx_ws_mutex_lock(&own->lock);
+        own->begin = stolen_begin + chunk;
+        own->end = stolen_end;
+        __pyx_ws_mutex_unlock(&own->lock);
+        *begin = stolen_begin;
+        *end = stolen_begin + chunk;
+        return 1;
+    }
+    return 0;
+}
+
+static void __Pyx_WorkStealing_Lock(__pyx_ws_loop *loop) {
+    __pyx_ws_mutex_lock(&loop->lock);
+}
+
+static void __Pyx_WorkStealing_Unlock(__pyx_ws_loop *loop) {
+    __pyx_ws_mutex_unlock(&loop->lock);
+}
+
+static void __Pyx_WorkStealing_Run(__pyx_ws_body body, void *context, Py_ssize_t nsteps,
+                                   int num_threads, Py_ssize_t chunksize) {
+    __pyx_ws_loop loop;
+    __pyx_ws_range single_range;
+    Py_ssize_t size, extra;
+    int i, use_pool = 0;
+
+    if (nsteps <= 0) return;
+    if (num_threads <= 0) num_threads = __pyx_ws_cpu_count();
+    if (num_threads > nsteps) num_threads = (int) nsteps;
+
+    loop.ranges = NULL;
+    if (num_threads > 1) {
+        __pyx_ws_pool_init();
+        if (__pyx_ws_mutex_trylock(&__pyx_ws_pool.busy)) {
+            __pyx_ws_mutex_lock(&__pyx_ws_pool.lock);
+            num_threads = __pyx_ws_start_workers(num_threads);
+            __pyx_ws_mutex_unlock(&__pyx_ws_pool.lock);
+            if (num_threads > 1)
+                loop.ranges = (__pyx_ws_range *) malloc((size_t) num_threads * sizeof(__pyx_ws_range));
+            use_pool = loop.ranges != NULL;
+            if (!use_pool)
+                __pyx_ws_mutex_unlock(&__pyx_ws_pool.busy);
+        }
+    }
+    if (!use_pool) {
+        num_threads = 1;
+        loop.ranges = &single_range;
+    }
+
+    loop.num_threads = num_threads;
+    loop.chunksize = chunksize;
+    __pyx_ws_mutex_init(&loop.lock);
+    size = nsteps / num_threads;
+    extra = nsteps % num_threads;
+    for (i = 0; i < num_threads; i++) {
+        __pyx_ws_mutex_init(&loop.ranges[i].lock);
+        loop.ranges[i].begin = i * size + (i < extra ? i : extra);
+        loop.ranges[i].end = loop.ranges[i].begin + size + (i < extra);
+    }
+
+    if (use_pool) {
+        __pyx_ws_mutex_lock(&__pyx_ws_pool.lock);
+        __pyx_ws_pool.body = body;
+        __pyx_ws_pool.context = context;
+        __pyx_ws_pool.loop = &loop;
+        __pyx_ws_pool.num_threads = num_threads;
+        __pyx_ws_pool.num_running = num_threads - 1;
+        __pyx_ws_pool.generation++;
+        __pyx_ws_cond_broadcast(&__pyx_ws_pool.start);
+        __pyx_ws_mutex_unlock(&__pyx_ws_pool.lock);
+
+        body(context, &loop, 0);
+
+        __pyx_ws_mutex_lock(&__pyx_ws_pool.lock);
+        while (__pyx_ws_pool.num_running)
+            __pyx_ws_cond_wait(&__pyx_ws_pool.done, &__pyx_ws_pool.lock);
+        __pyx_ws_mutex_unlock(&__pyx_ws_pool.lock);
+        __pyx_ws_mutex_unlock(&__pyx_ws_pool.busy);
+    } else {
+        body(context, &loop, 0);
+    }
+
+    for (i = 0; i < num_threads; i++)
+        __pyx_ws_mutex_destroy(&loop.ranges[i].lock);
+    __pyx_ws_mutex_destroy(&loop.lock);
+    if (use_pool)
+        free(loop.ranges);
+}
+
+
+/////////////// ReductionBuffer.proto ///////////////
+
+// Thread local copies of memoryviews for 'prange(..., reduction=...)'.  The
+// copy gets its own C contiguous buffer, which is merged into the original
+// slice item by item at the end of the loop.
+
+static Py_ssize_t __Pyx_Parallel_InitReductionBuffer(__Pyx_memviewslice *slice, int ndim, size_t itemsize); /*proto*/
+static CYTHON_INLINE Py_ssize_t __Pyx_Parallel_ReductionSize(const __Pyx_memviewslice *slice, int ndim); /*proto*/
+static CYTHON_INLINE Py_ssize_t __Pyx_Parallel_ReductionOffset(const __Pyx_memviewslice *slice, int ndim, Py_ssize_t index); /*proto*/
+
+/////////////// ReductionBuffer ///////////////
+
+static CYTHON_INLINE Py_ssize_t __Pyx_Parallel_ReductionSize(const __Pyx_memviewslice *slice, int ndim) {
+    Py_ssize_t size = 1;
+    int i;
+    for (i = 0; i < ndim; i++)
+        size *= slice->shape[i];
+    return size;
+}
+
+static Py_ssize_t __Pyx_Parallel_InitReductionBuffer(__Pyx_memviewslice *slice, int ndim, size_t itemsize) {
+    Py_ssize_t size = 1;
+    int i;
+    for (i = ndim - 1; i >= 0; i--) {
+        slice->strides[i] = (Py_ssize_t) itemsize * size;
+        slice->suboffsets[i] = -1;
+        size *= slice->shape[i];
+    }
+    // On failure, 'data' is NULL and the loop body raises a MemoryError.
+    slice->data = (char *) malloc((size_t) (size ? size : 1) * itemsize);
+    if (unlikely(!slice->data))
+        return 0;
+    return size;
+}
+
+// Offset of item 'index' of a C contiguous copy in the original slice
+static CYTHON_INLINE Py_ssize_t __Pyx_Parallel_ReductionOffset(const __Pyx_memviewslice *slice, int ndim, Py_ssize_t index) {
+    Py_ssize_t offset = 0;
+    int i;
+    for (i = ndim - 1; i >= 0; i--) {
+        offset += (index % slice->shape[i]) * slice->strides[i];
+        index /= slice->shape[i];
+    }
+    return offset;
+}
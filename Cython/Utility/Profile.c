@@ -333,3 +333,361 @@ bad:
 }
 
 #endif /* CYTHON_PROFILE */
+
+
+/////////////// SampleProfile.proto ///////////////
+//@substitute: naming
+
+// Sampling profiler support (directive "profile=sampling").
+// Instead of creating frames and calling the profile function, each function keeps
+// a small record on the C stack and links it into a per-thread "shadow stack".
+// A SIGPROF timer periodically records the current shadow stack of the running thread.
+// The shadow stack is shared between all Cython modules of the same ABI version.
+
+#ifndef CYTHON_PROFILE_SAMPLING
+  #define CYTHON_PROFILE_SAMPLING 1
+#endif
+
+#if CYTHON_PROFILE_SAMPLING
+
+typedef struct __Pyx_SampleFrame {
+    const char *funcname;
+    const char *srcfile;
+    int lineno;
+    struct __Pyx_SampleFrame *back;
+    struct __Pyx_SampleFrame **top;  /* non-NULL while the frame is linked into the shadow stack */
+} __Pyx_SampleFrame;
+
+struct __Pyx_SamplerVtab {
+    __Pyx_SampleFrame **(*get_thread_top)(void);
+};
+
+static struct __Pyx_SamplerVtab __Pyx_SamplerFuncs;
+static int __Pyx_SamplerInit(void);
+
+// The sampler reads the shadow stack from a signal handler on the same thread,
+// so we only need to keep the compiler from reordering the stores.
+#if defined(__GNUC__)
+  #define __Pyx_SAMPLE_BARRIER()  __asm__ __volatile__("" ::: "memory")
+#elif defined(_MSC_VER)
+  #include <intrin.h>
+  #define __Pyx_SAMPLE_BARRIER()  _ReadWriteBarrier()
+#else
+  #define __Pyx_SAMPLE_BARRIER()
+#endif
+
+#define __Pyx_SampleDeclarations                                                \
+  __Pyx_SampleFrame $sample_frame_cname = {NULL, NULL, 0, NULL, NULL};
+
+#define __Pyx_SampleCall(name, file, firstlineno)                              \
+  {   __Pyx_SampleFrame **top = __Pyx_SamplerFuncs.get_thread_top();            \
+      $sample_frame_cname.funcname = name;                                      \
+      $sample_frame_cname.srcfile = file;                                       \
+      $sample_frame_cname.lineno = firstlineno;                                 \
+      $sample_frame_cname.back = *top;                                          \
+      $sample_frame_cname.top = top;                                            \
+      __Pyx_SAMPLE_BARRIER();                                                   \
+      *top = &$sample_frame_cname;                                              \
+  }
+
+// The store must not be optimised away, the signal handler may read it at any time.
+#define __Pyx_SampleLine(line)  *(volatile int*)&$sample_frame_cname.lineno = line;
+
+// Safe to use more than once, and on exit paths where the frame was never linked.
+#define __Pyx_SampleReturn()                                                    \
+  if (likely($sample_frame_cname.top)) {                                        \
+      *$sample_frame_cname.top = $sample_frame_cname.back;                      \
+      __Pyx_SAMPLE_BARRIER();                                                   \
+      $sample_frame_cname.top = NULL;                                           \
+  }
+
+#else
+
+  #define __Pyx_SampleDeclarations
+  #define __Pyx_SampleCall(name, file, firstlineno)
+  #define __Pyx_SampleLine(line)
+  #define __Pyx_SampleReturn()
+  #define __Pyx_SamplerInit()  (0)
+
+#endif /* CYTHON_PROFILE_SAMPLING */
+
+/////////////// SampleProfile.init ///////////////
+// Errors leave an exception set, which the module init code checks right after this.
+(void) __Pyx_SamplerInit();
+
+/////////////// SampleProfile ///////////////
+//@requires: ModuleSetupCode.c::ThreadLocal
+
+// Only the first module that gets imported (per Cython ABI version) provides the
+// shadow stack and the sampler.  It publishes them through a capsule and a few
+// functions in the shared ABI module, which the Python module "Cython.Sampling"
+// uses to control the sampler:
+//
+//    sampling_start(interval=0.001)   start the SIGPROF timer (CPU time interval in seconds)
+//    sampling_stop()                  stop the timer
+//    sampling_stacks(clear=False)     return a dict mapping folded stacks to sample counts
+//
+// Stack records are collected into a fixed size table that is allocated when
+// sampling starts, because the signal handler must not allocate memory.
+
+#if CYTHON_PROFILE_SAMPLING
+
+#define __Pyx_Sampler_PyCapsuleName "SamplerFuncs"
+#define __Pyx_Sampler_PyCapsule  __PYX_ABI_MODULE_NAME "." __Pyx_Sampler_PyCapsuleName
+
+#ifndef CYTHON_SAMPLING_MAX_DEPTH
+  #define CYTHON_SAMPLING_MAX_DEPTH 64
+#endif
+#ifndef CYTHON_SAMPLING_TABLE_SIZE
+  /* number of distinct stacks that can be recorded */
+  #define CYTHON_SAMPLING_TABLE_SIZE 1024
+#endif
+
+#if (defined(__unix__) || defined(__APPLE__)) && defined(__GNUC__)
+  #define __PYX_SAMPLING_TIMER 1
+  #include <signal.h>
+  #include <sys/time.h>
+#else
+  #define __PYX_SAMPLING_TIMER 0
+#endif
+
+#ifdef CYTHON_THREAD_LOCAL
+static CYTHON_THREAD_LOCAL __Pyx_SampleFrame *__Pyx_Sample_thread_top = NULL;
+#else
+// Without thread locals, all threads share one shadow stack.  This gives wrong
+// results for multi-threaded code, but keeps things working otherwise.
+static __Pyx_SampleFrame *__Pyx_Sample_thread_top = NULL;
+#endif
+
+static __Pyx_SampleFrame **__Pyx_Sample_get_thread_top(void) {
+    return &__Pyx_Sample_thread_top;
+}
+
+typedef struct {
+    size_t count;
+    size_t hash;
+    int depth;
+    /* innermost frame first */
+    struct { const char *funcname; const char *srcfile; int lineno; } frames[CYTHON_SAMPLING_MAX_DEPTH];
+} __Pyx_SampleRecord;
+
+static __Pyx_SampleRecord *__Pyx_Sample_table = NULL;
+static size_t __Pyx_Sample_dropped = 0;
+
+#if __PYX_SAMPLING_TIMER
+static volatile int __Pyx_Sample_busy = 0;
+static int __Pyx_Sample_running = 0;
+static struct sigaction __Pyx_Sample_old_action;
+
+static __Pyx_SampleRecord *__Pyx_Sample_find_record(size_t hash, int depth) {
+    size_t i = hash % CYTHON_SAMPLING_TABLE_SIZE, probe;
+    for (probe = 0; probe < CYTHON_SAMPLING_TABLE_SIZE; probe++, i = (i + 1) % CYTHON_SAMPLING_TABLE_SIZE) {
+        __Pyx_SampleRecord *record = __Pyx_Sample_table + i;
+        __Pyx_SampleFrame *frame;
+        int d;
+        if (!record->count) return record;
+        if (record->hash != hash || record->depth != depth) continue;
+        for (d = 0, frame = __Pyx_Sample_thread_top; d < depth; d++, frame = frame->back) {
+            if (record->frames[d].funcname != frame->funcname || record->frames[d].lineno != frame->lineno) break;
+        }
+        if (d == depth) return record;
+    }
+    return NULL;
+}
+
+static void __Pyx_Sample_signal_handler(CYTHON_UNUSED int signum) {
+    __Pyx_SampleRecord *record;
+    __Pyx_SampleFrame *frame = __Pyx_Sample_thread_top;
+    size_t hash = 0;
+    int depth;
+    if (!frame || !__Pyx_Sample_table) return;
+    if (__sync_lock_test_and_set(&__Pyx_Sample_busy, 1)) {
+        // Another thread is recording (or the table is being read), just drop this sample.
+        __Pyx_Sample_dropped++;
+        return;
+    }
+    for (depth = 0; frame && depth < CYTHON_SAMPLING_MAX_DEPTH; depth++, frame = frame->back) {
+        hash = (hash * 1000003) ^ ((size_t) frame->funcname) ^ (size_t) frame->lineno;
+    }
+    record = __Pyx_Sample_find_record(hash, depth);
+    if (unlikely(!record)) {
+        __Pyx_Sample_dropped++;
+    } else if (record->count) {
+        record->count++;
+    } else {
+        int d;
+        for (d = 0, frame = __Pyx_Sample_thread_top; d < depth; d++, frame = frame->back) {
+            record->frames[d].funcname = frame->funcname;
+            record->frames[d].srcfile = frame->srcfile;
+            record->frames[d].lineno = frame->lineno;
+        }
+        record->depth = depth;
+        record->hash = hash;
+        record->count = 1;
+    }
+    __sync_lock_release(&__Pyx_Sample_busy);
+}
+
+static int __Pyx_Sample_set_timer(double interval) {
+    struct itimerval timer;
+    long usec = (long) (interval * 1e6);
+    timer.it_interval.tv_sec = usec / 1000000;
+    timer.it_interval.tv_usec = usec % 1000000;
+    timer.it_value = timer.it_interval;
+    return setitimer(ITIMER_PROF, &timer, NULL);
+}
+
+#define __Pyx_Sample_lock()    while (__sync_lock_test_and_set(&__Pyx_Sample_busy, 1))
+#define __Pyx_Sample_unlock()  __sync_lock_release(&__Pyx_Sample_busy)
+#else
+#define __Pyx_Sample_lock()
+#define __Pyx_Sample_unlock()
+#endif /* __PYX_SAMPLING_TIMER */
+
+static PyObject *__Pyx_Sampler_Start(CYTHON_UNUSED PyObject *self, PyObject *args) {
+    double interval = 0.001;
+    if (unlikely(!PyArg_ParseTuple(args, "|d:sampling_start", &interval))) return NULL;
+#if __PYX_SAMPLING_TIMER
+    if (unlikely(interval < 1e-6)) {
+        PyErr_SetString(PyExc_ValueError, "sampling interval must be at least one microsecond");
+        return NULL;
+    }
+    if (!__Pyx_Sample_table) {
+        __Pyx_Sample_table = (__Pyx_SampleRecord*) PyMem_Malloc(CYTHON_SAMPLING_TABLE_SIZE * sizeof(__Pyx_SampleRecord));
+        if (unlikely(!__Pyx_Sample_table)) return PyErr_NoMemory();
+        memset(__Pyx_Sample_table, 0, CYTHON_SAMPLING_TABLE_SIZE * sizeof(__Pyx_SampleRecord));
+    }
+    if (!__Pyx_Sample_running) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = __Pyx_Sample_signal_handler;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (unlikely(sigaction(SIGPROF, &action, &__Pyx_Sample_old_action) < 0)) {
+            return PyErr_SetFromErrno(PyExc_OSError);
+        }
+    }
+    if (unlikely(__Pyx_Sample_set_timer(interval) < 0)) {
+        PyErr_SetFromErrno(PyExc_OSError);
+        if (!__Pyx_Sample_running) sigaction(SIGPROF, &__Pyx_Sample_old_action, NULL);
+        return NULL;
+    }
+    __Pyx_Sample_running = 1;
+    Py_RETURN_NONE;
+#else
+    PyErr_SetString(PyExc_NotImplementedError, "sampling is not supported on this platform");
+    return NULL;
+#endif
+}
+
+static PyObject *__Pyx_Sampler_Stop(CYTHON_UNUSED PyObject *self, CYTHON_UNUSED PyObject *args) {
+#if __PYX_SAMPLING_TIMER
+    if (__Pyx_Sample_running) {
+        __Pyx_Sample_set_timer(0.0);
+        sigaction(SIGPROF, &__Pyx_Sample_old_action, NULL);
+        __Pyx_Sample_running = 0;
+    }
+#endif
+    Py_RETURN_NONE;
+}
+
+static PyObject *__Pyx_Sampler_Stacks(CYTHON_UNUSED PyObject *self, PyObject *args) {
+    PyObject *result, *key = NULL, *count = NULL;
+    int clear = 0;
+    char *buffer = NULL;
+    size_t buffer_size = 0;
+    Py_ssize_t i;
+    if (unlikely(!PyArg_ParseTuple(args, "|i:sampling_stacks", &clear))) return NULL;
+    result = PyDict_New();
+    if (unlikely(!result) || !__Pyx_Sample_table) return result;
+    __Pyx_Sample_lock();
+    for (i = 0; i < CYTHON_SAMPLING_TABLE_SIZE; i++) {
+        __Pyx_SampleRecord *record = __Pyx_Sample_table + i;
+        size_t length = 0;
+        int d;
+        if (!record->count) continue;
+        // Folded stack format: "outer;inner", with the outermost frame first.
+        for (d = record->depth - 1; d >= 0; d--) {
+            size_t needed = strlen(record->frames[d].funcname) + strlen(record->frames[d].srcfile) + 32;
+            if (length + needed > buffer_size) {
+                char *new_buffer = (char*) PyMem_Realloc(buffer, buffer_size + needed + 256);
+                if (unlikely(!new_buffer)) {
+                    PyErr_NoMemory();
+                    goto bad;
+                }
+                buffer = new_buffer;
+                buffer_size += needed + 256;
+            }
+            length += (size_t) PyOS_snprintf(buffer + length, buffer_size - length, "%s%s (%s:%d)",
+                d == record->depth - 1 ? "" : ";",
+                record->frames[d].funcname, record->frames[d].srcfile, record->frames[d].lineno);
+        }
+        key = PyUnicode_DecodeUTF8(buffer, (Py_ssize_t) length, "replace");
+        if (unlikely(!key)) goto bad;
+        count = PyLong_FromSize_t(record->count);
+        if (unlikely(!count)) goto bad;
+        if (unlikely(PyDict_SetItem(result, key, count) < 0)) goto bad;
+        Py_CLEAR(key);
+        Py_CLEAR(count);
+    }
+    if (__Pyx_Sample_dropped) {
+        count = PyLong_FromSize_t(__Pyx_Sample_dropped);
+        if (unlikely(!count)) goto bad;
+        if (unlikely(PyDict_SetItemString(result, "[dropped]", count) < 0)) goto bad;
+        Py_CLEAR(count);
+    }
+    if (clear) {
+        memset(__Pyx_Sample_table, 0, CYTHON_SAMPLING_TABLE_SIZE * sizeof(__Pyx_SampleRecord));
+        __Pyx_Sample_dropped = 0;
+    }
+    __Pyx_Sample_unlock();
+    PyMem_Free(buffer);
+    return result;
+bad:
+    __Pyx_Sample_unlock();
+    PyMem_Free(buffer);
+    Py_XDECREF(key);
+    Py_XDECREF(count);
+    Py_DECREF(result);
+    return NULL;
+}
+
+static PyMethodDef __Pyx_Sampler_methods[] = {
+    {"sampling_start", (PyCFunction) __Pyx_Sampler_Start, METH_VARARGS, 0},
+    {"sampling_stop", (PyCFunction) __Pyx_Sampler_Stop, METH_VARARGS, 0},
+    {"sampling_stacks", (PyCFunction) __Pyx_Sampler_Stacks, METH_VARARGS, 0},
+    {0, 0, 0, 0}
+};
+
+static int __Pyx_SamplerInit(void) {
+    PyObject *abi_module, *capsule;
+    PyMethodDef *method;
+    int result;
+    struct __Pyx_SamplerVtab* shared = (struct __Pyx_SamplerVtab*)PyCapsule_Import(__Pyx_Sampler_PyCapsule, 1);
+    if (shared) {
+        __Pyx_SamplerFuncs = *shared;
+        return 0;
+    }
+    // Only a missing ABI module or capsule means that we are the first module.
+    if (unlikely(!PyErr_ExceptionMatches(PyExc_ImportError) && !PyErr_ExceptionMatches(PyExc_AttributeError)))
+        return -1;
+    PyErr_Clear();
+    // We are the first module, so we provide the shadow stack for everyone else.
+    __Pyx_SamplerFuncs.get_thread_top = __Pyx_Sample_get_thread_top;
+    abi_module = PyImport_AddModule((char*) __PYX_ABI_MODULE_NAME);
+    if (unlikely(!abi_module)) return -1;
+    for (method = __Pyx_Sampler_methods; method->ml_name; method++) {
+        PyObject *func = PyCFunction_NewEx(method, NULL, NULL);
+        if (unlikely(!func)) return -1;
+        result = PyObject_SetAttrString(abi_module, method->ml_name, func);
+        Py_DECREF(func);
+        if (unlikely(result < 0)) return -1;
+    }
+    capsule = PyCapsule_New(&__Pyx_SamplerFuncs, __Pyx_Sampler_PyCapsule, NULL);
+    if (unlikely(!capsule)) return -1;
+    result = PyObject_SetAttrString(abi_module, __Pyx_Sampler_PyCapsuleName, capsule);
+    Py_DECREF(capsule);
+    return result;
+}
+
+#endif /* CYTHON_PROFILE_SAMPLING */
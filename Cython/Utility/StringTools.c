@@ -43,16 +43,15 @@ static CYTHON_INLINE Py_ssize_t __Pyx_Py_UNICODE_ssize_strlen(const Py_UNICODE *
 
 //////////////////// InitStrings.proto ////////////////////
 
-#if CYTHON_COMPILING_IN_LIMITED_API
 static int __Pyx_InitString(__Pyx_StringTabEntry t, PyObject **str); /*proto*/
-#else
+#if !CYTHON_COMPILING_IN_LIMITED_API
 static int __Pyx_InitStrings(__Pyx_StringTabEntry *t); /*proto*/
 #endif
 
 //////////////////// InitStrings ////////////////////
 
-#if PY_MAJOR_VERSION >= 3
 static int __Pyx_InitString(__Pyx_StringTabEntry t, PyObject **str) {
+    #if PY_MAJOR_VERSION >= 3  /* Python 3+ has unicode identifiers */
     if (t.is_unicode | t.is_str) {
         if (t.intern) {
             *str = PyUnicode_InternFromString(t.s);
@@ -64,6 +63,15 @@ static int __Pyx_InitString(__Pyx_StringTabEntry t, PyObject **str) {
     } else {
         *str = PyBytes_FromStringAndSize(t.s, t.n - 1);
     }
+    #else
+    if (t.is_unicode) {
+        *str = PyUnicode_DecodeUTF8(t.s, t.n - 1, NULL);
+    } else if (t.intern) {
+        *str = PyString_InternFromString(t.s);
+    } else {
+        *str = PyString_FromStringAndSize(t.s, t.n - 1);
+    }
+    #endif
     if (!*str)
         return -1;
     // initialise cached hash value
@@ -71,33 +79,43 @@ static int __Pyx_InitString(__Pyx_StringTabEntry t, PyObject **str) {
         return -1;
     return 0;
 }
-#endif
 
 #if !CYTHON_COMPILING_IN_LIMITED_API
 static int __Pyx_InitStrings(__Pyx_StringTabEntry *t) {
     while (t->p) {
-        #if PY_MAJOR_VERSION >= 3  /* Python 3+ has unicode identifiers */
-        __Pyx_InitString(*t, t->p);
-        #else
-        if (t->is_unicode) {
-            *t->p = PyUnicode_DecodeUTF8(t->s, t->n - 1, NULL);
-        } else if (t->intern) {
-            *t->p = PyString_InternFromString(t->s);
-        } else {
-            *t->p = PyString_FromStringAndSize(t->s, t->n - 1);
-        }
-        if (!*t->p)
+        if (unlikely(__Pyx_InitString(*t, t->p) < 0))
             return -1;
-        // initialise cached hash value
-        if (PyObject_Hash(*t->p) == -1)
-            return -1;
-        #endif
         ++t;
     }
     return 0;
 }
 #endif
 
+
+//////////////////// InitStringGroup.proto ////////////////////
+
+#if !CYTHON_COMPILING_IN_LIMITED_API
+static int __Pyx_InitStringGroup(__Pyx_StringTabEntry *t, const int *group, char *done); /*proto*/
+#endif
+
+//////////////////// InitStringGroup ////////////////////
+//@requires: InitStrings
+
+#if !CYTHON_COMPILING_IN_LIMITED_API
+// Creates the strings that a function uses on its first call (directive 'lazy_strings').
+// 'group' holds their indices in the string table, terminated by -1.
+// Strings that are shared between functions may already exist.
+static int __Pyx_InitStringGroup(__Pyx_StringTabEntry *t, const int *group, char *done) {
+    for (; *group >= 0; group++) {
+        __Pyx_StringTabEntry *entry = t + *group;
+        if (!*entry->p && unlikely(__Pyx_InitString(*entry, entry->p) < 0))
+            return -1;
+    }
+    *done = 1;
+    return 0;
+}
+#endif
+
 //////////////////// BytesContains.proto ////////////////////
 
 static CYTHON_INLINE int __Pyx_BytesContains(PyObject* bytes, char character); /*proto*/
@@ -505,8 +523,10 @@ static CYTHON_INLINE PyObject *__Pyx_PyUnicode_DecodeUTF16BE(const char *s, Py_s
 //@requires: IncludeCppStringH
 //@requires: decode_c_bytes
 
+// Works for std::string and std::string_view, without copying either.
+template <typename CppString>
 static CYTHON_INLINE PyObject* __Pyx_decode_cpp_string(
-         std::string cppstring, Py_ssize_t start, Py_ssize_t stop,
+         const CppString &cppstring, Py_ssize_t start, Py_ssize_t stop,
          const char* encoding, const char* errors,
          PyObject* (*decode_func)(const char *s, Py_ssize_t size, const char *errors)) {
     return __Pyx_decode_c_bytes(
@@ -881,14 +901,31 @@ static CYTHON_INLINE PyObject* __Pyx_PyBytes_Join(PyObject* sep, PyObject* value
 
 /////////////// JoinPyUnicode.proto ///////////////
 
-static PyObject* __Pyx_PyUnicode_Join(PyObject* value_tuple, Py_ssize_t value_count, Py_ssize_t result_ulength,
+// A substring of an f-string: either a Unicode string or ASCII characters,
+// e.g. a C integer that was formatted into a buffer on the stack.
+typedef struct {
+    PyObject *uval;
+    const char *chars;
+    Py_ssize_t length;
+} __Pyx_UnicodePart;
+
+static PyObject* __Pyx_PyUnicode_Join(__Pyx_UnicodePart *parts, Py_ssize_t part_count, Py_ssize_t result_ulength,
                                       Py_UCS4 max_char);
+static CYTHON_UNUSED void __Pyx_PyUnicode_ClearParts(__Pyx_UnicodePart *parts, Py_ssize_t part_count); /*proto*/
 
 /////////////// JoinPyUnicode ///////////////
 //@requires: IncludeStringH
 //@substitute: naming
 
-static PyObject* __Pyx_PyUnicode_Join(PyObject* value_tuple, Py_ssize_t value_count, Py_ssize_t result_ulength,
+// Releases the references to the Unicode strings of the parts.
+static void __Pyx_PyUnicode_ClearParts(__Pyx_UnicodePart *parts, Py_ssize_t part_count) {
+    Py_ssize_t i;
+    for (i=0; i < part_count; i++) {
+        Py_CLEAR(parts[i].uval);
+    }
+}
+
+static PyObject* __Pyx_PyUnicode_Join(__Pyx_UnicodePart *parts, Py_ssize_t part_count, Py_ssize_t result_ulength,
                                       CYTHON_UNUSED Py_UCS4 max_char) {
 #if CYTHON_USE_UNICODE_INTERNALS && CYTHON_ASSUME_SAFE_MACROS && !CYTHON_AVOID_BORROWED_REFS
     PyObject *result_uval;
@@ -913,11 +950,28 @@ static PyObject* __Pyx_PyUnicode_Join(PyObject* value_tuple, Py_ssize_t value_co
     assert(kind_shift == 2 || kind_shift == 1 || kind_shift == 0);
 
     char_pos = 0;
-    for (i=0; i < value_count; i++) {
+    for (i=0; i < part_count; i++) {
         int ukind;
         Py_ssize_t ulength;
         void *udata;
-        PyObject *uval = PyTuple_GET_ITEM(value_tuple, i);
+        PyObject *uval = parts[i].uval;
+        if (!uval) {
+            // ASCII characters
+            const char *chars = parts[i].chars;
+            ulength = parts[i].length;
+            if (unlikely((PY_SSIZE_T_MAX >> kind_shift) - ulength < char_pos))
+                goto overflow;
+            if (CYTHON_PEP393_ENABLED && result_ukind == PyUnicode_1BYTE_KIND) {
+                memcpy((char *)result_udata + char_pos, chars, (size_t) ulength);
+            } else {
+                Py_ssize_t j;
+                for (j=0; j < ulength; j++) {
+                    __Pyx_PyUnicode_WRITE(result_ukind, result_udata, char_pos+j, (Py_UCS4) chars[j]);
+                }
+            }
+            char_pos += ulength;
+            continue;
+        }
         if (unlikely(__Pyx_PyUnicode_READY(uval)))
             goto bad;
         ulength = __Pyx_PyUnicode_GET_LENGTH(uval);
@@ -950,9 +1004,27 @@ bad:
     return NULL;
 #else
     // non-CPython fallback
+    PyObject *value_tuple, *result_uval;
+    Py_ssize_t i;
     result_ulength++;
-    value_count++;
-    return PyUnicode_Join($empty_unicode, value_tuple);
+    value_tuple = PyTuple_New(part_count);
+    if (unlikely(!value_tuple)) return NULL;
+    for (i=0; i < part_count; i++) {
+        PyObject *uval = parts[i].uval;
+        if (uval) {
+            Py_INCREF(uval);
+        } else {
+            uval = PyUnicode_DecodeASCII(parts[i].chars, parts[i].length, NULL);
+            if (unlikely(!uval)) {
+                Py_DECREF(value_tuple);
+                return NULL;
+            }
+        }
+        PyTuple_SET_ITEM(value_tuple, i, uval);
+    }
+    result_uval = PyUnicode_Join($empty_unicode, value_tuple);
+    Py_DECREF(value_tuple);
+    return result_uval;
 #endif
 }
 
@@ -756,25 +756,25 @@ static const char DIGITS_HEX[2*16+1] = {
 };
 
 
-/////////////// CIntToPyUnicode.proto ///////////////
+/////////////// CIntToAscii.proto ///////////////
 
-static CYTHON_INLINE PyObject* {{TO_PY_FUNCTION}}({{TYPE}} value, Py_ssize_t width, char padding_char, char format_char);
+static CYTHON_INLINE Py_ssize_t {{TO_ASCII_FUNCTION}}({{TYPE}} value, Py_ssize_t width, char padding_char, char format_char, char *end);
 
-/////////////// CIntToPyUnicode ///////////////
-//@requires: StringTools.c::BuildPyUnicode
+/////////////// CIntToAscii ///////////////
+//@requires: StringTools.c::IncludeStringH
 //@requires: CIntToDigits
 //@requires: GCCDiagnostics
 
+// Writes the formatted value right-aligned into the characters before 'end' and returns their number.
+// The caller must provide 'max(width, sizeof({{TYPE}})*3+2)' characters of space.
 // NOTE: inlining because most arguments are constant, which collapses lots of code below
 
-static CYTHON_INLINE PyObject* {{TO_PY_FUNCTION}}({{TYPE}} value, Py_ssize_t width, char padding_char, char format_char) {
-    // simple and conservative C string allocation on the stack: each byte gives at most 3 digits, plus sign
-    char digits[sizeof({{TYPE}})*3+2];
+static CYTHON_INLINE Py_ssize_t {{TO_ASCII_FUNCTION}}({{TYPE}} value, Py_ssize_t width, char padding_char, char format_char, char *end) {
     // 'dpos' points to end of digits array + 1 initially to allow for pre-decrement looping
-    char *dpos, *end = digits + sizeof({{TYPE}})*3+2;
+    char *dpos;
     const char *hex_digits = DIGITS_HEX;
-    Py_ssize_t length, ulength;
-    int prepend_sign, last_one_off;
+    Py_ssize_t length;
+    int last_one_off;
     {{TYPE}} remaining;
 #ifdef __Pyx_HAS_GCC_DIAGNOSTIC
 #pragma GCC diagnostic push
@@ -827,19 +827,52 @@ static CYTHON_INLINE PyObject* {{TO_PY_FUNCTION}}({{TYPE}} value, Py_ssize_t wid
     dpos += last_one_off;
 
     length = end - dpos;
-    ulength = length;
-    prepend_sign = 0;
     if (!is_unsigned && value <= neg_one) {
-        if (padding_char == ' ' || width <= length + 1) {
-            *(--dpos) = '-';
-            ++length;
-        } else {
-            prepend_sign = 1;
+        if (padding_char == '0' && width > 0 && width > length + 1) {
+            // zero padding goes between the sign and the digits
+            dpos -= width - length - 1;
+            memset(dpos, '0', (size_t) (width - length - 1));
+            length = width - 1;
         }
-        ++ulength;
+        *(--dpos) = '-';
+        ++length;
+    }
+    // checking 'width' first lets the C compiler drop this for unpadded calls
+    if (width > 0 && width > length) {
+        dpos -= width - length;
+        memset(dpos, padding_char, (size_t) (width - length));
+        length = width;
     }
+    return length;
+}
+
+
+/////////////// CIntToPyUnicode.proto ///////////////
+
+static CYTHON_INLINE PyObject* {{TO_PY_FUNCTION}}({{TYPE}} value, Py_ssize_t width, char padding_char, char format_char);
+
+/////////////// CIntToPyUnicode ///////////////
+//@requires: StringTools.c::BuildPyUnicode
+//@requires: CIntToAscii
+
+static CYTHON_INLINE PyObject* {{TO_PY_FUNCTION}}({{TYPE}} value, Py_ssize_t width, char padding_char, char format_char) {
+    // simple and conservative C string allocation on the stack: each byte gives at most 3 digits, plus sign
+    char digits[sizeof({{TYPE}})*3+2];
+    char *dpos, *end = digits + sizeof({{TYPE}})*3+2;
+    Py_ssize_t length, ulength;
+    int prepend_sign = 0;
+
+    // padding is left to __Pyx_PyUnicode_BuildFromAscii() since the width is not limited
+    length = {{TO_ASCII_FUNCTION}}(value, 0, padding_char, format_char, end);
+    dpos = end - length;
+    ulength = length;
     if (width > ulength) {
         ulength = width;
+        if (padding_char == '0' && *dpos == '-') {
+            prepend_sign = 1;
+            ++dpos;
+            --length;
+        }
     }
     // single character unicode strings are cached in CPython => use PyUnicode_FromOrdinal() for them
     if (ulength == 1) {
@@ -849,6 +882,47 @@ static CYTHON_INLINE PyObject* {{TO_PY_FUNCTION}}({{TYPE}} value, Py_ssize_t wid
 }
 
 
+/////////////// CFloatToPyUnicode.proto ///////////////
+
+static PyObject* __Pyx_PyUnicode_From_double(double value, Py_ssize_t width, char padding_char, char format_char,
+                                             int precision, int flags);
+
+/////////////// CFloatToPyUnicode ///////////////
+//@requires: StringTools.c::BuildPyUnicode
+//@requires: StringTools.c::IncludeStringH
+
+static PyObject* __Pyx_PyUnicode_From_double(double value, Py_ssize_t width, char padding_char, char format_char,
+                                             int precision, int flags) {
+    PyObject *uval;
+    char *chars, *dpos;
+    Py_ssize_t length, ulength;
+    int prepend_sign = 0;
+#if PY_MAJOR_VERSION < 3
+    if (format_char == 'r') {
+        // format(x, '') is str(x) in Py2
+        format_char = 'g';
+        precision = 12;
+    }
+#endif
+    chars = PyOS_double_to_string(value, format_char, precision, flags, NULL);
+    if (unlikely(!chars)) return NULL;
+    dpos = chars;
+    length = (Py_ssize_t) strlen(chars);
+    ulength = length;
+    if (width > ulength) {
+        ulength = width;
+        if (padding_char == '0' && *dpos == '-') {
+            prepend_sign = 1;
+            ++dpos;
+            --length;
+        }
+    }
+    uval = __Pyx_PyUnicode_BuildFromAscii(ulength, dpos, (int) length, prepend_sign, padding_char);
+    PyMem_Free(chars);
+    return uval;
+}
+
+
 /////////////// CBIntToPyUnicode.proto ///////////////
 
 #define {{TO_PY_FUNCTION}}(value)  \
@@ -0,0 +1,160 @@
+# micro benchmarks for the call overhead of Python functions and methods
+
+import cython
+
+from time import time
+
+
+def noargs():
+    return None
+
+
+def onearg(a):
+    return a
+
+
+def posargs(a, b, c=None):
+    return a
+
+
+def varargs(*args):
+    return args
+
+
+def fused(x: cython.floating):
+    return x
+
+
+@cython.cclass
+class Methods(object):
+    def noargs(self):
+        return None
+
+    def onearg(self, a):
+        return a
+
+    def posargs(self, a, b, c=None):
+        return a
+
+    def varargs(self, *args):
+        return args
+
+    def fused(self, x: cython.floating):
+        return x
+
+
+@cython.locals(i=cython.Py_ssize_t)
+def bm_functions(N):
+    for i in range(N):
+        noargs()
+        onearg(i)
+        posargs(i, 2)
+        posargs(i, 2, c=3)
+        varargs(i, 2)
+        fused(1.0)
+
+
+@cython.locals(i=cython.Py_ssize_t)
+def bm_methods(N):
+    obj = Methods()
+    for i in range(N):
+        obj.noargs()
+        obj.onearg(i)
+        obj.posargs(i, 2)
+        obj.posargs(i, 2, c=3)
+        obj.varargs(i, 2)
+        obj.fused(1.0)
+
+
+@cython.locals(i=cython.Py_ssize_t)
+def bm_bound_methods(N):
+    obj = Methods()
+    m_noargs, m_onearg, m_posargs, m_varargs = obj.noargs, obj.onearg, obj.posargs, obj.varargs
+    for i in range(N):
+        m_noargs()
+        m_onearg(i)
+        m_posargs(i, 2)
+        m_posargs(i, 2, c=3)
+        m_varargs(i, 2)
+
+
+def _drain_free_lists():
+    # Objects that CPython reuses from its free lists are invisible to tracemalloc.
+    objects = [tuple([i] * size) for size in range(1, 5) for i in range(2100)]
+    objects += [{} for _ in range(100)] + [[] for _ in range(100)] + [i + 0.5 for i in range(200)]
+    return objects
+
+
+def allocations():
+    """
+    Return the memory that tracemalloc sees allocated during a single call
+    of each kind, e.g. for an argument tuple or a keyword dict.
+    """
+    import tracemalloc
+    obj = Methods()
+    m_varargs = obj.varargs
+    calls = [
+        ("noargs()", lambda: noargs()),
+        ("onearg(a)", lambda: onearg(1)),
+        ("posargs(a, b)", lambda: posargs(1, 2)),
+        ("posargs(a, b, c=c)", lambda: posargs(1, 2, c=3)),
+        ("varargs(a, b)", lambda: varargs(1, 2)),
+        ("fused(x)", lambda: fused(1.0)),
+        ("obj.noargs()", lambda: obj.noargs()),
+        ("obj.onearg(a)", lambda: obj.onearg(1)),
+        ("obj.posargs(a, b, c=c)", lambda: obj.posargs(1, 2, c=3)),
+        ("obj.varargs(a, b)", lambda: obj.varargs(1, 2)),
+        ("obj.fused(x)", lambda: obj.fused(1.0)),
+        ("bound varargs(a, b)", lambda: m_varargs(1, 2)),
+    ]
+
+    def measure(call):
+        call()  # fill caches
+        objects = _drain_free_lists()  # held until after the call
+        # kept alive so that it does not end up in a free list that the call takes from
+        traced = tracemalloc.get_traced_memory()
+        tracemalloc.reset_peak()
+        call()
+        return tracemalloc.get_traced_memory()[1] - traced[0]
+
+    tracemalloc.start()
+    try:
+        # the result tuple of get_traced_memory()
+        baseline = measure(lambda: None)
+        return [(name, measure(call) - baseline) for name, call in calls]
+    finally:
+        tracemalloc.stop()
+
+
+def run(N):
+    t0 = time()
+    bm_functions(N)
+    bm_methods(N)
+    bm_bound_methods(N)
+    return time() - t0
+
+
+def main(n):
+    run(1000)  # warmup
+    times = []
+    for i in range(n):
+        times.append(run(100000))
+    return times
+
+
+if __name__ == "__main__":
+    import optparse
+    import util
+    parser = optparse.OptionParser(
+        usage="%prog [options]",
+        description="Micro benchmarks for the call overhead of functions and methods.")
+    util.add_standard_options_to(parser)
+    parser.add_option("--allocations", action="store_true",
+                      help="Print the bytes allocated during each kind of call (Py3.9+).")
+    options, args = parser.parse_args()
+
+    if options.allocations:
+        for name, size in allocations():
+            print("%-24s %5d bytes" % (name, size))
+    else:
+        util.run_benchmark(options, options.num_runs, main)
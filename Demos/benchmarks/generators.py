@@ -52,6 +52,12 @@ def bm_yield_from_nested(N):
                                  count_to(N)),
                       count_to(N))
 
+def bm_short_lived(N):
+    # creates many generators that only run for a few steps
+    for i in range(N):
+        for value in count_to(i % 4):
+            yield value
+
 
 def time(fn, *args):
     from time import time
@@ -64,7 +70,8 @@ def benchmark(N):
     times = []
     for _ in range(N):
         result, t = time(bm_yield_from_nested, 10)
-        times.append(t)
+        result, t_short = time(bm_short_lived, COUNT * 10)
+        times.append(t + t_short)
     return times
 
 main = benchmark
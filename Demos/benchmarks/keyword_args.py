@@ -0,0 +1,56 @@
+# NOTE: requires Python 3 if not compiled with Cython
+
+from time import time
+
+
+def few_keywords(a, b=None, *, c=None, d=None):
+    return a
+
+
+def many_keywords(a, b=None, *, c=None, d=None, e=None, f=None, g=None, h=None,
+                  i=None, j=None, k=None, l=None, m=None, n=None, o=None, p=None):
+    return a
+
+
+def many_keywords_kwargs(a, *, c=None, d=None, e=None, f=None, g=None, h=None,
+                         i=None, j=None, k=None, l=None, m=None, **kwargs):
+    return a
+
+
+def run():
+    t0 = time()
+
+    for _ in range(20000):
+        few_keywords(1, d=2)
+        few_keywords(1, b=2, c=3, d=4)
+
+        many_keywords(1, p=2)
+        many_keywords(1, o=2, c=3, i=4)
+        many_keywords(1, p=1, o=2, n=3, m=4, l=5, k=6, j=7, i=8, h=9, g=10, f=11, e=12, d=13, c=14)
+        many_keywords(1, **{'h': 2, 'n': 3})
+
+        many_keywords_kwargs(1, m=2, x=3)
+        many_keywords_kwargs(1, c=2, d=3, y=4, z=5)
+
+    tk = time()
+    return tk - t0
+
+
+def main(n):
+    run()  # warmup
+    times = []
+    for i in range(n):
+        times.append(run())
+    return times
+
+
+if __name__ == "__main__":
+    import optparse
+    import util
+    parser = optparse.OptionParser(
+        usage="%prog [options]",
+        description="Test the performance of keyword argument parsing")
+    util.add_standard_options_to(parser)
+    options, args = parser.parse_args()
+
+    util.run_benchmark(options, options.num_runs, main)
@@ -0,0 +1,217 @@
+# cython: language_level=3
+# distutils: extra_compile_args = -O3
+
+cimport cython
+from cython.view cimport array as cvarray
+from libc.math cimport cos, sin, M_PI
+from libc.stdlib cimport malloc, free
+from libc.string cimport memcpy
+
+
+def signal(Py_ssize_t n):
+    """
+    >>> x = signal(4)
+    >>> x[0]
+    (1+0j)
+    """
+    cdef double complex[::1] x = cvarray(
+        shape=(n,), itemsize=sizeof(double complex), format="Zd")
+    cdef Py_ssize_t k
+    for k in range(n):
+        x[k] = cos(0.1 * k) + sin(0.3 * k) * 1j
+    return x
+
+
+def energy(double complex[::1] x):
+    cdef double res = 0
+    cdef Py_ssize_t k
+    for k in range(x.shape[0]):
+        res += x[k].real * x[k].real + x[k].imag * x[k].imag
+    return res
+
+
+cdef double complex* copy(double complex[::1] x) except NULL:
+    cdef double complex* buf = <double complex*> malloc(x.shape[0] * sizeof(double complex))
+    if not buf:
+        raise MemoryError()
+    memcpy(buf, &x[0], x.shape[0] * sizeof(double complex))
+    return buf
+
+
+cdef void bit_reverse(double complex* x, Py_ssize_t n) nogil:
+    cdef Py_ssize_t i, j = 0, k
+    for i in range(1, n):
+        k = n >> 1
+        while j & k:
+            j ^= k
+            k >>= 1
+        j |= k
+        if i < j:
+            x[i], x[j] = x[j], x[i]
+
+
+@cython.complex_fastmath(False)
+cdef void _fft(double complex* x, Py_ssize_t n) nogil:
+    cdef Py_ssize_t j, k, m = 2, half
+    cdef double complex w, wm, t, u
+    bit_reverse(x, n)
+    while m <= n:
+        half = m // 2
+        wm = cos(-2 * M_PI / m) + sin(-2 * M_PI / m) * 1j
+        for k in range(0, n // m):
+            w = 1
+            for j in range(k * m, k * m + half):
+                t = w * x[j + half]
+                u = x[j]
+                x[j] = u + t
+                x[j + half] = u - t
+                w = w * wm
+        m *= 2
+
+
+@cython.complex_fastmath(True)
+cdef void _fft_fastmath(double complex* x, Py_ssize_t n) nogil:
+    cdef Py_ssize_t j, k, m = 2, half
+    cdef double complex w, wm, t, u
+    bit_reverse(x, n)
+    while m <= n:
+        half = m // 2
+        wm = cos(-2 * M_PI / m) + sin(-2 * M_PI / m) * 1j
+        for k in range(0, n // m):
+            w = 1
+            for j in range(k * m, k * m + half):
+                t = w * x[j + half]
+                u = x[j]
+                x[j] = u + t
+                x[j + half] = u - t
+                w = w * wm
+        m *= 2
+
+
+@cython.complex_fastmath(False)
+def fft(double complex[::1] x):
+    """
+    Radix-2 FFT, returns the energy of the spectrum divided by the length.
+
+    >>> x = signal(1024)
+    >>> abs(fft(x) - energy(x)) < 1e-9 * energy(x)
+    True
+    """
+    cdef Py_ssize_t k, n = x.shape[0]
+    cdef double res = 0, a
+    cdef double complex* buf = copy(x)
+    _fft(buf, n)
+    for k in range(n):
+        a = abs(buf[k])
+        res += a * a
+    free(buf)
+    return res / n
+
+
+@cython.complex_fastmath(True)
+def fft_fastmath(double complex[::1] x):
+    """
+    >>> x = signal(1024)
+    >>> abs(fft_fastmath(x) - energy(x)) < 1e-9 * energy(x)
+    True
+    """
+    cdef Py_ssize_t k, n = x.shape[0]
+    cdef double res = 0, a
+    cdef double complex* buf = copy(x)
+    _fft_fastmath(buf, n)
+    for k in range(n):
+        a = abs(buf[k])
+        res += a * a
+    free(buf)
+    return res / n
+
+
+@cython.complex_fastmath(False)
+def dft(double complex[::1] x):
+    """
+    Naive O(n**2) DFT, returns the energy of the spectrum divided by the length.
+
+    >>> x = signal(64)
+    >>> abs(dft(x) - energy(x)) < 1e-9 * energy(x)
+    True
+    """
+    cdef Py_ssize_t j, k, n = x.shape[0]
+    cdef double res = 0, a
+    cdef double complex w, wj, acc
+    for j in range(n):
+        wj = cos(-2 * M_PI * j / n) + sin(-2 * M_PI * j / n) * 1j
+        w = 1
+        acc = 0
+        for k in range(n):
+            acc = acc + x[k] * w
+            w = w * wj
+        a = abs(acc)
+        res += a * a
+    return res / n
+
+
+@cython.complex_fastmath(True)
+def dft_fastmath(double complex[::1] x):
+    """
+    >>> x = signal(64)
+    >>> abs(dft_fastmath(x) - energy(x)) < 1e-9 * energy(x)
+    True
+    """
+    cdef Py_ssize_t j, k, n = x.shape[0]
+    cdef double res = 0, a
+    cdef double complex w, wj, acc
+    for j in range(n):
+        wj = cos(-2 * M_PI * j / n) + sin(-2 * M_PI * j / n) * 1j
+        w = 1
+        acc = 0
+        for k in range(n):
+            acc = acc + x[k] * w
+            w = w * wj
+        a = abs(acc)
+        res += a * a
+    return res / n
+
+
+@cython.complex_fastmath(False)
+def deconvolve(double complex[::1] x):
+    """
+    Divides the spectrum of the signal by a filter response and
+    returns the largest error after multiplying it back.
+
+    >>> deconvolve(signal(1024)) < 1e-9
+    True
+    """
+    cdef Py_ssize_t k, n = x.shape[0]
+    cdef double err = 0, e
+    cdef double complex h, y
+    cdef double complex* buf = copy(x)
+    _fft(buf, n)
+    for k in range(n):
+        h = 1 + 0.5 * cos(2 * M_PI * k / n) + 0.25 * sin(2 * M_PI * k / n) * 1j
+        y = buf[k] / h
+        e = abs(y * h - buf[k])
+        if e > err:
+            err = e
+    free(buf)
+    return err
+
+
+@cython.complex_fastmath(True)
+def deconvolve_fastmath(double complex[::1] x):
+    """
+    >>> deconvolve_fastmath(signal(1024)) < 1e-9
+    True
+    """
+    cdef Py_ssize_t k, n = x.shape[0]
+    cdef double err = 0, e
+    cdef double complex h, y
+    cdef double complex* buf = copy(x)
+    _fft_fastmath(buf, n)
+    for k in range(n):
+        h = 1 + 0.5 * cos(2 * M_PI * k / n) + 0.25 * sin(2 * M_PI * k / n) * 1j
+        y = buf[k] / h
+        e = abs(y * h - buf[k])
+        if e > err:
+            err = e
+    free(buf)
+    return err
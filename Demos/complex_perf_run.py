@@ -0,0 +1,38 @@
+from __future__ import absolute_import, print_function
+
+from complex_perf import *
+
+import sys
+import timeit
+
+
+def run_tests(N):
+    x = signal(N)
+    small = signal(min(N, 256))
+    print("\tstrict\t\tfastmath\tratio")
+    for func, arg in [(fft, x), (dft, small), (deconvolve, x)]:
+        print("%s(%s)" % (func.__name__, arg.shape[0]))
+        strict = my_timeit(func, arg)
+        fast = my_timeit(globals()[func.__name__ + "_fastmath"], arg)
+        print("\t%0.04e\t%0.04e\t%0.04f" % (strict, fast, fast / strict))
+
+
+def my_timeit(func, N):
+    global f, arg
+    f = func
+    arg = N
+    for exponent in range(10, 30):
+        times = 2 ** exponent
+        res = min(timeit.repeat("f(arg)", setup="from __main__ import f, arg", repeat=5, number=times))
+        if res > .25:
+            break
+    return res / times
+
+
+params = sys.argv[1:]
+if not params:
+    params = [1024, 4096]
+for arg in params:
+    print()
+    print("N", arg)
+    run_tests(int(arg))
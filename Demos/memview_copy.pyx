@@ -0,0 +1,25 @@
+# cython: language_level=3
+# distutils: extra_compile_args = -O3
+
+from cython.view cimport array
+
+ctypedef fused number:
+    signed char
+    short
+    int
+    double
+    double complex
+
+
+def copy(number[:, :] src, number[:, :] dst):
+    """
+    Copy 'src' into 'dst' through a memoryview slice assignment.
+    """
+    dst[...] = src
+
+
+def new_array(shape, itemsize, format, mode):
+    """
+    Allocate a cython.view.array, for running without NumPy.
+    """
+    return array(shape, itemsize, format, mode)
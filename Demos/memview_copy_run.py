@@ -0,0 +1,74 @@
+from __future__ import absolute_import, print_function
+
+from memview_copy import copy, new_array
+
+import sys
+import timeit
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+
+TYPES = [
+    # (numpy dtype, itemsize, buffer format)
+    ('int8', 1, 'b'),
+    ('int16', 2, 'h'),
+    ('int32', 4, 'i'),
+    ('float64', 8, 'd'),
+    ('complex128', 16, 'Zd'),
+]
+
+LAYOUTS = [
+    # (name, source order, destination order, source step)
+    ('C -> C', 'C', 'C', 1),
+    ('C -> F', 'C', 'F', 1),
+    ('F -> C', 'F', 'C', 1),
+    ('strided -> C', 'C', 'C', 2),
+    ('strided -> F', 'C', 'F', 2),
+]
+
+
+def make_arrays(N, dtype, itemsize, format, src_order, dst_order, step):
+    src_shape = (N * step, N * step)
+    if np is not None:
+        src = np.zeros(src_shape, dtype=dtype, order=src_order)
+        dst = np.zeros((N, N), dtype=dtype, order=dst_order)
+    else:
+        modes = {'C': 'c', 'F': 'fortran'}
+        src = new_array(src_shape, itemsize, format, modes[src_order])
+        dst = new_array((N, N), itemsize, format, modes[dst_order])
+    return src[::step, ::step], dst
+
+
+def run_tests(N):
+    print("%-14s %-11s %12s %12s %8s" % ("layout", "type", "Cython MB/s", "NumPy MB/s", "ratio"))
+    for name, src_order, dst_order, step in LAYOUTS:
+        for dtype, itemsize, format in TYPES:
+            src, dst = make_arrays(N, dtype, itemsize, format, src_order, dst_order, step)
+            megabytes = N * N * itemsize / 1e6
+            cython_rate = megabytes / my_timeit(copy, src, dst)
+            if np is not None:
+                numpy_rate = megabytes / my_timeit(np.copyto, dst, src)
+                print("%-14s %-11s %12.0f %12.0f %8.2f" % (
+                    name, dtype, cython_rate, numpy_rate, cython_rate / numpy_rate))
+            else:
+                print("%-14s %-11s %12.0f %12s %8s" % (name, dtype, cython_rate, '-', '-'))
+
+
+def my_timeit(func, *args):
+    for exponent in range(2, 30):
+        times = 2 ** exponent
+        res = min(timeit.repeat(lambda: func(*args), repeat=5, number=times))
+        if res > .1:
+            break
+    return res / times
+
+
+params = sys.argv[1:]
+if not params:
+    params = [64, 1024]
+for arg in params:
+    print()
+    print("N", arg)
+    run_tests(int(arg))
@@ -0,0 +1,37 @@
+# cython: language_level=3
+# distutils: extra_compile_args = -O3 -fopenmp
+# distutils: extra_link_args = -fopenmp
+
+cimport cython
+from cython.parallel cimport prange
+from cython.view cimport array
+
+
+@cython.boundscheck(False)
+@cython.wraparound(False)
+cdef inline double row_ends(double[:] row) nogil:
+    return row[0] + row[row.shape[0] - 1]
+
+
+@cython.boundscheck(False)
+@cython.wraparound(False)
+def sum_rows(double[:, :] a, int num_threads):
+    """
+    Sum up 'a' by taking a slice of each row inside of a parallel loop.
+    Every slice acquires and releases the underlying memoryview, so this
+    measures the contention on its acquisition count.
+    """
+    cdef Py_ssize_t i
+    cdef double total = 0
+    for i in prange(a.shape[0], nogil=True, num_threads=num_threads, schedule='static'):
+        total += row_ends(a[i])
+    return total
+
+
+def new_array(rows, columns):
+    """
+    Allocate a zero filled 2D array of doubles.
+    """
+    cdef double[:, :] a = array((rows, columns), sizeof(double), 'd')
+    a[...] = 0
+    return a.base
@@ -0,0 +1,28 @@
+from __future__ import absolute_import, print_function
+
+from memview_prange_slicing import sum_rows, new_array
+
+import multiprocessing
+import sys
+import timeit
+
+
+def run_tests(rows, max_threads):
+    a = new_array(rows, 4)
+    print("%8s %14s %10s" % ("threads", "slices/sec", "speedup"))
+    base_rate = None
+    threads = 1
+    while threads <= max_threads:
+        rate = rows / min(timeit.repeat(lambda: sum_rows(a, threads), repeat=5, number=1))
+        base_rate = base_rate or rate
+        print("%8d %14.0f %10.2f" % (threads, rate, rate / base_rate))
+        threads *= 2
+
+
+params = sys.argv[1:]
+if not params:
+    params = [10**6]
+for arg in params:
+    print()
+    print("rows", arg)
+    run_tests(int(arg), multiprocessing.cpu_count())
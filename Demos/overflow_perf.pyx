@@ -132,6 +132,31 @@ def factorial_overflow(INT n):
     return int(res)
 
 
+@cython.overflowcheck(False)
+def neighbours(INT n):
+    """
+    >>> neighbours(10)
+    10
+    """
+    cdef INT k, res = 0
+    for k in range(1, n):
+        res ^= (k - 1) | (k + 1)
+    return int(res)
+
+@cython.overflowcheck(True)
+def neighbours_overflow(INT n):
+    """
+    >>> neighbours_overflow(10)
+    10
+    """
+    # The loop bounds prove that 'k - 1' and 'k + 1' cannot overflow (for signed
+    # types and for unsigned ones as wide as 'long'), so they are not checked.
+    cdef INT k, res = 0
+    for k in range(1, n):
+        res ^= (k - 1) | (k + 1)
+    return int(res)
+
+
 @cython.overflowcheck(False)
 def most_orthogonal(C_INT[:,::1] vectors):
     cdef C_INT n = vectors.shape[0]
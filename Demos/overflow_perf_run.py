@@ -12,8 +12,9 @@ except ImportError:
 
 def run_tests(N):
     global f
-    for func in most_orthogonal, fib, collatz, factorial:
+    for func in most_orthogonal, fib, collatz, factorial, neighbours:
         print(func.__name__)
+        print("\tno check\tcheck\t\tratio")
         for type in ['int', 'unsigned int', 'long long', 'unsigned long long', 'object']:
             if func == most_orthogonal:
                 if type == 'object' or np is None:
@@ -0,0 +1,60 @@
+# cython: language_level=3
+# distutils: extra_compile_args = -O3 -fopenmp
+# distutils: extra_link_args = -fopenmp
+
+from cython.parallel cimport prange
+
+cpdef enum Workload:
+    # distributions of the cost per iteration
+    UNIFORM
+    TRIANGULAR
+    SPIKES
+
+
+cdef inline long cost(long i, long n, Workload workload) nogil:
+    if workload == TRIANGULAR:
+        return 1 + 4000 * (n - i) // n
+    elif workload == SPIKES:
+        # few, scattered expensive iterations
+        return 100000 if (i * 7919) % 1021 == 0 else 100
+    return 1000
+
+
+cdef double work(long i, long n, Workload workload) nogil:
+    cdef double x = 0
+    cdef long j
+    for j in range(cost(i, n, workload)):
+        x += (i ^ j) & 7
+    return x
+
+
+def run_static(long n, Workload workload, int num_threads):
+    cdef long i
+    cdef double total = 0
+    for i in prange(n, nogil=True, schedule='static', num_threads=num_threads):
+        total += work(i, n, workload)
+    return total
+
+
+def run_dynamic(long n, Workload workload, int num_threads):
+    cdef long i
+    cdef double total = 0
+    for i in prange(n, nogil=True, schedule='dynamic', num_threads=num_threads):
+        total += work(i, n, workload)
+    return total
+
+
+def run_guided(long n, Workload workload, int num_threads):
+    cdef long i
+    cdef double total = 0
+    for i in prange(n, nogil=True, schedule='guided', num_threads=num_threads):
+        total += work(i, n, workload)
+    return total
+
+
+def run_threads(long n, Workload workload, int num_threads):
+    cdef long i
+    cdef double total = 0
+    for i in prange(n, nogil=True, backend='threads', num_threads=num_threads):
+        total += work(i, n, workload)
+    return total
@@ -0,0 +1,34 @@
+from __future__ import absolute_import, print_function
+
+from prange_schedules import (
+    UNIFORM, TRIANGULAR, SPIKES, run_static, run_dynamic, run_guided, run_threads)
+
+import multiprocessing
+import sys
+import timeit
+
+WORKLOADS = [("uniform", UNIFORM), ("triangular", TRIANGULAR), ("spikes", SPIKES)]
+RUNNERS = [
+    ("static", run_static), ("dynamic", run_dynamic),
+    ("guided", run_guided), ("threads", run_threads),
+]
+
+
+def run_tests(n, num_threads):
+    print("%12s" % "workload" + "".join("%12s" % name for name, _ in RUNNERS))
+    for workload_name, workload in WORKLOADS:
+        expected = run_static(n, workload, 1)
+        timings = []
+        for name, run in RUNNERS:
+            assert run(n, workload, num_threads) == expected, name
+            timings.append(min(timeit.repeat(lambda: run(n, workload, num_threads), repeat=5, number=1)))
+        print("%12s" % workload_name + "".join("%10.1fms" % (t * 1000) for t in timings))
+
+
+params = sys.argv[1:]
+if not params:
+    params = [20000]
+for arg in params:
+    print()
+    print("iterations %s, threads %d" % (arg, multiprocessing.cpu_count()))
+    run_tests(int(arg), multiprocessing.cpu_count())
@@ -0,0 +1,26 @@
+from cython.parallel import prange
+
+cdef struct MinLoc:
+    double value
+    Py_ssize_t index
+
+cdef MinLoc min_loc(MinLoc a, MinLoc b) nogil:
+    return b if b.value < a.value else a
+
+def analyse(double[:] values, long[:] hist):
+    cdef Py_ssize_t i, nbins = hist.shape[0]
+    cdef MinLoc smallest, candidate
+    smallest.value = 1e300
+    smallest.index = -1
+
+    for i in prange(values.shape[0], nogil=True,
+                    reduction={'smallest': min_loc}):
+        candidate.value = values[i]
+        candidate.index = i
+        smallest = min_loc(smallest, candidate)
+
+    # values are expected to be in [0, 1)
+    for i in prange(values.shape[0], nogil=True, reduction='hist'):
+        hist[<Py_ssize_t> (values[i] * nbins)] += 1
+
+    return smallest.index
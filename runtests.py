@@ -312,6 +312,29 @@ def update_cpp11_extension(ext):
     return EXCLUDE_EXT
 
 
+def update_cpp17_extension(ext):
+    """
+        update cpp17 extensions that will run on versions of gcc >=7
+    """
+    gcc_version = get_gcc_version(ext.language)
+    if gcc_version:
+        compiler_version = gcc_version.group(1)
+        if float(compiler_version) >= 7:
+            ext.extra_compile_args.append("-std=c++17")
+            return ext
+        return EXCLUDE_EXT
+
+    clang_version = get_clang_version(ext.language)
+    if clang_version:
+        ext.extra_compile_args.append("-std=c++17")
+        if sys.platform == "darwin":
+          ext.extra_compile_args.append("-stdlib=libc++")
+          ext.extra_compile_args.append("-mmacosx-version-min=10.13")
+        return ext
+
+    return EXCLUDE_EXT
+
+
 def get_cc_version(language):
     """
         finds gcc version using Popen
@@ -374,7 +397,7 @@ def get_openmp_compiler_flags(language):
     COMPILER_HAS_INT128 = getattr(sys, 'maxsize', getattr(sys, 'maxint', 0)) > 2**60
 
     compiler_version = gcc_version.group(1)
-    if compiler_version and compiler_version.split('.') >= ['4', '2']:
+    if compiler_version and [int(v) for v in compiler_version.split('.')] >= [4, 2]:
         return '-fopenmp', '-fopenmp'
 
 try:
@@ -395,6 +418,7 @@ EXT_EXTRAS = {
     'tag:openmp': update_openmp_extension,
     'tag:gdb': update_gdb_extension,
     'tag:cpp11': update_cpp11_extension,
+    'tag:cpp17': update_cpp17_extension,
     'tag:trace' : update_linetrace_extension,
     'tag:bytesformat':  exclude_extension_in_pyver((3, 3), (3, 4)),  # no %-bytes formatting
     'tag:no-macos':  exclude_extension_on_platform('darwin'),
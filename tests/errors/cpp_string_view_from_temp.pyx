@@ -0,0 +1,26 @@
+# mode: error
+# tag: cpp, werror
+
+from libcpp.string_view cimport string_view
+
+cdef bytes c_s = b"abc"
+s = b"abc"
+
+cdef string_view sv
+
+# global cdef variable => ok
+sv = c_s
+
+# module global => warning
+sv = s
+
+# temp => error
+sv = s + b"cba"
+sv = c_s[1:]
+
+
+_ERRORS = """
+15:5: Obtaining 'string_view' from externally modifiable global Python value
+18:7: Storing unsafe C derivative of temporary Python reference
+19:8: Storing unsafe C derivative of temporary Python reference
+"""
@@ -149,6 +149,65 @@ with nogil, cython.parallel.parallel():
     with cython.parallel.parallel():
         pass
 
+for i in prange(10, nogil=True, backend='invalid'):
+    pass
+
+for i in prange(10, nogil=True, backend='threads', schedule='static'):
+    pass
+
+cdef int k
+for i in prange(10, nogil=True):
+    for k in prange(10, backend='threads'):
+        pass
+
+with nogil, cython.parallel.parallel():
+    for i in prange(10, backend='threads'):
+        pass
+
+with nogil, cython.parallel.task():
+    pass
+
+cdef int t = 0
+for i in prange(10, nogil=True):
+    with cython.parallel.task(num_threads=2):
+        t += i
+
+with nogil, cython.parallel.parallel():
+    with gil:
+        with cython.parallel.task():
+            pass
+
+for i in prange(10, nogil=True, backend='threads'):
+    with cython.parallel.task():
+        pass
+
+for i in prange(10, nogil=True):
+    for k in prange(10):
+        with cython.parallel.task():
+            pass
+
+cdef long arr[4]
+cdef double combine(double a, double b) nogil:
+    return a + b
+cdef double total = 0
+
+for i in prange(10, nogil=True, reduction='t'):
+    t += i
+
+for i in prange(10, nogil=True, reduction=('arr', 'missing')):
+    arr[i % 4] += 1
+    arr[0] *= 2
+
+for i in prange(10, nogil=True, reduction='arr'):
+    arr[i % 4] = i
+
+for i in prange(10, nogil=True, reduction={'arr': combine, 'total': chunksize}):
+    total = combine(total, i)
+
+for i in prange(10, nogil=True):
+    for k in prange(10, reduction='arr'):
+        arr[k % 4] += 1
+
 
 _ERRORS = u"""
 3:8: cython.parallel.parallel is not a module
@@ -184,4 +243,21 @@ _ERRORS = u"""
 139:62: Chunksize not valid for the schedule runtime
 145:70: Calling gil-requiring function not allowed without gil
 149:33: Nested parallel with blocks are disallowed
+152:15: Invalid backend argument to prange: invalid
+155:15: The 'threads' backend of prange does not take a schedule
+160:19: The 'threads' backend of prange is only supported for the outermost parallel construct
+164:19: The 'threads' backend of prange is only supported for the outermost parallel construct
+167:32: cython.parallel.task() must be used inside a parallel section
+172:29: Invalid keyword argument: num_threads
+173:8: Reductions not allowed for tasks
+177:33: cython.parallel.task() may only be used without the GIL
+181:29: cython.parallel.task() is not supported by the 'threads' backend of prange
+186:33: cython.parallel.task() may not be used in a nested prange
+194:42: 't' must be a C array or memoryview to be a reduction without combiner
+197:43: Items of reduction variable 'arr' must all be updated with the same in-place operator (one of &, *, +, -, ^, |)
+197:50: Reduction variable 'missing' is not declared
+201:42: Items of reduction variable 'arr' must all be updated with the same in-place operator (one of &, *, +, -, ^, |)
+204:50: Reduction combiner for 'arr' must take two arguments of type 'long [4]' and return it
+204:68: Reduction combiner for 'total' must take two arguments of type 'double' and return it
+208:19: prange(reduction=...) is only supported for the outermost parallel construct
 """
@@ -0,0 +1,123 @@
+# mode: run
+# tag: memoryview
+
+# Copies between differently laid out slices go through item size specific
+# strided and blocked kernels.  Test all item sizes against a plain loop.
+
+from cython.view cimport array
+
+ctypedef fused number:
+    signed char
+    short
+    int
+    double
+    double complex
+
+ctypedef struct triple:
+    char a, b, c
+
+LAYOUTS = [
+    ('c', 'c', 1, 1),
+    ('c', 'fortran', 1, 1),
+    ('fortran', 'c', 1, 1),
+    ('fortran', 'fortran', 1, 1),
+    ('c', 'fortran', 2, 3),
+    ('fortran', 'c', 3, 1),
+    ('c', 'c', -1, 2),
+    ('c', 'fortran', 1, -1),
+]
+
+
+cdef number value(number dummy, Py_ssize_t i):
+    return <number> (i % 101)
+
+
+cdef int check_2d(number dummy, fmt, Py_ssize_t n, Py_ssize_t m) except -1:
+    cdef number[:, :] src, dst
+    cdef Py_ssize_t i, j
+    for src_mode, dst_mode, step0, step1 in LAYOUTS:
+        src = array((n * abs(step0), m * abs(step1)), sizeof(number), fmt, src_mode)
+        for i in range(src.shape[0]):
+            for j in range(src.shape[1]):
+                src[i, j] = value(dummy, i * 1000 + j)
+        src = src[::step0, ::step1]
+        dst = array((n, m), sizeof(number), fmt, dst_mode)
+        dst[...] = src
+        for i in range(n):
+            for j in range(m):
+                assert dst[i, j] == src[i, j], (src_mode, dst_mode, step0, step1, i, j)
+
+
+def test_copy_2d(Py_ssize_t n, Py_ssize_t m):
+    """
+    >>> test_copy_2d(1, 1)
+    >>> test_copy_2d(5, 70)
+    >>> test_copy_2d(70, 45)
+    """
+    cdef signed char c = 0
+    cdef short s = 0
+    cdef int i = 0
+    cdef double d = 0
+    cdef double complex z = 0
+    check_2d(c, 'b', n, m)
+    check_2d(s, 'h', n, m)
+    check_2d(i, 'i', n, m)
+    check_2d(d, 'd', n, m)
+    check_2d(z, 'Zd', n, m)
+
+
+def test_copy_3d(Py_ssize_t n):
+    """
+    >>> test_copy_3d(1)
+    >>> test_copy_3d(40)
+    """
+    cdef double[:, :, :] src = array((n, n + 1, n + 2), sizeof(double), 'd', 'c')
+    cdef double[::1, :, :] dst
+    cdef Py_ssize_t i, j, k
+    for i in range(n):
+        for j in range(n + 1):
+            for k in range(n + 2):
+                src[i, j, k] = i * 10000 + j * 100 + k
+    dst = src.copy_fortran()
+    for i in range(n):
+        for j in range(n + 1):
+            for k in range(n + 2):
+                assert dst[i, j, k] == src[i, j, k], (i, j, k)
+    src = dst[::-1, :, ::2].copy()
+    for i in range(n):
+        for j in range(n + 1):
+            for k in range(0, n + 2, 2):
+                assert src[n - i - 1, j, k // 2] == dst[i, j, k], (i, j, k)
+
+
+def test_broadcast(Py_ssize_t n):
+    """
+    >>> test_broadcast(50)
+    """
+    cdef int[:, :] src = array((1, n), sizeof(int), 'i', 'c')
+    cdef int[::1, :] dst = array((n, n), sizeof(int), 'i', 'fortran')
+    cdef Py_ssize_t i, j
+    for j in range(n):
+        src[0, j] = j
+    dst[...] = src
+    for i in range(n):
+        for j in range(n):
+            assert dst[i, j] == j, (i, j)
+
+
+def test_odd_itemsize(Py_ssize_t n):
+    """
+    >>> test_odd_itemsize(40)
+    """
+    cdef triple[:, :] src = array((n, n), sizeof(triple), 'ccc', 'c')
+    cdef triple[::1, :] dst
+    cdef Py_ssize_t i, j
+    for i in range(n):
+        for j in range(n):
+            src[i, j].a = i
+            src[i, j].b = j
+            src[i, j].c = i ^ j
+    dst = src.copy_fortran()
+    for i in range(n):
+        for j in range(n):
+            assert (dst[i, j].a, dst[i, j].b, dst[i, j].c) == (i, j, i ^ j), (i, j)
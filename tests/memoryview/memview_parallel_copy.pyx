@@ -0,0 +1,126 @@
+# mode: run
+# tag: memoryview, openmp
+# distutils: define_macros=CYTHON_MEMVIEW_PARALLEL_THRESHOLD=1
+
+# With a parallel threshold, copies and scalar fills are split across
+# OpenMP threads.  Results, overlap handling and refcounts must not change.
+
+cimport openmp
+from cython.parallel cimport prange
+from cython.view cimport array
+
+import sys
+
+openmp.omp_set_num_threads(4)
+
+
+def test_copy_2d(Py_ssize_t n, Py_ssize_t m):
+    """
+    >>> test_copy_2d(1, 1)
+    >>> test_copy_2d(3, 200)
+    >>> test_copy_2d(101, 67)
+    """
+    cdef double[:, :] src = array((n, m), sizeof(double), 'd', 'c')
+    cdef double[:, :] dst
+    cdef Py_ssize_t i, j
+    for i in range(n):
+        for j in range(m):
+            src[i, j] = i * 1000 + j
+    for mode in ('c', 'fortran'):
+        dst = array((n, m), sizeof(double), 'd', mode)
+        dst[...] = src
+        for i in range(n):
+            for j in range(m):
+                assert dst[i, j] == src[i, j], (mode, i, j)
+        dst[...] = 0
+        dst[::2, ::3] = src[::-2, ::3]
+        for i in range(0, n, 2):
+            for j in range(m):
+                assert dst[i, j] == (src[n - 1 - i, j] if j % 3 == 0 else 0), (mode, i, j)
+
+
+def test_copy_3d(Py_ssize_t n):
+    """
+    >>> test_copy_3d(1)
+    >>> test_copy_3d(30)
+    """
+    cdef int[:, :, :] src = array((n, n + 1, n + 2), sizeof(int), 'i', 'c')
+    cdef int[::1, :, :] dst
+    cdef Py_ssize_t i, j, k
+    for i in range(n):
+        for j in range(n + 1):
+            for k in range(n + 2):
+                src[i, j, k] = i * 10000 + j * 100 + k
+    dst = src.copy_fortran()
+    for i in range(n):
+        for j in range(n + 1):
+            for k in range(n + 2):
+                assert dst[i, j, k] == src[i, j, k], (i, j, k)
+
+
+def test_overlapping_copy(Py_ssize_t n):
+    """
+    >>> test_overlapping_copy(1000)
+    """
+    cdef int[:] a = array((n,), sizeof(int), 'i')
+    cdef Py_ssize_t i
+    for i in range(n):
+        a[i] = i
+    a[1:] = a[:-1]
+    assert a[0] == 0
+    for i in range(1, n):
+        assert a[i] == i - 1, i
+
+
+def test_object_copy(Py_ssize_t n):
+    """
+    >>> test_object_copy(100)
+    """
+    cdef object[:, :] src = array((n, n), sizeof(void *), 'O', 'c')
+    cdef object[:, :] dst = array((n, n), sizeof(void *), 'O', 'fortran')
+    cdef Py_ssize_t i, j
+    value = object()
+    other = object()
+    src[...] = value
+    dst[...] = other
+    count = sys.getrefcount(value)
+    dst[...] = src
+    assert sys.getrefcount(value) == count + n * n, (count, sys.getrefcount(value))
+    for i in range(n):
+        for j in range(n):
+            assert dst[i, j] is value, (i, j)
+    del src, dst
+    assert sys.getrefcount(value) == count - n * n
+
+
+def test_assign_scalar(Py_ssize_t n):
+    """
+    >>> test_assign_scalar(101)
+    """
+    cdef long[:, :] a = array((n, n), sizeof(long), 'l', 'c')
+    cdef Py_ssize_t i, j
+    cdef object view = a  # Python level assignment goes through slice_assign_scalar()
+    view[...] = 5
+    for i in range(n):
+        for j in range(n):
+            assert a[i, j] == 5, (i, j)
+    view[:, ::3] = 7
+    for i in range(n):
+        for j in range(n):
+            assert a[i, j] == (7 if j % 3 == 0 else 5), (i, j)
+
+
+def test_nested_in_prange(Py_ssize_t n):
+    """
+    >>> test_nested_in_prange(50)
+    """
+    cdef double[:, :, :] src = array((4, n, n), sizeof(double), 'd', 'c')
+    cdef double[:, :, :] dst = array((4, n, n), sizeof(double), 'd', 'fortran')
+    cdef Py_ssize_t i, j, k
+    src[...] = 1.5
+    for i in prange(4, nogil=True):
+        dst[i, :, :] = src[i, :, :]
+    for i in range(4):
+        for j in range(n):
+            for k in range(n):
+                assert dst[i, j, k] == 1.5, (i, j, k)
@@ -0,0 +1,204 @@
+# mode: run
+# tag: getattr, methodcall
+
+# Attribute lookups and method calls use per call site caches, which must
+# follow all changes of the types and instances that they have seen.
+
+cimport cython
+
+
+def call_method(obj):
+    return obj.method()
+
+
+def get_attr(obj):
+    return obj.attr
+
+
+class A(object):
+    attr = 'A.attr'
+    def method(self):
+        return 'A.method'
+
+
+class B(A):
+    def method(self):
+        return 'B.method'
+
+
+def test_polymorphic():
+    """
+    >>> test_polymorphic()
+    ['A.method', 'B.method', 'C0', 'C1', 'C2', 'C3', 'C4', 'C5', 'A.method', 'B.method']
+    """
+    classes = [A, B] + [type('C%d' % i, (object,), {'method': lambda self, i=i: 'C%d' % i}) for i in range(6)]
+    classes += [A, B]
+    return [call_method(cls()) for cls in classes]
+
+
+def test_modified_class():
+    """
+    >>> test_modified_class()
+    ['A.method', 'A.method', 'patched', 'patched', 'B.method', 'patched base', 'A.attr', 'new attr']
+    """
+    class A(object):
+        attr = 'A.attr'
+        def method(self):
+            return 'A.method'
+    class B(A):
+        pass
+    a, b = A(), B()
+    result = [call_method(a), call_method(b)]
+    A.method = lambda self: 'patched'
+    result += [call_method(a), call_method(b)]
+    B.method = lambda self: 'B.method'
+    result.append(call_method(b))
+    del B.method
+    A.method = lambda self: 'patched base'
+    result.append(call_method(b))
+    result.append(get_attr(a))
+    A.attr = 'new attr'
+    result.append(get_attr(b))
+    return result
+
+
+def test_instance_dict():
+    """
+    >>> test_instance_dict()
+    ['A.method', 'instance', 'A.method', 'A.attr', 'instance attr', 'A.attr']
+    """
+    a = A()
+    result = [call_method(a)]
+    a.method = lambda: 'instance'
+    result.append(call_method(a))
+    del a.method
+    result.append(call_method(a))
+    result.append(get_attr(a))
+    a.attr = 'instance attr'
+    result.append(get_attr(a))
+    result.append(get_attr(A()))
+    return result
+
+
+class WithProperty(object):
+    def __init__(self):
+        self.__dict__['attr'] = 'shadowed'
+        self.__dict__['method'] = lambda: 'shadowed'
+
+    @property
+    def attr(self):
+        return 'property'
+
+    @property
+    def method(self):
+        return lambda: 'property method'
+
+
+class Slots(object):
+    __slots__ = ('attr', 'method')
+
+
+class Descriptors(object):
+    @classmethod
+    def method(cls):
+        return 'classmethod of %s' % cls.__name__
+
+    @staticmethod
+    def attr():
+        return 'staticmethod'
+
+
+class PyDescriptor(object):
+    def __get__(self, obj, cls):
+        return lambda: 'descriptor'
+
+
+class WithPyDescriptor(object):
+    method = PyDescriptor()
+    attr = 42
+
+
+def test_descriptors():
+    """
+    >>> test_descriptors()
+    ['property method', 'property', 'slot method', 'slot attr', 'classmethod of Descriptors', 'descriptor', 42]
+    """
+    s = Slots()
+    s.method = lambda: 'slot method'
+    s.attr = 'slot attr'
+    result = []
+    for obj in [WithProperty(), s, Descriptors()]:
+        result.append(call_method(obj))
+        if obj.__class__ is not Descriptors:
+            result.append(get_attr(obj))
+    result.append(call_method(WithPyDescriptor()))
+    result.append(get_attr(WithPyDescriptor()))
+    return result
+
+
+class GetAttr(object):
+    def __getattr__(self, name):
+        return lambda: 'getattr ' + name
+
+
+@cython.test_assert_path_exists("//AttributeNode[@use_inline_cache = True]")
+def test_missing():
+    """
+    >>> test_missing()
+    ['getattr method', "'A' object has no attribute 'missing'", 'AttributeError', 'getattr method']
+    """
+    result = []
+    for obj in [GetAttr(), A(), Slots(), GetAttr()]:
+        try:
+            result.append(obj.missing if obj.__class__ is A else obj.method())
+        except AttributeError as e:
+            result.append(str(e) if obj.__class__ is A else e.__class__.__name__)
+    return result
+
+
+def test_builtins():
+    """
+    >>> test_builtins()
+    ([1, 2], 'A-B', 1.0)
+    """
+    l = []
+    for i in range(1, 3):
+        l.append(i)
+    s = '-'.join(['a', 'b']).upper()
+    return l, s, (1j).imag.real.__class__(1)
+
+
+def test_types_and_modules():
+    """
+    >>> test_types_and_modules()
+    ('A.method', 'A.attr', True)
+    """
+    import sys
+    return A.method(A()), A.attr, sys.modules is sys.modules
+
+
+def bound_method(obj):
+    """
+    >>> bound_method(A())()
+    'A.method'
+    """
+    return obj.method
+
+
+def method_call_args(obj, *args):
+    """
+    >>> method_call_args([3, 1, 2], None, True)
+    [3, 2, 1]
+    """
+    obj.sort(key=args[0], reverse=args[1])
+    return obj
+
+
+@cython.optimize.inline_caches(False)
+@cython.test_fail_if_path_exists("//AttributeNode[@use_inline_cache = True]")
+def uncached(obj):
+    """
+    >>> uncached(A())
+    ('A.method', 'A.attr')
+    """
+    return obj.method(), obj.attr
@@ -0,0 +1,118 @@
+# mode: run
+# tag: complex
+
+cimport cython
+
+
+@cython.complex_fastmath(True)
+def test_arithmetic(double complex z, double complex w):
+    """
+    >>> test_arithmetic(2j, 4j)
+    (6j, -2j, (-8+0j), (0.5+0j))
+    >>> test_arithmetic(6+12j, 3j)
+    ((6+15j), (6+9j), (-36+18j), (4-2j))
+    >>> test_arithmetic(5-10j, 3+4j)
+    ((8-6j), (2-14j), (55-10j), (-1-2j))
+    """
+    return z+w, z-w, z*w, z/w
+
+
+@cython.complex_fastmath(True)
+def test_float_arithmetic(float complex z, float complex w):
+    """
+    >>> test_float_arithmetic(6+12j, 3j)
+    ((-36+18j), (4-2j), 3.0)
+    """
+    return z*w, z/w, abs(w)
+
+
+@cython.complex_fastmath(True)
+def test_long_double_arithmetic(long double complex z, long double complex w):
+    """
+    >>> test_long_double_arithmetic(5-10j, 3+4j)
+    ((55-10j), (-1-2j), 5.0)
+    """
+    return z*w, z/w, abs(w)
+
+
+@cython.complex_fastmath(True)
+def test_mixed(double complex z, double x):
+    """
+    >>> test_mixed(6+12j, 3)
+    ((18+36j), (2+4j), (0.1-0.2j))
+    """
+    return z*x, z/x, x/z
+
+
+@cython.complex_fastmath(True)
+def test_inplace(double complex z, double complex w):
+    """
+    >>> test_inplace(6+12j, 3j)
+    (4-2j)
+    """
+    z *= w
+    z /= w
+    z /= w
+    return z
+
+
+@cython.complex_fastmath(True)
+def test_abs(double complex z):
+    """
+    >>> test_abs(3+4j)
+    5.0
+    >>> test_abs(-3-4j)
+    5.0
+    >>> test_abs(0j)
+    0.0
+    """
+    return abs(z)
+
+
+@cython.complex_fastmath(True)
+def test_pow(double complex z, double complex w):
+    """
+    >>> abs(test_pow(1j, 2) - (-1)) < 1e-12
+    True
+    """
+    # '**' is not affected by the directive
+    return z ** w
+
+
+def test_div_strict(double complex a, double complex b):
+    """
+    >>> big = 2.0**1023
+    >>> test_div_strict(1 + 1j, 1 + big*1j) == 1/big - 1j/big
+    True
+    """
+    return a / b
+
+
+@cython.complex_fastmath(True)
+def test_div_fast(double complex a, double complex b):
+    """
+    The fast division does not rescale the divisor and loses huge values.
+
+    >>> test_div_fast(1 + 1j, 2 - 2j)
+    0.5j
+    >>> big = 2.0**1023
+    >>> test_div_fast(1 + 1j, 1 + big*1j) == 0
+    True
+    """
+    return a / b
+
+
+@cython.complex_fastmath(True)
+def test_nogil(double complex w):
+    """
+    >>> test_nogil(1j)
+    [(-1+0j), 2j, (-4+3j)]
+    """
+    cdef double complex zs[3]
+    cdef Py_ssize_t i
+    zs[0], zs[1], zs[2] = 1j, 2, 3+4j
+    with nogil:
+        for i in range(3):
+            zs[i] = zs[i] * w / (w * w)
+            zs[i] = zs[i] * w * w
+    return [zs[i] for i in range(3)]
@@ -0,0 +1,152 @@
+# mode: run
+# tag: coroutines, await
+
+# Awaiting a Cython coroutine that completes without suspending runs it directly.
+# The result and exceptions must look the same as for delegated awaits.
+
+
+class Suspend(object):
+    def __await__(self):
+        yield 'suspended'
+
+
+def run(coroutine):
+    values = []
+    try:
+        while True:
+            values.append(coroutine.send(None))
+    except StopIteration as exc:
+        return values, exc.args[0] if exc.args else None
+
+
+async def value(x):
+    return x
+
+
+async def nothing():
+    pass
+
+
+async def chain(depth, x):
+    if depth == 0:
+        return x
+    return await chain(depth - 1, x) + 1
+
+
+async def fail(x):
+    raise ValueError(x)
+
+
+async def suspend_then(x):
+    await Suspend()
+    return x
+
+
+def test_value():
+    """
+    >>> run(test_value())
+    ([], (1, None, None))
+    """
+    async def inner():
+        a = await value(1)
+        b = await nothing()
+        await value(2)  # unused result
+        c = await value(None)
+        return a, b, c
+    return inner()
+
+
+def test_stopiteration_result():
+    """
+    >>> run(test_stopiteration_result())
+    ([], (StopIteration(), 5))
+    """
+    async def inner():
+        exc = await value(StopIteration())
+        values = await value((5,))
+        return exc, values[0]
+    return inner()
+
+
+def test_chain(depth):
+    """
+    >>> run(test_chain(0))
+    ([], 10)
+    >>> run(test_chain(50))
+    ([], 60)
+    """
+    return chain(depth, 10)
+
+
+def test_exception():
+    """
+    >>> run(test_exception())
+    ([], 'ValueError: 1')
+    """
+    async def inner():
+        try:
+            await fail(1)
+        except ValueError as exc:
+            return 'ValueError: %s' % exc
+    return inner()
+
+
+def test_uncaught_exception():
+    """
+    >>> run(test_uncaught_exception())
+    Traceback (most recent call last):
+    ValueError: 2
+    """
+    async def inner():
+        await fail(2)
+    return inner()
+
+
+def test_suspend():
+    """
+    >>> run(test_suspend())
+    (['suspended', 'suspended'], 5)
+    """
+    async def inner():
+        a = await suspend_then(1)
+        b = await value(2)
+        c = await suspend_then(2)
+        return a + b + c
+    return inner()
+
+
+def test_awaited_twice():
+    """
+    >>> run(test_awaited_twice())
+    ([], 'RuntimeError')
+    """
+    async def inner():
+        c = value(1)
+        await c
+        try:
+            await c
+        except RuntimeError:
+            return 'RuntimeError'
+    return inner()
+
+
+def test_async_for():
+    """
+    >>> run(test_async_for())
+    ([], [0, 1, 2])
+    """
+    class AsyncIter(object):
+        def __init__(self, n):
+            self.i = 0
+            self.n = n
+        def __aiter__(self):
+            return self
+        async def __anext__(self):
+            if self.i >= self.n:
+                raise StopAsyncIteration
+            self.i += 1
+            return self.i - 1
+
+    async def inner():
+        return [i async for i in AsyncIter(3)]
+    return inner()
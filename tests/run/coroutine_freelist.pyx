@@ -0,0 +1,101 @@
+# mode: run
+# tag: generators, coroutines, freelist
+
+# Generator and coroutine objects are reused from freelists.  Reused objects
+# must not carry over any state from their previous life.
+
+import gc
+import weakref
+
+
+def gen(n):
+    for i in range(n):
+        yield i
+
+
+async def coro(x):
+    return x
+
+
+def unfinished():
+    try:
+        yield 1
+    finally:
+        finalized.append(True)
+
+finalized = []
+
+
+def run(coroutine):
+    try:
+        coroutine.send(None)
+    except StopIteration as exc:
+        return exc.args[0] if exc.args else None
+
+
+def test_alternating_types(n):
+    """
+    >>> test_alternating_types(200)
+    True
+    """
+    for i in range(n):
+        g = gen(i % 3)
+        assert g.__name__ == 'gen', g.__name__
+        assert g.gi_running == 0
+        assert list(g) == list(range(i % 3))
+        del g
+        c = coro(i)
+        assert c.__name__ == 'coro', c.__name__
+        assert c.cr_await is None
+        assert run(c) == i
+        del c
+    return True
+
+
+def test_weakrefs(n):
+    """
+    >>> test_weakrefs(50)
+    True
+    """
+    for i in range(n):
+        g = gen(2)
+        ref = weakref.ref(g)
+        assert ref() is g
+        del g
+        assert ref() is None
+    return True
+
+
+def test_finalize_reused(n):
+    """
+    >>> test_finalize_reused(20)
+    20
+    """
+    del finalized[:]
+    for i in range(n):
+        g = unfinished()
+        next(g)
+        del g
+        gc.collect()
+        # finished objects are reused in between
+        list(gen(2))
+    return len(finalized)
+
+
+async def agen(n):
+    for i in range(n):
+        yield i
+
+
+async def collect(n):
+    return [i async for i in agen(n)]
+
+
+def test_async_generators(n):
+    """
+    >>> test_async_generators(30)
+    True
+    """
+    for i in range(n):
+        assert run(collect(i % 4)) == list(range(i % 4))
+    return True
@@ -97,6 +97,36 @@ def test_int_vector(o):
     cdef vector[int] v = o
     return v
 
+class LengthHint(object):
+    def __init__(self, items, hint):
+        self.items = iter(items)
+        self.hint = hint
+    def __iter__(self):
+        return self
+    def __next__(self):
+        return next(self.items)
+    next = __next__
+    def __length_hint__(self):
+        if isinstance(self.hint, Exception):
+            raise self.hint
+        return self.hint
+
+def test_int_vector_length_hint(o):
+    """
+    >>> test_int_vector_length_hint(i for i in range(5))
+    [0, 1, 2, 3, 4]
+    >>> test_int_vector_length_hint(LengthHint([1, 2, 3], 1))
+    [1, 2, 3]
+    >>> test_int_vector_length_hint(LengthHint([1, 2], 100))
+    [1, 2]
+    >>> test_int_vector_length_hint(LengthHint([1, 2], sys.maxsize))
+    [1, 2]
+    >>> test_int_vector_length_hint(LengthHint([1, 2], ValueError("hint")))  # not asked
+    [1, 2]
+    """
+    cdef vector[int] v = o
+    return v
+
 def test_string_vector(s):
     """
     >>> list(map(normalize, test_string_vector('ab cd ef gh'.encode('ascii'))))
@@ -189,6 +219,12 @@ def test_unordered_set(o):
    [1, 2, 3]
    >>> type(test_unordered_set([])) is py_set
    True
+   >>> sorted(test_unordered_set(i for i in range(5)))
+   [0, 1, 2, 3, 4]
+   >>> sorted(test_unordered_set(LengthHint([1, 2, 3], 1000)))
+   [1, 2, 3]
+   >>> sorted(test_unordered_set(LengthHint([1, 2, 3], sys.maxsize)))
+   [1, 2, 3]
    """
    cdef unordered_set[long] s = o
    return s
@@ -0,0 +1,90 @@
+# mode: run
+# tag: cpp, cpp17, werror
+# cython: c_string_encoding=ascii, c_string_type=bytes
+
+from libcpp.string cimport string
+from libcpp.string_view cimport string_view, to_string
+
+
+def view_size(bytes b):
+    """
+    >>> view_size(b"abc")
+    3
+    >>> view_size(b"")
+    0
+    """
+    cdef string_view sv = b
+    return sv.size()
+
+
+def shares_buffer(bytes b):
+    """
+    >>> shares_buffer(b"abcdef")
+    True
+    """
+    cdef string_view sv = b
+    cdef const char* data = b
+    return sv.data() == data
+
+
+def roundtrip(bytes b):
+    """
+    >>> roundtrip(b"abc\\x00def")
+    b'abc\\x00def'
+    """
+    cdef string_view sv = b
+    return sv
+
+
+def from_unicode(unicode u):
+    """
+    >>> from_unicode(u"abc")
+    b'bc'
+    """
+    cdef string_view sv = u
+    return sv.substr(1)
+
+
+def find(bytes b, bytes sub):
+    """
+    >>> find(b"abcdef", b"cd")
+    2
+    """
+    cdef string_view sv = b
+    return sv.find(string_view(sub))
+
+
+def decode(bytes b):
+    """
+    >>> decode(b"abcdef")
+    'bcd'
+    """
+    cdef string_view sv = b
+    return sv.decode('ascii')[1:4]
+
+
+def copy_to_string(bytes b):
+    """
+    >>> copy_to_string(b"abc")
+    b'abcabc'
+    """
+    cdef string_view sv = b
+    cdef string s = to_string(sv)
+    s.append(s)
+    return s
+
+
+cdef Py_ssize_t count_char(string_view sv, char c) except -1:
+    cdef Py_ssize_t n = 0
+    for ch in sv:
+        if ch == c:
+            n += 1
+    return n
+
+
+def call_with_view(bytes b):
+    """
+    >>> call_with_view(b"banana")
+    3
+    """
+    return count_char(b, b'a')
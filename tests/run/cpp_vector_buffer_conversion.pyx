@@ -0,0 +1,86 @@
+# mode: run
+# tag: cpp, werror
+
+# Vectors of arithmetic types are copied in bulk from buffers with a
+# matching item type, and anything else is converted item by item.
+
+from libc.stdint cimport int64_t, uint8_t
+from libcpp.vector cimport vector
+
+from array import array
+
+
+cdef class RejectingExporter:
+    """
+    Supports the buffer protocol, but refuses to export a buffer.
+    """
+    cdef list items
+
+    def __init__(self, items):
+        self.items = items
+
+    def __getbuffer__(self, Py_buffer *buffer, int flags):
+        raise BufferError("no buffer with flags %d" % flags)
+
+    def __iter__(self):
+        return iter(self.items)
+
+
+def double_vector(o):
+    """
+    >>> double_vector(array('d', [1.5, 2.5, -3.0]))
+    [1.5, 2.5, -3.0]
+    >>> double_vector(array('d'))
+    []
+    >>> double_vector(array('f', [1.5, 2.5]))
+    [1.5, 2.5]
+    >>> double_vector(array('i', [1, 2]))
+    [1.0, 2.0]
+    >>> double_vector(memoryview(array('d', range(10)))[::3])
+    [0.0, 3.0, 6.0, 9.0]
+    >>> double_vector([1, 2.5])
+    [1.0, 2.5]
+    >>> double_vector(RejectingExporter([1.5, 2.5]))
+    [1.5, 2.5]
+    """
+    cdef vector[double] v = o
+    return v
+
+
+def int64_vector(o):
+    """
+    >>> int64_vector(array('q', [1, -2, 2**40]))
+    [1, -2, 1099511627776]
+    >>> int64_vector(array('Q', [1, 2**40]))
+    [1, 1099511627776]
+    >>> int64_vector(array('b', [-1, 2]))
+    [-1, 2]
+    >>> int64_vector(array('Q', [2**63]))  # doctest: +ELLIPSIS
+    Traceback (most recent call last):
+    OverflowError: ...
+    """
+    cdef vector[int64_t] v = o
+    return v
+
+
+def uint8_vector(o):
+    """
+    >>> uint8_vector(b'abc')
+    [97, 98, 99]
+    >>> uint8_vector(bytearray(b'xy'))
+    [120, 121]
+    >>> uint8_vector(array('b', [1, -1]))
+    Traceback (most recent call last):
+    OverflowError: can't convert negative value to uint8_t
+    """
+    cdef vector[uint8_t] v = o
+    return v
+
+
+def bint_vector(o):
+    """
+    >>> bint_vector(b'\\x00\\x02')
+    [False, True]
+    """
+    cdef vector[bint] v = o
+    return v
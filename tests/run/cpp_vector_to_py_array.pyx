@@ -0,0 +1,46 @@
+# mode: run
+# tag: cpp, werror
+# cython: cpp_vector_to_py=array
+
+from libc.stdint cimport int16_t
+from libcpp.string cimport string
+from libcpp.vector cimport vector
+
+
+def double_vector(o):
+    """
+    >>> double_vector([1, 2.5])
+    array('d', [1.0, 2.5])
+    >>> double_vector([])
+    array('d')
+    """
+    cdef vector[double] v = o
+    return v
+
+
+def int16_vector(o):
+    """
+    >>> a = int16_vector([1, -2])
+    >>> a.typecode, list(a)
+    ('h', [1, -2])
+    """
+    cdef vector[int16_t] v = o
+    return v
+
+
+def nested_vector(o):
+    """
+    >>> nested_vector([[1, 2], []])
+    [array('i', [1, 2]), array('i')]
+    """
+    cdef vector[vector[int]] v = o
+    return v
+
+
+def string_vector(o):
+    """
+    >>> string_vector([b'ab']) == [b'ab']
+    True
+    """
+    cdef vector[string] v = o
+    return v
@@ -0,0 +1,111 @@
+# mode: run
+# tag: cyfunction, METH_FASTCALL, fused
+
+# Calls of binding functions through vectorcall must behave like calls through tp_call.
+
+cimport cython
+
+
+cdef class C:
+    def varargs(self, *args, **kwargs):
+        return type(self).__name__, args, sorted(kwargs.items())
+
+    def only_varargs(*args):
+        return len(args)
+
+    def fused(self, cython.floating x, y=1):
+        return cython.typeof(x), y
+
+    @staticmethod
+    def static_fused(cython.floating x):
+        return cython.typeof(x)
+
+
+def test_varargs_method():
+    """
+    >>> test_varargs_method()
+    ('C', (), [])
+    ('C', (1, 2), [])
+    ('C', (1,), [('a', 2)])
+    ('C', (1, 2), [('b', 3)])
+    ('C', (), [('a', 1)])
+    ('C', (1, 2), [('a', 3)])
+    """
+    c = C()
+    print(c.varargs())
+    print(c.varargs(1, 2))
+    print(c.varargs(1, a=2))
+    bound = c.varargs
+    print(bound(1, 2, b=3))
+    print(C.varargs(c, a=1))
+    args, kwargs = (1, 2), {'a': 3}
+    print(c.varargs(*args, **kwargs))
+
+
+def test_varargs_method_errors():
+    """
+    >>> test_varargs_method_errors()
+    TypeError
+    TypeError
+    """
+    try:
+        C.varargs()
+    except TypeError:
+        print("TypeError")
+    try:
+        C.varargs(**{'a': 1})
+    except TypeError:
+        print("TypeError")
+
+
+def test_only_varargs():
+    """
+    >>> test_only_varargs()
+    (1, 3)
+    """
+    c = C()
+    return c.only_varargs(), c.only_varargs(1, 2)
+
+
+def test_fused_method():
+    """
+    >>> test_fused_method()
+    ('double', 1)
+    ('float', 2)
+    ('double', 3)
+    ('double', 4)
+    ('float', 5)
+    """
+    c = C()
+    print(c.fused(1.0))
+    print(c.fused[float](1.0, 2))
+    print(C.fused(c, 1.0, y=3))
+    bound = c.fused
+    print(bound(1.0, **{'y': 4}))
+    print(C.fused[float](c, 1.0, 5))
+
+
+def test_static_fused():
+    """
+    >>> C.static_fused(1.0), C.static_fused[float](1.0), C().static_fused(1.0)
+    ('double', 'float', 'double')
+    """
+
+
+def fused_func(cython.floating x, *, scale=1):
+    return cython.typeof(x), x * scale
+
+
+def test_fused_function():
+    """
+    >>> test_fused_function()
+    ('double', 2.0)
+    ('float', 6.0)
+    No matching signature found
+    """
+    print(fused_func(2.0))
+    print(fused_func[float](2.0, scale=3))
+    try:
+        fused_func("abc")
+    except TypeError as exc:
+        print(exc)
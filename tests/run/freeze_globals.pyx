@@ -0,0 +1,108 @@
+# mode: run
+# tag: globals
+# cython: optimize.freeze_globals=True
+
+import sys
+if sys.version_info[0] >= 3:
+    import builtins
+else:
+    import __builtin__ as builtins
+
+from math import sqrt
+
+SCALE = 3
+counter = 0
+
+# Known to the compiler as globals, but undefined after module init.
+LATE = cython_test_builtin = None
+del LATE, cython_test_builtin
+
+
+def scale(x):
+    """
+    >>> scale(2)
+    6
+    >>> module = sys.modules[__name__]
+    >>> module.SCALE = 5
+    >>> scale(2)  # frozen after module init
+    6
+    >>> module.SCALE = 3
+    """
+    return x * SCALE
+
+
+def norm(x, y):
+    """
+    >>> norm(3, 4)
+    5.0
+    """
+    return sqrt(x * x + y * y)
+
+
+def increment():
+    """
+    >>> increment()
+    1
+    >>> increment()
+    2
+    >>> read_counter()
+    2
+    """
+    global counter
+    counter += 1
+    return counter
+
+
+def read_counter():
+    return counter
+
+
+def late_global():
+    """
+    >>> late_global()
+    Traceback (most recent call last):
+    NameError: name 'LATE' is not defined
+    >>> module = sys.modules[__name__]
+    >>> module.LATE = 1
+    >>> late_global()
+    1
+    >>> module.LATE = 2
+    >>> late_global()
+    2
+    >>> del module.LATE
+    """
+    return LATE
+
+
+def shadowed_builtin():
+    """
+    >>> builtins.cython_test_builtin = 1
+    >>> shadowed_builtin()
+    1
+    >>> builtins.cython_test_builtin = 2
+    >>> shadowed_builtin()
+    2
+    >>> module = sys.modules[__name__]
+    >>> module.cython_test_builtin = 3
+    >>> shadowed_builtin()
+    3
+    >>> del module.cython_test_builtin
+    >>> shadowed_builtin()
+    2
+    >>> del builtins.cython_test_builtin
+    >>> shadowed_builtin()
+    Traceback (most recent call last):
+    NameError: name 'cython_test_builtin' is not defined
+    """
+    return cython_test_builtin
+
+
+def in_loop(n):
+    """
+    >>> in_loop(4)
+    12
+    """
+    total = 0
+    for i in range(n):
+        total += SCALE
+    return total
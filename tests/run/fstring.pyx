@@ -245,6 +245,78 @@ def format_c_numbers_max(int n, long l):
     return s1, s2
 
 
+@cython.test_fail_if_path_exists(
+    "//CoerceToPyTypeNode",
+)
+def format_c_doubles(double d):
+    """
+    >>> for d in [0.0, -0.0, 1.0, -2.5, 1/3., 123456.789, 1e16, -1.5e-7, 2.0**70]:
+    ...     formatted = format_c_doubles(d)
+    ...     expected = '{0}|{0:.2}|{0:f}|{0:e}|{0:G}|{0:12}|{0:012.3f}|{0:9}'.format(d)
+    ...     assert formatted == expected, "%r != %r" % (formatted, expected)
+    >>> for d in [float('inf'), float('-inf'), float('nan')]:
+    ...     formatted = format_c_doubles(d)
+    ...     expected = '{0}|{0:.2}|{0:f}|{0:e}|{0:G}|{0:12}|{0:012.3f}|{0:9}'.format(d)
+    ...     assert formatted == expected, "%r != %r" % (formatted, expected)
+    """
+    return f"{d}|{d:.2}|{d:f}|{d:e}|{d:G}|{d:12}|{d:012.3f}|{d:9}"
+
+
+def format_c_numbers_mixed(int n, double d, unicode u):
+    u"""
+    >>> print(format_c_numbers_mixed(-5, 0.5, u'abc'))
+    n=-5 d=0.5 u=abc x=fffb? 0005
+    >>> print(format_c_numbers_mixed(12, -1.25, u'\\N{SNOWMAN}'))
+    n=12 d=-1.25 u=\N{SNOWMAN} x=c? 0012
+    >>> print(format_c_numbers_mixed(0, 1e100, u'\\N{OLD PERSIAN SIGN A}'))
+    n=0 d=1e+100 u=\N{OLD PERSIAN SIGN A} x=0? 0000
+    """
+    return f"n={n} d={d} u={u} x={<unsigned short>n:x}? {abs(n):04}"
+
+
+def format_c_numbers_error(int n, o):
+    """
+    >>> format_c_numbers_error(5, 'abc')
+    '5:abc:5'
+    >>> format_c_numbers_error(5, 1)  # doctest: +ELLIPSIS
+    Traceback (most recent call last):
+    TypeError: ...
+    """
+    return f"{n}:{o + 'abc'[:0]}:{n}"
+
+
+def format_c_numbers_yield(int n, double d, o):
+    """
+    >>> gen = format_c_numbers_yield(42, 1.5, 'abc')
+    >>> next(gen)
+    1
+    >>> print(gen.send('sent'))
+    0042-1.50-abc-sent-2a-1.5
+    """
+    s = f"{n:04}-{d:.2f}-{o}-{(yield 1)}-{n:x}-{d}"
+    yield s
+
+
+async def format_c_numbers_await(int n, double d, o):
+    """
+    >>> coro = format_c_numbers_await(42, 1.5, 'abc')
+    >>> try: coro.send(None)
+    ... except StopIteration as exc: print(exc.args[0])
+    0042-1.50-abc-awaited-2a-1.5
+    """
+    async def f():
+        return 'awaited'
+    return f"{n:04}-{d:.2f}-{o}-{await f()}-{n:x}-{d}"
+
+
+def format_c_numbers_conversion(int n, double d):
+    """
+    >>> print(format_c_numbers_conversion(42, 3.14))
+    42   |   42|42|3.14      |3.14  |3.14|3.14
+    """
+    return f"{n!s:5}|{n!r:>5}|{n!s}|{d!s:10.10}|{d!r:6}|{d!r}|{d!s}"
+
+
 def format_c_number_const():
     """
     >>> s = format_c_number_const()
@@ -0,0 +1,67 @@
+# mode: run
+# tag: kwargs
+
+# Functions with many keyword arguments look up the passed keywords
+# through a perfect hash table of the argument names.
+
+def many_kwonly(a, b=2, *, c=3, d=4, e=5, f=6, g=7, h=8, i=9, j=10):
+    """
+    >>> many_kwonly(1)
+    (1, 2, 3, 4, 5, 6, 7, 8, 9, 10)
+    >>> many_kwonly(1, j=0, c=0, h=0)
+    (1, 2, 0, 4, 5, 6, 7, 0, 9, 0)
+    >>> many_kwonly(a=1, b=0, g=0, f=0, e=0, d=0, i=0)
+    (1, 0, 3, 0, 0, 0, 0, 8, 0, 10)
+    >>> many_kwonly(1, **{'d': 0, 'i': 0})
+    (1, 2, 3, 0, 5, 6, 7, 8, 0, 10)
+
+    >>> many_kwonly(1, k=0)
+    Traceback (most recent call last):
+    TypeError: many_kwonly() got an unexpected keyword argument 'k'
+    >>> many_kwonly(1, jj=0)
+    Traceback (most recent call last):
+    TypeError: many_kwonly() got an unexpected keyword argument 'jj'
+    >>> many_kwonly(1, 2, c=0, b=0)
+    Traceback (most recent call last):
+    TypeError: many_kwonly() got multiple values for keyword argument 'b'
+    >>> many_kwonly(1, c=0, **{1: 2})  # doctest: +ELLIPSIS
+    Traceback (most recent call last):
+    TypeError: many_kwonly() keywords must be strings
+    """
+    return a, b, c, d, e, f, g, h, i, j
+
+
+def many_kwonly_kwargs(a, *, b=2, c=3, d=4, e=5, f=6, g=7, h=8, **kwargs):
+    """
+    >>> many_kwonly_kwargs(1, h=0, x=1, b=0)
+    (1, 0, 3, 4, 5, 6, 7, 0, [('x', 1)])
+    >>> many_kwonly_kwargs(a=1, hh=2, bb=3)
+    (1, 2, 3, 4, 5, 6, 7, 8, [('bb', 3), ('hh', 2)])
+    >>> many_kwonly_kwargs(1, **{u'\u57fa': 1, u'h\xe9': 2})[-1] == sorted({u'\u57fa': 1, u'h\xe9': 2}.items())
+    True
+    >>> many_kwonly_kwargs(1, a=2)
+    Traceback (most recent call last):
+    TypeError: many_kwonly_kwargs() got multiple values for keyword argument 'a'
+    """
+    return a, b, c, d, e, f, g, h, sorted(kwargs.items())
+
+
+def many_required_kwonly(*, a, b, c, d, e, f, g, h=8, i=9):
+    """
+    >>> many_required_kwonly(g=7, f=6, e=5, d=4, c=3, b=2, a=1, i=0)
+    (1, 2, 3, 4, 5, 6, 7, 8, 0)
+    >>> many_required_kwonly(a=1, b=2, c=3, d=4, e=5, f=6)
+    Traceback (most recent call last):
+    TypeError: many_required_kwonly() needs keyword-only argument g
+    """
+    return a, b, c, d, e, f, g, h, i
+
+
+def str_subclass_keywords():
+    """
+    >>> str_subclass_keywords()
+    (1, 2, 0, 4, 5, 6, 7, 8, 9, 0)
+    """
+    class StrSubclass(str):
+        pass
+    return many_kwonly(1, **{StrSubclass('c'): 0, StrSubclass('j'): 0})
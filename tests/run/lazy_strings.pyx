@@ -0,0 +1,136 @@
+# mode: run
+# tag: strings
+# cython: lazy_strings=True
+
+import sys
+
+CONSTANT = "module level"
+
+
+def use_strings(x):
+    """
+    >>> use_strings(1)
+    ('abc', 'module level', 'xyz1')
+    """
+    return "abc", CONSTANT, "xyz" + str(x)
+
+
+def kwargs(a, *, keyword_only="default", **kwargs):
+    """
+    >>> kwargs(1)
+    (1, 'default', [])
+    >>> kwargs(1, keyword_only="other", extra=2)
+    (1, 'other', [('extra', 2)])
+    >>> kwargs(a=1, **{"keyword_only": 3})
+    (1, 3, [])
+    """
+    return a, keyword_only, sorted(kwargs.items())
+
+
+def literal_tuple():
+    """
+    >>> literal_tuple()
+    ('tuple', 'of', 'strings')
+    >>> literal_tuple() is literal_tuple()
+    True
+    """
+    return ("tuple", "of", "strings")
+
+
+def attributes(obj):
+    """
+    >>> class Obj: pass
+    >>> o = Obj()
+    >>> attributes(o)
+    'attribute value'
+    >>> o.some_attribute
+    'attribute value'
+    """
+    obj.some_attribute = "attribute value"
+    return getattr(obj, "some_attribute")
+
+
+def generator(n):
+    """
+    >>> list(generator(3))
+    ['gen 0', 'gen 1', 'gen 2']
+    """
+    for i in range(n):
+        yield "gen %d" % i
+
+
+def closure():
+    """
+    >>> closure()()
+    'inner string'
+    """
+    def inner():
+        return "inner string"
+    return inner
+
+
+cdef str cdef_function(int i):
+    return "cdef string %d" % i
+
+
+def call_cdef_function():
+    """
+    >>> call_cdef_function()
+    'cdef string 5'
+    """
+    return cdef_function(5)
+
+
+cdef int nogil_function(int i) nogil:
+    with gil:
+        s = "from nogil"
+        assert s == "from nogil"
+    return i
+
+
+def call_nogil_function():
+    """
+    >>> call_nogil_function()
+    3
+    """
+    cdef int result
+    with nogil:
+        result = nogil_function(3)
+    return result
+
+
+cdef class ExtType:
+    """
+    >>> ExtType().method()
+    'method string'
+    >>> ExtType().prop
+    'property string'
+    >>> str(ExtType())
+    'str string'
+    """
+    def method(self):
+        return "method string"
+
+    @property
+    def prop(self):
+        return "property string"
+
+    def __str__(self):
+        return "str string"
+
+
+def shared_strings():
+    """
+    >>> shared_strings() == use_strings(1)
+    True
+    """
+    return "abc", CONSTANT, "xyz1"
+
+
+def interned_identifiers():
+    """
+    >>> interned_identifiers()
+    True
+    """
+    intern = sys.intern if sys.version_info[0] >= 3 else __builtins__.intern
+    return intern("".join(["some_", "identifier"])) is "some_identifier"
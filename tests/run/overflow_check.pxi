@@ -242,7 +242,7 @@ def test_lshift(INT a, int b):
     >>> expect_overflow(test_lshift, 1, size_in_bits)
     >>> expect_overflow(test_lshift, 0, size_in_bits + 1)
     >>> expect_overflow(test_lshift, 1, size_in_bits + 1)
-    >>> expect_overflow(test_lshift, 1, 100)
+    >>> expect_overflow(test_lshift, 1, 200)
     >>> expect_overflow(test_lshift, max_value, 1)
     >>> test_lshift(max_value, 0) == max_value
     True
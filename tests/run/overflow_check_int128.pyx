@@ -0,0 +1,14 @@
+# cython: overflowcheck.fold = False
+
+
+cdef extern from *:
+    """
+    #ifdef __SIZEOF_INT128__
+    typedef __int128 __pyx_test_int128;
+    #else
+    typedef PY_LONG_LONG __pyx_test_int128;
+    #endif
+    """
+    ctypedef long long INT "__pyx_test_int128"
+
+include "overflow_check.pxi"
@@ -0,0 +1,173 @@
+# mode: run
+# tag: overflowcheck
+
+cimport cython
+
+
+@cython.overflowcheck(True)
+@cython.test_fail_if_path_exists(
+    '//AddNode[@overflow_check = True and NameNode[@name = "i"]]',
+    '//SubNode[@overflow_check = True and NameNode[@name = "i"]]')
+def central_differences(list values):
+    """
+    >>> central_differences([1, 2, 4, 8, 16])
+    [3, 6, 12]
+    >>> central_differences([1, 2])
+    []
+    """
+    cdef Py_ssize_t i, stop = len(values) - 1
+    result = []
+    for i in range(1, stop):
+        result.append(values[i + 1] - values[i - 1])
+    return result
+
+
+# The operand types are chosen so that the loop variable is not wrapped in a coercion node.
+
+@cython.overflowcheck(True)
+@cython.test_fail_if_path_exists(
+    '//AddNode[@overflow_check = True and NameNode[@name = "i"]]',
+    '//SubNode[@overflow_check = True and NameNode[@name = "i"]]')
+def countdown(long stop):
+    """
+    >>> countdown(7)
+    [(9, 11), (8, 10), (7, 9)]
+    """
+    cdef long i
+    result = []
+    for i in range(10, stop, -1):
+        result.append((i - 1, i + 1))
+    return result
+
+
+@cython.overflowcheck(True)
+@cython.test_fail_if_path_exists(
+    '//SubNode[@overflow_check = True and NameNode[@name = "i"]]')
+@cython.test_assert_path_exists(
+    '//AddNode[@overflow_check = True and NameNode[@name = "i"]]')
+def unknown_upper_bound(long n):
+    """
+    >>> unknown_upper_bound(3)
+    [(-1, 2), (0, 3), (1, 4)]
+    """
+    cdef long i
+    result = []
+    for i in range(n):
+        # 'i + 1' is safe, but 'i + 2' may overflow for i == LONG_MAX - 1
+        result.append((i - 1, i + 2))
+    return result
+
+
+@cython.overflowcheck(True)
+@cython.test_fail_if_path_exists(
+    '//SubNode[@overflow_check = True and NameNode[@name = "i"]]')
+def unsigned_from_one(unsigned int n):
+    """
+    >>> unsigned_from_one(3)
+    [0, 1]
+    """
+    cdef unsigned int i
+    result = []
+    for i in range(1, n):
+        result.append(i - 1U)
+    return result
+
+
+@cython.overflowcheck(True)
+@cython.test_assert_path_exists(
+    '//SubNode[@overflow_check = True and NameNode[@name = "i"]]')
+def unsigned_from_zero(unsigned int n):
+    """
+    >>> unsigned_from_zero(3)
+    Traceback (most recent call last):
+    OverflowError: value too large
+    """
+    cdef unsigned int i
+    result = []
+    for i in range(n):
+        # 'i - 1' overflows for i == 0
+        result.append(i - 1U)
+    return result
+
+
+@cython.overflowcheck(True)
+@cython.test_assert_path_exists(
+    '//AddNode[@overflow_check = True and NameNode[@name = "i"]]')
+def assigned_in_loop(long n):
+    """
+    >>> assigned_in_loop(3)
+    [2, 4]
+    """
+    cdef long i
+    result = []
+    for i in range(n):
+        if i % 2:
+            continue
+        i += 1
+        result.append(i + 1)
+    return result
+
+
+cdef extern from *:
+    """
+    #include <limits.h>
+    """
+    const long LONG_MAX
+
+max_long = LONG_MAX
+
+
+@cython.overflowcheck(True)
+@cython.test_fail_if_path_exists(
+    '//AddNode[@overflow_check = True and NameNode[@name = "i"]]')
+def near_limit(long stop):
+    """
+    >>> near_limit(max_long)
+    [(2, 0), (1, 1)]
+    """
+    cdef long i
+    result = []
+    for i in range(stop - 2, stop):
+        result.append((stop - i, i + 1 - stop + 1))
+    return result
+
+
+@cython.overflowcheck(True)
+@cython.test_assert_path_exists(
+    '//AddNode[@overflow_check = True and NameNode[@name = "i"]]')
+def wider_unsigned_bound(unsigned long n):
+    """
+    The loop compares the 'long' variable against an 'unsigned long' bound,
+    so the variable can wrap around before the loop stops.
+
+    >>> wider_unsigned_bound(max_long) == max_long
+    True
+    >>> wider_unsigned_bound(max_long + 1)
+    Traceback (most recent call last):
+    OverflowError: value too large
+    """
+    cdef long i
+    last = None
+    for i in range(max_long - 1, n):
+        last = i + 1
+    return last
+
+
+@cython.overflowcheck(True)
+@cython.test_assert_path_exists(
+    '//AddNode[@overflow_check = True and NameNode[@name = "i"]]')
+def changed_through_pointer(long n):
+    """
+    The loop variable is changed through a pointer that was taken before the loop.
+
+    >>> changed_through_pointer(10)
+    Traceback (most recent call last):
+    OverflowError: value too large
+    """
+    cdef long i
+    cdef long *p = &i
+    last = None
+    for i in range(1, n):
+        p[0] = LONG_MAX
+        last = i + 1
+    return last
@@ -0,0 +1,14 @@
+# cython: overflowcheck.fold = False
+
+
+cdef extern from *:
+    """
+    #ifdef __SIZEOF_INT128__
+    typedef unsigned __int128 __pyx_test_uint128;
+    #else
+    typedef unsigned PY_LONG_LONG __pyx_test_uint128;
+    #endif
+    """
+    ctypedef unsigned long long INT "__pyx_test_uint128"
+
+include "overflow_check.pxi"
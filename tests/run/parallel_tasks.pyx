@@ -0,0 +1,140 @@
+# mode: run
+# tag: openmp
+
+# Tasks run on the threads of the enclosing parallel section and have to
+# give the same results as the sequential code without OpenMP.
+
+cimport cython.parallel
+from cython.parallel import parallel, prange, threadid, task, taskwait
+from libc.stdlib cimport malloc, free
+
+
+cdef long work(long k) nogil:
+    cdef long x = 0, j
+    for j in range(k):
+        x += j % 7
+    return x
+
+
+def test_task_in_prange(long n):
+    """
+    >>> test_task_in_prange(100) == sum(sum(j % 7 for j in range(i)) for i in range(100))
+    True
+    """
+    cdef long i, total = 0
+    cdef long *out = <long *> malloc(n * sizeof(long))
+    try:
+        for i in prange(n, nogil=True):
+            with task():
+                out[i] = work(i)
+        for i in range(n):
+            total += out[i]
+        return total
+    finally:
+        free(out)
+
+
+def test_captured_values(long n):
+    """
+    >>> test_captured_values(50)
+    [0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 58, 60, 62, 64, 66, 68, 70, 72, 74, 76, 78, 80, 82, 84, 86, 88, 90, 92, 94, 96, 98]
+    """
+    cdef long i, value
+    cdef long *out = <long *> malloc(n * sizeof(long))
+    try:
+        with nogil, parallel(num_threads=4):
+            if threadid() == 0:
+                for i in range(n):
+                    value = i * 2
+                    with task():
+                        # 'value' and 'i' are the values at task creation
+                        out[i] = value
+                    value = -1
+        return [out[i] for i in range(n)]
+    finally:
+        free(out)
+
+
+def test_task_privates(long n):
+    """
+    >>> test_task_privates(20)
+    [0, 1, 4, 9, 16, 25, 36, 49, 64, 81, 100, 121, 144, 169, 196, 225, 256, 289, 324, 361]
+    """
+    cdef long i, square
+    cdef long *out = <long *> malloc(n * sizeof(long))
+    try:
+        for i in prange(n, nogil=True, num_threads=3):
+            with task():
+                square = i * i
+                out[i] = square
+        return [out[i] for i in range(n)]
+    finally:
+        free(out)
+
+
+def test_taskwait():
+    """
+    >>> test_taskwait()
+    (1, 2, 3)
+    """
+    cdef long out[3]
+    with nogil, parallel(num_threads=2):
+        if threadid() == 0:
+            with task():
+                out[0] = 1
+            with task():
+                out[1] = 2
+            taskwait()
+            out[2] = out[0] + out[1]
+    return out[0], out[1], out[2]
+
+
+def test_nested_tasks(long n):
+    """
+    >>> test_nested_tasks(10)
+    [0, 1, 4, 9, 16, 25, 36, 49, 64, 81]
+    """
+    cdef long i
+    cdef long *out = <long *> malloc(n * sizeof(long))
+    try:
+        with nogil, parallel(num_threads=4):
+            if threadid() == 0:
+                with task():
+                    for i in range(n):
+                        with task():
+                            out[i] = i * i
+                    taskwait()
+        return [out[i] for i in range(n)]
+    finally:
+        free(out)
+
+
+def test_task_exception(long n):
+    """
+    >>> test_task_exception(100)
+    Traceback (most recent call last):
+    ValueError: 42
+    """
+    cdef long i
+    for i in prange(n, nogil=True, num_threads=4):
+        with task():
+            if i == 42:
+                with gil:
+                    raise ValueError(i)
+
+
+def test_nested_task_exception(long n):
+    """
+    >>> test_nested_task_exception(10)
+    Traceback (most recent call last):
+    KeyError: 7
+    """
+    cdef long i
+    with nogil, parallel():
+        if threadid() == 0:
+            with task():
+                for i in range(n):
+                    with task():
+                        with gil:
+                            if i == 7:
+                                raise KeyError(i)
@@ -0,0 +1,157 @@
+# mode: run
+# tag: openmp
+
+# Array reductions and reductions with combiner functions in prange().
+
+from cython.parallel import prange
+from cython.view cimport array as cvarray
+
+
+cdef struct MinLoc:
+    double value
+    Py_ssize_t index
+
+
+cdef inline MinLoc min_loc(MinLoc a, MinLoc b) nogil:
+    if b.value < a.value or (b.value == a.value and b.index < a.index):
+        return b
+    return a
+
+
+cdef double max_double(double a, double b) nogil:
+    return a if a > b else b
+
+
+def py_histogram(data, nbins):
+    result = [0] * nbins
+    for value in data:
+        result[value % nbins] += 1
+    return result
+
+
+def test_memoryview_histogram(int[:] data, int nbins):
+    """
+    >>> from array import array
+    >>> data = array('i', [(i * 7919) % 1013 for i in range(5000)])
+    >>> test_memoryview_histogram(data, 7) == py_histogram(data, 7)
+    True
+    """
+    cdef long[:] hist = cvarray((nbins,), sizeof(long), 'l')
+    cdef Py_ssize_t i
+    hist[:] = 0
+    for i in prange(data.shape[0], nogil=True, reduction='hist', num_threads=4):
+        hist[data[i] % nbins] += 1
+    return [hist[i] for i in range(nbins)]
+
+
+def test_memoryview_histogram_threads(int[:] data, int nbins):
+    """
+    >>> from array import array
+    >>> data = array('i', [(i * 7919) % 1013 for i in range(5000)])
+    >>> test_memoryview_histogram_threads(data, 7) == py_histogram(data, 7)
+    True
+    """
+    cdef long[:] hist = cvarray((nbins,), sizeof(long), 'l')
+    cdef Py_ssize_t i
+    hist[:] = 0
+    for i in prange(data.shape[0], nogil=True, reduction='hist', backend='threads', num_threads=4):
+        hist[data[i] % nbins] += 1
+    return [hist[i] for i in range(nbins)]
+
+
+def test_strided_memoryview(int n):
+    """
+    >>> expected = [[0] * 10 for _ in range(6)]
+    >>> for i in range(100):
+    ...     expected[(i % 3) * 2][(i % 4) * 3] -= 1
+    >>> test_strided_memoryview(100) == expected
+    True
+    """
+    cdef double[:, :] full = cvarray((6, 10), sizeof(double), 'd')
+    cdef double[:, :] view = full[::2, ::3]
+    cdef Py_ssize_t i
+    full[:, :] = 0
+    for i in prange(n, nogil=True, reduction='view'):
+        view[i % view.shape[0], i % view.shape[1]] -= 1
+    return [[int(full[i, j]) for j in range(10)] for i in range(6)]
+
+
+def test_c_arrays(int n):
+    """
+    >>> counts, products = test_c_arrays(100)
+    >>> counts == [[sum(1 for k in range(100) if k % 3 == i and k % 4 == j) for j in range(4)] for i in range(3)]
+    True
+    >>> products == [2.0 ** 25] * 4
+    True
+    """
+    cdef long counts[3][4]
+    cdef double products[4]
+    cdef Py_ssize_t i, j
+    for i in range(3):
+        for j in range(4):
+            counts[i][j] = 0
+    for j in range(4):
+        products[j] = 1
+    for i in prange(n, nogil=True, reduction=('counts', 'products'), num_threads=3):
+        counts[i % 3][i % 4] += 1
+        products[i % 4] *= 2
+    return [[counts[i][j] for j in range(4)] for i in range(3)], [products[j] for j in range(4)]
+
+
+def test_bitwise_array(int n):
+    """
+    >>> test_bitwise_array(64)
+    ([1431655765, 2863311530], [2863311530, 1431655765])
+    """
+    cdef unsigned int bits[2]
+    cdef unsigned int mask[2]
+    cdef int i
+    bits[0] = bits[1] = 0
+    mask[0] = mask[1] = 0xffffffffu
+    for i in prange(n, nogil=True, reduction=('bits', 'mask')):
+        bits[i % 2] |= 1u << (i % 32)
+        mask[i % 2] &= ~(1u << (i % 32))
+    return [bits[0], bits[1]], [mask[0], mask[1]]
+
+
+def test_combiner(double[:] values):
+    """
+    >>> values = [((i * 7919) % 1013) / 7.0 for i in range(2000)]
+    >>> from array import array
+    >>> index = min(range(len(values)), key=lambda i: (values[i], i))
+    >>> test_combiner(array('d', values)) == (index, values[index], max(values))
+    True
+    """
+    cdef MinLoc best, candidate
+    cdef double top = -1e300
+    cdef Py_ssize_t i
+    best.value = 1e300
+    best.index = -1
+    for i in prange(values.shape[0], nogil=True, reduction={'best': min_loc, 'top': max_double}):
+        candidate.value = values[i]
+        candidate.index = i
+        best = min_loc(best, candidate)
+        top = max_double(top, values[i])
+    return best.index, best.value, top
+
+
+def test_combiner_threads(double[:] values):
+    """
+    >>> values = [((i * 7919) % 1013) / 7.0 for i in range(2000)]
+    >>> from array import array
+    >>> index = min(range(len(values)), key=lambda i: (values[i], i))
+    >>> test_combiner_threads(array('d', values)) == (index, values[index], max(values))
+    True
+    """
+    cdef MinLoc best, candidate
+    cdef double top = -1e300
+    cdef Py_ssize_t i
+    best.value = 1e300
+    best.index = -1
+    for i in prange(values.shape[0], nogil=True, backend='threads',
+                    reduction={'best': min_loc, 'top': max_double}):
+        candidate.value = values[i]
+        candidate.index = i
+        best = min_loc(best, candidate)
+        top = max_double(top, values[i])
+    return best.index, best.value, top
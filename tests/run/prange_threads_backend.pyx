@@ -0,0 +1,215 @@
+# mode: run
+# tag: parallel
+
+# prange(..., backend='threads') runs on the work stealing scheduler in
+# Parallel.c and must give the same results as a sequential loop.
+
+cimport cython.parallel
+from cython.parallel import prange, threadid
+
+
+cdef double work(long k) nogil:
+    cdef double x = 0
+    cdef long j
+    for j in range(k):
+        x += j % 7
+    return x
+
+
+def test_prange_matches_range(int start, int stop, int step):
+    """
+    >>> def py_range(start, stop, step):
+    ...     r = list(range(start, stop, step))
+    ...     return len(r), r[-1] if r else None
+    >>> for start in range(-7, 7):
+    ...     for stop in range(-7, 7):
+    ...         for step in range(-3, 4):
+    ...             if step:
+    ...                 assert test_prange_matches_range(start, stop, step) == py_range(start, stop, step), (start, stop, step)
+    """
+    cdef int i = -765432, count = 0, last = -765432
+    for i in prange(start, stop, step, nogil=True, backend='threads', num_threads=3):
+        count += 1
+        last = i
+    return count, (last if count else None)
+
+
+def test_reductions(long n):
+    """
+    >>> test_reductions(10000) == (sum(range(10000)), -sum(range(10000)), 2 ** 20, 16383, 0)
+    True
+    >>> test_reductions(0)
+    (0, 0, 1, 0, 0)
+    """
+    cdef long i, plus = 0, minus = 0, prod = 1, bits = 0, odd = 0
+    for i in prange(n, nogil=True, backend='threads', num_threads=4):
+        plus += i
+        minus -= i
+        if i < 20:
+            prod *= 2
+        bits |= i
+        odd ^= i & 1
+    return plus, minus, prod, bits, odd
+
+
+def test_imbalanced(long n, int num_threads):
+    """
+    >>> expected = sum(sum(j % 7 for j in range(i * 10)) for i in range(300))
+    >>> test_imbalanced(300, 4) == (expected, 299, 300)
+    True
+    >>> test_imbalanced(300, 1) == (expected, 299, 300)
+    True
+    """
+    cdef long i, last = -1, count = 0
+    cdef double total = 0
+    for i in prange(n, nogil=True, backend='threads', num_threads=num_threads):
+        total += work(i * 10)
+        last = i
+        count += 1
+    return total, last, count
+
+
+def test_chunksize(long n, int chunksize):
+    """
+    >>> test_chunksize(1000, 7) == sum(range(1000))
+    True
+    >>> test_chunksize(1000, 5000) == sum(range(1000))
+    True
+    """
+    cdef long i, total = 0
+    for i in prange(n, nogil=True, backend='threads', chunksize=chunksize):
+        total += i
+    return total
+
+
+def test_threadid(long n):
+    """
+    >>> test_threadid(1000)
+    True
+    """
+    cdef long i
+    cdef int tid
+    cdef bint ok = True
+    for i in prange(n, nogil=True, backend='threads', num_threads=4):
+        tid = threadid()
+        if tid < 0 or tid >= 4:
+            ok = False
+    return ok
+
+
+def test_break(int n, int stop):
+    """
+    >>> test_break(100, 37)
+    37
+    >>> test_break(100, 200)
+    99
+    """
+    cdef int i
+    for i in prange(n, nogil=True, backend='threads', num_threads=2):
+        if i == stop:
+            break
+    return i
+
+
+def test_continue_else(int n):
+    """
+    >>> test_continue_else(100) == (sum(range(1, 100, 2)), 1)
+    True
+    """
+    cdef int i, total = 0, result = 0
+    for i in prange(n, nogil=True, backend='threads', num_threads=2):
+        if i % 2 == 0:
+            continue
+        total += i
+    else:
+        result = 1
+    return total, result
+
+
+cdef int parallel_return(int n) nogil:
+    cdef int i
+    for i in prange(n, backend='threads', num_threads=2):
+        if i == 10:
+            return i
+    else:
+        return 1
+
+    return 2
+
+
+def test_return():
+    """
+    >>> test_return()
+    10
+    """
+    cdef int result
+    with nogil:
+        result = parallel_return(100)
+    return result
+
+
+def test_exception(int n):
+    """
+    >>> test_exception(100)
+    Traceback (most recent call last):
+    ValueError: 7
+    """
+    cdef int i
+    for i in prange(n, nogil=True, backend='threads', num_threads=3):
+        with gil:
+            if i == 7:
+                raise ValueError(i)
+
+
+def test_closure_privates(long n):
+    """
+    >>> test_closure_privates(100)
+    (4950, 99)
+    """
+    cdef long i, total = 0
+
+    def inner():
+        return total, i
+
+    for i in prange(n, nogil=True, backend='threads'):
+        total += i
+    return inner()
+
+
+def test_nested_prange(int n):
+    """
+    >>> test_nested_prange(20) == sum(i * j for i in range(20) for j in range(20))
+    True
+    """
+    cdef int i, j
+    cdef long total = 0
+    for i in prange(n, nogil=True, backend='threads', num_threads=4):
+        for j in prange(n):
+            total += i * j
+    return total
+
+
+def test_buffer(double[:] values):
+    """
+    >>> from array import array
+    >>> test_buffer(array('d', range(1000))) == sum(range(1000)) * 2
+    True
+    """
+    cdef Py_ssize_t i
+    cdef double total = 0
+    for i in prange(values.shape[0], nogil=True, backend='threads'):
+        values[i] *= 2
+    for i in range(values.shape[0]):
+        total += values[i]
+    return total
+
+
+def test_explicit_openmp_backend(int n):
+    """
+    >>> test_explicit_openmp_backend(10)
+    45
+    """
+    cdef int i, total = 0
+    for i in prange(n, nogil=True, backend='openmp'):
+        total += i
+    return total
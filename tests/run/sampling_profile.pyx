@@ -0,0 +1,76 @@
+# tag: posix, profile
+# cython: profile = sampling
+
+from Cython import Sampling
+
+
+cdef double busy_nogil(long n) nogil:
+    cdef double x = 0
+    cdef long i
+    for i in range(n):
+        x += i * 0.5
+        x *= 0.999
+    return x
+
+
+cdef double busy_cdef(long n):
+    with nogil:
+        return busy_nogil(n)
+
+
+def busy(long n):
+    return busy_cdef(n)
+
+
+def raising():
+    raise ValueError()
+
+
+def run_until_sampled(func, long n):
+    cdef int i
+    for i in range(20):
+        func(n)
+        stacks = Sampling.stacks()
+        if any(stack for stack in stacks if stack != '[dropped]'):
+            return stacks
+        n *= 2
+    return stacks
+
+
+def test_sampling():
+    """
+    >>> stacks = test_sampling()
+    >>> inner = [stack for stack in stacks if 'busy_nogil' in stack]
+    >>> len(inner) > 0 or stacks
+    True
+    >>> all(stack.index('busy (') < stack.index('busy_cdef (') < stack.index('busy_nogil (') for stack in inner) or inner
+    True
+    >>> all(stack.startswith('test_sampling (') for stack in inner) or inner
+    True
+    >>> all(int(stack.rsplit(':', 1)[1][:-1]) in (10, 11, 12) for stack in inner) or inner
+    True
+    """
+    Sampling.stacks(clear=True)
+    Sampling.start(0.0005)
+    try:
+        return run_until_sampled(busy, 100000)
+    finally:
+        Sampling.stop()
+
+
+def test_exception_unlinks_frame():
+    """
+    >>> stacks = test_exception_unlinks_frame()
+    >>> [stack for stack in stacks if 'raising' in stack]
+    []
+    """
+    try:
+        raising()
+    except ValueError:
+        pass
+    Sampling.stacks(clear=True)
+    Sampling.start(0.0005)
+    try:
+        return run_until_sampled(busy, 100000)
+    finally:
+        Sampling.stop()
@@ -34,3 +34,26 @@ def test_traceback(cline_in_traceback=None):
       assert 'tracebacks.c' in tb_string
     else:
       assert 'tracebacks.c' not in tb_string
+
+
+def raise_in_lambda_on_same_line():
+  return (lambda: 1 // zero())()
+
+cdef int zero():
+  return 0
+
+def test_same_line_functions():
+  """
+  >>> test_same_line_functions()
+  """
+  try:
+    raise_in_lambda_on_same_line()
+  except ZeroDivisionError:
+    import sys
+    tb = sys.exc_info()[2].tb_next
+    names = []
+    while tb is not None:
+      names.append(tb.tb_frame.f_code.co_name)
+      tb = tb.tb_next
+    assert names[0].endswith('raise_in_lambda_on_same_line'), names
+    assert names[1].endswith('lambda'), names